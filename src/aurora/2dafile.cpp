@@ -27,11 +27,14 @@
  *  Handling BioWare's 2DAs (two-dimensional array).
  */
 
+#include <cstring>
+
 #include "common/util.h"
 #include "common/strutil.h"
 #include "common/stream.h"
 #include "common/file.h"
 #include "common/streamtokenizer.h"
+#include "common/memreader.h"
 
 #include "aurora/2dafile.h"
 #include "aurora/error.h"
@@ -42,70 +45,97 @@ static const uint32 kVersion2b = MKID_BE('V2.b');
 
 namespace Aurora {
 
-TwoDARow::TwoDARow(TwoDAFile &parent) : _parent(&parent) {
-}
+/** Hash a cell string by its raw bytes, without decoding it. */
+struct hashCell {
+	std::size_t operator()(const Common::UString &str) const {
+		const char *s = str.c_str();
+
+		return boost::hash_range(s, s + std::strlen(s));
+	}
+};
+
+/** Compare two cell strings by their raw bytes, without decoding them. */
+struct equalCell {
+	bool operator()(const Common::UString &str1, const Common::UString &str2) const {
+		return std::strcmp(str1.c_str(), str2.c_str()) == 0;
+	}
+};
+
+struct TwoDAFile::CellList {
+	typedef boost::unordered_map<Common::UString, uint32, hashCell, equalCell> StringIndex;
+
+	std::vector<Common::UString> *strings; ///< The string pool to fill.
+	StringIndex stringIndex;               ///< The index of each string in the pool.
+
+	std::vector<uint32> cells; ///< Each cell's string index, row after row.
+
+	CellList(std::vector<Common::UString> &s) : strings(&s) {
+	}
+
+	/** Add a cell, putting its string into the pool if it's not there yet. */
+	void add(const Common::UString &cell) {
+		std::pair<StringIndex::iterator, bool> string =
+			stringIndex.insert(std::make_pair(cell, (uint32) strings->size()));
+
+		if (string.second)
+			strings->push_back(cell);
+
+		cells.push_back(string.first->second);
+	}
+};
 
-TwoDARow::~TwoDARow() {
+TwoDARow::TwoDARow(const TwoDAFile &parent, uint32 row) : _parent(&parent), _row(row) {
 }
 
 const Common::UString &TwoDARow::getString(uint32 column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	const uint32 cell = _parent->getCell(_row, column);
+	if ((cell == kFieldIDInvalid) || _parent->_cellEmpty[cell])
 		return _parent->_defaultString;
 
-	return cell;
+	return _parent->_strings[_parent->_cellStrings[cell]];
 }
 
 const Common::UString &TwoDARow::getString(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultString;
-
-	return cell;
+	return getString(_parent->headerToColumn(column));
 }
 
 const int32 TwoDARow::getInt(uint32 column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	const uint32 cell = _parent->getCell(_row, column);
+	if ((cell == kFieldIDInvalid) || _parent->_cellEmpty[cell])
 		return _parent->_defaultInt;
 
-	return _parent->parseInt(cell);
+	return _parent->_cellInts[cell];
 }
 
 const int32 TwoDARow::getInt(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultInt;
-
-	return _parent->parseInt(cell);
+	return getInt(_parent->headerToColumn(column));
 }
 
 const float TwoDARow::getFloat(uint32 column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	const uint32 cell = _parent->getCell(_row, column);
+	if ((cell == kFieldIDInvalid) || _parent->_cellEmpty[cell])
 		return _parent->_defaultFloat;
 
-	return _parent->parseFloat(cell);
+	return _parent->_cellFloats[cell];
 }
 
 const float TwoDARow::getFloat(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultFloat;
-
-	return _parent->parseFloat(cell);
+	return getFloat(_parent->headerToColumn(column));
 }
 
-static const Common::UString kEmpty;
-const Common::UString &TwoDARow::getCell(uint32 n) const {
-	if (n >= _data.size())
-		return kEmpty;
+bool TwoDARow::empty(uint32 column) const {
+	const uint32 cell = _parent->getCell(_row, column);
 
-	return _data[n];
+	return (cell == kFieldIDInvalid) || _parent->_cellEmpty[cell];
+}
+
+bool TwoDARow::empty(const Common::UString &column) const {
+	return empty(_parent->headerToColumn(column));
 }
 
 
-TwoDAFile::TwoDAFile() : _defaultInt(0), _defaultFloat(0.0), _emptyRow(*this) {
+TwoDAFile::TwoDAFile() : _defaultInt(0), _defaultFloat(0.0), _rowCount(0),
+	_emptyRow(*this, kFieldIDInvalid) {
 }
 
 TwoDAFile::~TwoDAFile() {
@@ -116,12 +146,16 @@ void TwoDAFile::clear() {
 	AuroraBase::clear();
 
 	_headers.clear();
+	_headerMap.clear();
 
-	for (std::vector<TwoDARow *>::iterator row = _rows.begin(); row != _rows.end(); ++row)
-		delete *row;
+	_rowCount = 0;
 	_rows.clear();
 
-	_headerMap.clear();
+	_strings.clear();
+	_cellStrings.clear();
+	_cellInts.clear();
+	_cellFloats.clear();
+	_cellEmpty.clear();
 
 	_defaultString.clear();
 	_defaultInt   = 0;
@@ -144,14 +178,19 @@ void TwoDAFile::load(Common::SeekableReadStream &twoda) {
 
 	try {
 
+		CellList cells(_strings);
+
 		if      (_version == kVersion2a)
-			read2a(twoda);
+			read2a(twoda, cells);
 		else if (_version == kVersion2b)
-			read2b(twoda);
+			read2b(twoda, cells);
 
 		// Create the map to quickly translate headers to column indices
 		createHeaderMap();
 
+		// Sort the cells into columns and parse them
+		createColumns(cells);
+
 		if (twoda.err())
 			throw Common::Exception(Common::kReadError);
 
@@ -162,7 +201,7 @@ void TwoDAFile::load(Common::SeekableReadStream &twoda) {
 
 }
 
-void TwoDAFile::read2a(Common::SeekableReadStream &twoda) {
+void TwoDAFile::read2a(Common::SeekableReadStream &twoda, CellList &cells) {
 	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleIgnoreAll);
 
 	tokenize.addSeparator(' ');
@@ -173,13 +212,13 @@ void TwoDAFile::read2a(Common::SeekableReadStream &twoda) {
 
 	readDefault2a(twoda, tokenize);
 	readHeaders2a(twoda, tokenize);
-	readRows2a(twoda, tokenize);
+	readRows2a(twoda, tokenize, cells);
 }
 
-void TwoDAFile::read2b(Common::SeekableReadStream &twoda) {
+void TwoDAFile::read2b(Common::SeekableReadStream &twoda, CellList &cells) {
 	readHeaders2b(twoda);
 	skipRowNames2b(twoda);
-	readRows2b(twoda);
+	readRows2b(twoda, cells);
 }
 
 void TwoDAFile::readDefault2a(Common::SeekableReadStream &twoda,
@@ -206,26 +245,28 @@ void TwoDAFile::readHeaders2a(Common::SeekableReadStream &twoda,
 }
 
 void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
-                           Common::StreamTokenizer &tokenize) {
+                           Common::StreamTokenizer &tokenize,
+                           CellList &cells) {
 
 	uint32 columnCount = _headers.size();
 
+	std::vector<Common::UString> row;
 	while (!twoda.eos()) {
-		TwoDARow *row = new TwoDARow(*this);
-
 		tokenize.skipToken(twoda);
 
-		int count = tokenize.getTokens(twoda, row->_data, columnCount, columnCount);
+		int count = tokenize.getTokens(twoda, row, columnCount, columnCount);
 
 		tokenize.nextChunk(twoda);
 
-		if (count == 0) {
+		if (count == 0)
 			// Ignore empty lines
-			delete row;
 			continue;
-		}
 
-		_rows.push_back(row);
+		row.resize(columnCount);
+		for (uint32 i = 0; i < columnCount; i++)
+			cells.add(row[i]);
+
+		_rowCount++;
 	}
 }
 
@@ -244,67 +285,113 @@ void TwoDAFile::readHeaders2b(Common::SeekableReadStream &twoda) {
 }
 
 void TwoDAFile::skipRowNames2b(Common::SeekableReadStream &twoda) {
-	uint32 rowCount = twoda.readUint32LE();
-
-	_rows.reserve(rowCount);
-	for (uint32 i = 0; i < rowCount; i++)
-		_rows.push_back(0);
+	_rowCount = twoda.readUint32LE();
 
 	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleHeed);
 
 	tokenize.addSeparator('\t');
 	tokenize.addSeparator('\0');
 
-	tokenize.skipToken(twoda, rowCount);
+	tokenize.skipToken(twoda, _rowCount);
 }
 
-void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda) {
+void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda, CellList &cells) {
 	uint32 columnCount = _headers.size();
-	uint32 rowCount    = _rows.size();
-	uint32 cellCount   = columnCount * rowCount;
+	uint32 cellCount   = columnCount * _rowCount;
 
-	uint32 *offsets = new uint32[cellCount];
+	// Read the offsets and the cells directly out of memory
+	const uint32 tablePos = twoda.pos();
 
-	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleHeed);
+	Common::MemoryReader data(twoda);
+	data.seek(tablePos);
 
-	tokenize.addSeparator('\0');
+	std::vector<uint16> offsets;
+	offsets.resize(cellCount);
+	if (cellCount > 0)
+		data.readArrayUint16LE(&offsets[0], cellCount);
+
+	data.skip(2); // Reserved
+
+	uint32 dataOffset = data.pos();
 
-	for (uint32 i = 0; i < cellCount; i++)
-		offsets[i] = twoda.readUint16LE();
+	for (uint32 i = 0; i < cellCount; i++) {
+		data.seek(dataOffset + offsets[i]);
 
-	twoda.skip(2); // Reserved
+		Common::UString cell = data.readStringASCII();
+		if (cell.empty())
+			cell = "****";
 
-	uint32 dataOffset = twoda.pos();
+		cells.add(cell);
+	}
+}
 
-	for (uint32 i = 0; i < rowCount; i++) {
-		_rows[i] = new TwoDARow(*this);
+void TwoDAFile::createHeaderMap() {
+	for (uint32 i = 0; i < _headers.size(); i++)
+		_headerMap.insert(std::make_pair(_headers[i], i));
+}
 
-		_rows[i]->_data.resize(columnCount);
+void TwoDAFile::createColumns(const CellList &cells) {
+	const uint32 columnCount = _headers.size();
+	const uint32 cellCount   = columnCount * _rowCount;
 
-		for (uint32 j = 0; j < columnCount; j++) {
-			uint32 offset = dataOffset + offsets[i * columnCount + j];
+	if (cells.cells.size() != cellCount)
+		throw Common::Exception("Cell count mismatch (%d/%d)", (uint32) cells.cells.size(), cellCount);
 
-			if (!twoda.seek(offset)) {
-				delete[] offsets;
-				throw Common::Exception(Common::kSeekError);
-			}
+	_rows.reserve(_rowCount);
+	for (uint32 i = 0; i < _rowCount; i++)
+		_rows.push_back(TwoDARow(*this, i));
 
-			_rows[i]->_data[j] = tokenize.getToken(twoda);
-			if (_rows[i]->_data[j].empty())
-				_rows[i]->_data[j] = "****";
+	// Parse every distinct string only once
+	std::vector<int32> ints;
+	std::vector<float> floats;
+	std::vector<bool>  empty;
+
+	ints.reserve(_strings.size());
+	floats.reserve(_strings.size());
+	empty.reserve(_strings.size());
+
+	for (std::vector<Common::UString>::const_iterator s = _strings.begin(); s != _strings.end(); ++s) {
+		ints.push_back(parseInt(*s));
+		floats.push_back(parseFloat(*s));
+		empty.push_back(s->empty() || (*s == "****"));
+	}
+
+	// Sort the cells into columns, and fill in the pre-parsed values
+	_cellStrings.resize(cellCount);
+	_cellInts.resize(cellCount);
+	_cellFloats.resize(cellCount);
+	_cellEmpty.resize(cellCount);
+
+	for (uint32 i = 0; i < _rowCount; i++) {
+		for (uint32 j = 0; j < columnCount; j++) {
+			const uint32 cell   = j * _rowCount + i;
+			const uint32 string = cells.cells[i * columnCount + j];
+
+			_cellStrings[cell] = string;
+			_cellInts   [cell] = ints  [string];
+			_cellFloats [cell] = floats[string];
+			_cellEmpty  [cell] = empty [string];
 		}
 	}
+}
+
+uint32 TwoDAFile::getCell(uint32 row, uint32 column) const {
+	if ((row >= _rowCount) || (column >= _headers.size()))
+		return kFieldIDInvalid;
 
-	delete[] offsets;
+	return column * _rowCount + row;
 }
 
-void TwoDAFile::createHeaderMap() {
-	for (uint32 i = 0; i < _headers.size(); i++)
-		_headerMap.insert(std::make_pair(_headers[i], i));
+const Common::UString &TwoDAFile::getCellString(uint32 row, uint32 column) const {
+	const uint32 cell = getCell(row, column);
+	if (cell == kFieldIDInvalid)
+		return _defaultString;
+
+	return _strings[_cellStrings[cell]];
 }
 
 uint32 TwoDAFile::getRowCount() const {
-	return _rows.size();
+	return _rowCount;
 }
 
 uint32 TwoDAFile::getColumnCount() const {
@@ -325,11 +412,11 @@ uint32 TwoDAFile::headerToColumn(const Common::UString &header) const {
 }
 
 const TwoDARow &TwoDAFile::getRow(uint32 row) const {
-	if ((row >= _rows.size()) || !_rows[row])
+	if (row >= _rowCount)
 		// No such row
 		return _emptyRow;
 
-	return *_rows[row];
+	return _rows[row];
 }
 
 bool TwoDAFile::dumpASCII(const Common::UString &fileName) const {
@@ -347,15 +434,15 @@ bool TwoDAFile::dumpASCII(const Common::UString &fileName) const {
 	std::vector<uint32> colLength;
 	colLength.resize(_headers.size() + 1);
 
-	const Common::UString maxRow = Common::UString::sprintf("%d", _rows.size() - 1);
+	const Common::UString maxRow = Common::UString::sprintf("%d", _rowCount - 1);
 	colLength[0] = maxRow.size();
 
 	for (uint32 i = 0; i < _headers.size(); i++)
 		colLength[i + 1] = _headers[i].size();
 
-	for (uint32 i = 0; i < _rows.size(); i++)
-		for (uint32 j = 0; j < _rows[i]->_data.size(); j++)
-			colLength[j + 1] = MAX<uint32>(colLength[j + 1], _rows[i]->_data[j].size());
+	for (uint32 i = 0; i < _rowCount; i++)
+		for (uint32 j = 0; j < _headers.size(); j++)
+			colLength[j + 1] = MAX<uint32>(colLength[j + 1], getCellString(i, j).size());
 
 	// Write column headers
 
@@ -368,11 +455,11 @@ bool TwoDAFile::dumpASCII(const Common::UString &fileName) const {
 
 	// Write array
 
-	for (uint32 i = 0; i < _rows.size(); i++) {
+	for (uint32 i = 0; i < _rowCount; i++) {
 		file.writeString(Common::UString::sprintf("%*d", colLength[0], i));
 
-		for (uint32 j = 0; j < _rows[i]->_data.size(); j++)
-			file.writeString(Common::UString::sprintf(" %-*s", colLength[j + 1], _rows[i]->_data[j].c_str()));
+		for (uint32 j = 0; j < _headers.size(); j++)
+			file.writeString(Common::UString::sprintf(" %-*s", colLength[j + 1], getCellString(i, j).c_str()));
 
 		file.writeByte('\n');
 	}
@@ -31,7 +31,8 @@
 #define AURORA_2DAFILE_H
 
 #include <vector>
-#include <map>
+
+#include "boost/unordered/unordered_map.hpp"
 
 #include "common/types.h"
 #include "common/ustring.h"
@@ -48,6 +49,7 @@ namespace Aurora {
 
 class TwoDAFile;
 
+/** A row within a 2DA file. */
 class TwoDARow {
 public:
 	/** Return the contents of a cell as a string. */
@@ -65,15 +67,17 @@ public:
 	/** Return the contents of a cell as a float. */
 	const float getFloat(const Common::UString &column) const;
 
-private:
-	TwoDAFile *_parent; ///< The parent 2DA.
+	/** Is this cell empty ("****") or non-existent? */
+	bool empty(uint32 column) const;
+	/** Is this cell empty ("****") or non-existent? */
+	bool empty(const Common::UString &column) const;
 
-	std::vector<Common::UString> _data;
+private:
+	const TwoDAFile *_parent; ///< The parent 2DA.
 
-	TwoDARow(TwoDAFile &parent);
-	~TwoDARow();
+	uint32 _row; ///< The row's index.
 
-	const Common::UString &getCell(uint32 n) const;
+	TwoDARow(const TwoDAFile &parent, uint32 row);
 
 	friend class TwoDAFile;
 };
@@ -102,7 +106,11 @@ public:
 	/** Return the columns' headers. */
 	const std::vector<Common::UString> &getHeaders() const;
 
-	/** Translate a column header to a column index. */
+	/** Translate a column header to a column index.
+	 *
+	 *  Looking up a cell by its column index is faster than by its header,
+	 *  so the index is worth keeping when reading many rows.
+	 */
 	uint32 headerToColumn(const Common::UString &header) const;
 
 	/** Get a row. */
@@ -112,7 +120,8 @@ public:
 	bool dumpASCII(const Common::UString &fileName) const;
 
 private:
-	typedef std::map<Common::UString, uint32, Common::UString::iless> HeaderMap;
+	typedef boost::unordered_map<Common::UString, uint32,
+	        Common::hashUStringCaseInsensitive, Common::UString::iequal> HeaderMap;
 
 	Common::UString _defaultString; ///< The default string to return should a cell not exist.
 	int32           _defaultInt;    ///< The default int to return should a cell not exist.
@@ -121,24 +130,45 @@ private:
 	std::vector<Common::UString> _headers;
 	HeaderMap _headerMap;
 
+	uint32 _rowCount; ///< The number of rows.
+
+	/** All the distinct strings found in the cells. */
+	std::vector<Common::UString> _strings;
+
+	// The cells, stored column after column
+	std::vector<uint32> _cellStrings; ///< Index of each cell's string in _strings.
+	std::vector<int32>  _cellInts;    ///< Each cell, parsed as an int.
+	std::vector<float>  _cellFloats;  ///< Each cell, parsed as a float.
+	std::vector<bool>   _cellEmpty;   ///< Is the cell empty ("****")?
+
 	TwoDARow _emptyRow;
-	std::vector<TwoDARow *> _rows;
+	std::vector<TwoDARow> _rows;
+
+	/** The cells read while loading. */
+	struct CellList;
+
+	/** Return the index of a cell, or kFieldIDInvalid if it doesn't exist. */
+	uint32 getCell(uint32 row, uint32 column) const;
+	/** Return the verbatim contents of a cell. */
+	const Common::UString &getCellString(uint32 row, uint32 column) const;
 
 	// Loading helpers
-	void read2a(Common::SeekableReadStream &twoda);
-	void read2b(Common::SeekableReadStream &twoda);
+	void read2a(Common::SeekableReadStream &twoda, CellList &cells);
+	void read2b(Common::SeekableReadStream &twoda, CellList &cells);
 
 	// ASCII loading helpers
 	void readDefault2a(Common::SeekableReadStream &twoda, Common::StreamTokenizer &tokenize);
 	void readHeaders2a(Common::SeekableReadStream &twoda, Common::StreamTokenizer &tokenize);
-	void readRows2a   (Common::SeekableReadStream &twoda, Common::StreamTokenizer &tokenize);
+	void readRows2a   (Common::SeekableReadStream &twoda, Common::StreamTokenizer &tokenize,
+	                   CellList &cells);
 
 	// Binary loading helpers
 	void readHeaders2b (Common::SeekableReadStream &twoda);
 	void skipRowNames2b(Common::SeekableReadStream &twoda);
-	void readRows2b    (Common::SeekableReadStream &twoda);
+	void readRows2b    (Common::SeekableReadStream &twoda, CellList &cells);
 
 	void createHeaderMap();
+	void createColumns(const CellList &cells);
 
 	static int32 parseInt(const Common::UString &str);
 	static float parseFloat(const Common::UString &str);
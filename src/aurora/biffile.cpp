@@ -30,6 +30,7 @@
 #include "common/util.h"
 #include "common/error.h"
 #include "common/stream.h"
+#include "common/memreader.h"
 #include "common/file.h"
 
 #include "aurora/biffile.h"
@@ -87,21 +88,26 @@ void BIFFile::load() {
 		throw e;
 	}
 
+	// Map the whole BIF into memory, so that resources can be read without copying.
+	// If that fails, we'll just fall back to reading from the file directly.
+	_mappedFile.open(_fileName);
 }
 
 void BIFFile::readVarResTable(Common::SeekableReadStream &bif, uint32 offset) {
-	if (!bif.seek(offset))
-		throw Common::Exception(Common::kSeekError);
+	const uint32 entrySize = (_version == kVersion11) ? 20 : 16;
+
+	// Read the whole table at once
+	Common::MemoryReader table(bif, offset, _iResources.size() * entrySize);
 
 	for (IResourceList::iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
-		bif.skip(4); // ID
+		table.skip(4); // ID
 
 		if (_version == kVersion11)
-			bif.skip(4); // Flags
+			table.skip(4); // Flags
 
-		res->offset = bif.readUint32LE();
-		res->size   = bif.readUint32LE();
-		res->type   = (FileType) bif.readUint32LE();
+		res->offset = table.readUint32LE();
+		res->size   = table.readUint32LE();
+		res->type   = (FileType) table.readUint32LE();
 	}
 }
 
@@ -145,11 +151,19 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 BIFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *BIFFile::getResource(uint32 index) const {
 	const IResource &res = getIResource(index);
 	if (res.size == 0)
 		return new Common::MemoryReadStream(0, 0);
 
+	// Directly view the data if the BIF is mapped into memory
+	if (_mappedFile.isOpen())
+		return _mappedFile.createReadStream(res.offset, res.size);
+
 	Common::File bif;
 	open(bif);
 
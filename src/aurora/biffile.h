@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "common/types.h"
+#include "common/file.h"
 
 #include "aurora/types.h"
 #include "aurora/archive.h"
@@ -40,7 +41,6 @@
 
 namespace Common {
 	class SeekableReadStream;
-	class File;
 }
 
 namespace Aurora {
@@ -62,6 +62,9 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource within the BIF file. */
+	uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index) const;
 
@@ -88,6 +91,9 @@ private:
 	/** The name of the BIF file. */
 	Common::UString _fileName;
 
+	/** The BIF file mapped into memory, if possible. */
+	Common::MappedFile _mappedFile;
+
 	void open(Common::File &file) const;
 
 	void load();
@@ -0,0 +1,82 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file aurora/blueprintreg.cpp
+ *  The global blueprint registry.
+ */
+
+#include "common/error.h"
+
+#include "aurora/blueprintreg.h"
+#include "aurora/gfffile.h"
+#include "aurora/util.h"
+
+DECLARE_SINGLETON(Aurora::BlueprintRegistry)
+
+namespace Aurora {
+
+BlueprintRegistry::BlueprintRegistry() {
+}
+
+BlueprintRegistry::~BlueprintRegistry() {
+	clear();
+}
+
+void BlueprintRegistry::clear() {
+	Common::StackLock lock(_mutex);
+
+	for (BlueprintMap::iterator it = _blueprints.begin(); it != _blueprints.end(); ++it)
+		delete it->second;
+
+	_blueprints.clear();
+}
+
+const GFFStruct *BlueprintRegistry::get(const Common::UString &resRef, FileType type, uint32 id) {
+	if (resRef.empty())
+		return 0;
+
+	Common::UString name = setFileType(resRef, type);
+	name.tolower();
+
+	Common::StackLock lock(_mutex);
+
+	BlueprintMap::const_iterator blueprint = _blueprints.find(name);
+	if (blueprint == _blueprints.end())
+		// Entry doesn't exist => load and add. Missing blueprints are remembered as well.
+		blueprint = _blueprints.insert(std::make_pair(name, load(resRef, type, id))).first;
+
+	return blueprint->second ? &blueprint->second->getTopLevel() : 0;
+}
+
+GFFFile *BlueprintRegistry::load(const Common::UString &resRef, FileType type, uint32 id) {
+	try {
+		return new GFFFile(resRef, type, id);
+	} catch (...) {
+	}
+
+	return 0;
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,84 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file aurora/blueprintreg.h
+ *  The global blueprint registry.
+ */
+
+#ifndef AURORA_BLUEPRINTREG_H
+#define AURORA_BLUEPRINTREG_H
+
+#include <map>
+
+#include "common/types.h"
+#include "common/ustring.h"
+#include "common/singleton.h"
+#include "common/mutex.h"
+
+#include "aurora/types.h"
+
+namespace Aurora {
+
+class GFFFile;
+class GFFStruct;
+
+/** The global blueprint registry, holding all object templates (UTC, UTP, ...)
+ *  loaded so far.
+ *
+ *  Many object instances in an area share the same blueprint. The registry
+ *  parses each blueprint only once, and gives every instance the same,
+ *  immutable GFF. Since the blueprints come out of the current module and
+ *  its HAKs, the registry needs to be cleared whenever those change.
+ */
+class BlueprintRegistry : public Common::Singleton<BlueprintRegistry> {
+public:
+	BlueprintRegistry();
+	~BlueprintRegistry();
+
+	void clear();
+
+	/** Get the top-level struct of a blueprint, loading it if necessary.
+	 *
+	 *  Returns 0 if the blueprint doesn't exist or can't be loaded.
+	 *  The struct is only valid until the registry is cleared.
+	 */
+	const GFFStruct *get(const Common::UString &resRef, FileType type, uint32 id);
+
+private:
+	typedef std::map<Common::UString, GFFFile *> BlueprintMap;
+
+	BlueprintMap _blueprints;
+
+	Common::Mutex _mutex;
+
+	GFFFile *load(const Common::UString &resRef, FileType type, uint32 id);
+};
+
+} // End of namespace Aurora
+
+/** Shortcut for accessing the blueprint registry. */
+#define BlueprintReg ::Aurora::BlueprintRegistry::instance()
+
+#endif // AURORA_BLUEPRINTREG_H
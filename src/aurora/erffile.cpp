@@ -28,6 +28,7 @@
  */
 
 #include "common/stream.h"
+#include "common/memreader.h"
 #include "common/file.h"
 #include "common/util.h"
 
@@ -90,6 +91,9 @@ void ERFFile::load() {
 		throw e;
 	}
 
+	// Resource streams view the mapped ERF directly, if mapping it works
+	if (!_noResources)
+		_mappedFile.open(_fileName);
 }
 
 void ERFFile::readERFHeader(Common::SeekableReadStream &erf, ERFHeader &header) {
@@ -158,26 +162,26 @@ void ERFFile::readResources(Common::SeekableReadStream &erf, const ERFHeader &he
 }
 
 void ERFFile::readV1KeyList(Common::SeekableReadStream &erf, const ERFHeader &header) {
-	if (!erf.seek(header.offKeyList))
-		throw Common::Exception(Common::kSeekError);
+	// Read the whole list at once
+	Common::MemoryReader list(erf, header.offKeyList, _resources.size() * 24);
 
 	uint32 index = 0;
 	for (ResourceList::iterator res = _resources.begin(); res != _resources.end(); ++index, ++res) {
-		res->name.readFixedASCII(erf, 16);
-		erf.skip(4); // Resource ID
-		res->type = (FileType) erf.readUint16LE();
-		erf.skip(2); // Reserved
+		res->name = list.readFixedASCII(16);
+		list.skip(4); // Resource ID
+		res->type = (FileType) list.readUint16LE();
+		list.skip(2); // Reserved
 		res->index = index;
 	}
 }
 
 void ERFFile::readV1ResList(Common::SeekableReadStream &erf, const ERFHeader &header) {
-	if (!erf.seek(header.offResList))
-		throw Common::Exception(Common::kSeekError);
+	// Read the whole list at once
+	Common::MemoryReader list(erf, header.offResList, _iResources.size() * 8);
 
 	for (IResourceList::iterator res = _iResources.begin(); res != _iResources.end(); ++res) {
-		res->offset = erf.readUint32LE();
-		res->size   = erf.readUint32LE();
+		res->offset = list.readUint32LE();
+		res->size   = list.readUint32LE();
 	}
 }
 
@@ -222,11 +226,19 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 ERFFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index) const {
 	const IResource &res = getIResource(index);
 	if (res.size == 0)
 		return new Common::MemoryReadStream(0, 0);
 
+	// Mapped ERFs hand out views into the mapping
+	if (_mappedFile.isOpen())
+		return _mappedFile.createReadStream(res.offset, res.size);
+
 	Common::File erf;
 	open(erf);
 
@@ -27,9 +27,13 @@
  *  Handling BioWare's GFFs (generic file format).
  */
 
+#include <cstring>
+#include <algorithm>
+
 #include "common/endianness.h"
 #include "common/error.h"
 #include "common/stream.h"
+#include "common/memreader.h"
 #include "common/ustring.h"
 
 #include "aurora/gfffile.h"
@@ -62,7 +66,7 @@ void GFFFile::Header::clear() {
 	listIndicesCount   = 0;
 }
 
-void GFFFile::Header::read(Common::SeekableReadStream &gff) {
+void GFFFile::Header::read(Common::MemoryReader &gff) {
 	structOffset       = gff.readUint32LE();
 	structCount        = gff.readUint32LE();
 	fieldOffset        = gff.readUint32LE();
@@ -105,15 +109,28 @@ void GFFFile::load(uint32 id) {
 	if ((_version != kVersion32) && (_version != kVersion33))
 		throw Common::Exception("Unsupported GFF file version %08X", _version);
 
-	_header.read(*_stream);
-
 	try {
 
-		readStructs();
-		readLists();
+		// Look at the whole GFF in memory from now on
+		const uint32 headerPos = _stream->pos();
+
+		_data = Common::MemoryReader(*_stream);
+
+		// If the data was copied, we don't need the stream anymore
+		if (_data.ownsData()) {
+			delete _stream;
+			_stream = 0;
+		}
+
+		_data.seek(headerPos);
+
+		_header.read(_data);
 
-		if (_stream->err())
-			throw Common::Exception(Common::kReadError);
+		std::vector<uint32> labelIDs;
+
+		readLabels(labelIDs);
+		readStructs(labelIDs);
+		readLists();
 
 	} catch (Common::Exception &e) {
 		e.add("Failed reading GFF file");
@@ -126,6 +143,27 @@ const GFFStruct &GFFFile::getTopLevel() const {
 	return getStruct(0);
 }
 
+/** Order labels by their raw bytes.
+ *
+ *  For UTF-8, this is the same as ordering by code points, but it doesn't
+ *  need to decode the strings.
+ */
+static bool labelLess(const Common::UString &a, const Common::UString &b) {
+	return std::strcmp(a.c_str(), b.c_str()) < 0;
+}
+
+static bool labelEqual(const Common::UString &a, const Common::UString &b) {
+	return std::strcmp(a.c_str(), b.c_str()) == 0;
+}
+
+uint32 GFFFile::getLabelID(const Common::UString &label) const {
+	LabelArray::const_iterator l = std::lower_bound(_labels.begin(), _labels.end(), label, labelLess);
+	if ((l == _labels.end()) || !labelEqual(*l, label))
+		return kGFFLabelNone;
+
+	return l - _labels.begin();
+}
+
 const GFFStruct &GFFFile::getStruct(uint32 i) const {
 	assert(i < _structs.size());
 
@@ -144,21 +182,108 @@ const GFFList &GFFFile::getList(uint32 i, uint32 &size) const {
 	return _lists[i];
 }
 
-void GFFFile::readStructs() {
+void GFFFile::readLabels(std::vector<uint32> &labelIDs) {
+	_data.seek(_header.labelOffset);
+
+	LabelArray rawLabels;
+	rawLabels.reserve(_header.labelCount);
+	for (uint32 i = 0; i < _header.labelCount; i++)
+		rawLabels.push_back(_data.readFixedASCII(16));
+
+	// Intern the labels: sorted and unique, so that the label IDs follow the label order
+	_labels = rawLabels;
+	std::sort(_labels.begin(), _labels.end(), labelLess);
+	_labels.erase(std::unique(_labels.begin(), _labels.end(), labelEqual), _labels.end());
+
+	// Map each label table index to its interned ID
+	labelIDs.resize(rawLabels.size());
+	for (uint32 i = 0; i < rawLabels.size(); i++)
+		labelIDs[i] = getLabelID(rawLabels[i]);
+}
+
+void GFFFile::readStructs(const std::vector<uint32> &labelIDs) {
+	// Sanity check
+	if (_header.fieldCount > (_data.size() / 12))
+		throw Common::Exception("Field count out of range (%d)", _header.fieldCount);
+
+	// Read the whole field table
+	std::vector<uint32> rawFields;
+	rawFields.resize(_header.fieldCount * 3);
+	if (!rawFields.empty()) {
+		_data.seek(_header.fieldOffset);
+		_data.readArrayUint32LE(&rawFields[0], rawFields.size());
+	}
+
 	_structs.reserve(_header.structCount);
-	for (uint32 i = 0; i < _header.structCount; i++)
-		_structs.push_back(new GFFStruct(*this, *_stream));
+
+	Common::MemoryReader gff(_data);
+	gff.seek(_header.structOffset);
+
+	std::vector<uint32> indices;
+	for (uint32 i = 0; i < _header.structCount; i++) {
+		uint32 id         = gff.readUint32LE();
+		uint32 fieldIndex = gff.readUint32LE();
+		uint32 fieldCount = gff.readUint32LE();
+
+		indices.resize(fieldCount);
+		if      (fieldCount == 1) {
+			// With only one field, the index points directly into the field table
+			indices[0] = fieldIndex;
+		} else if (fieldCount > 1) {
+			// Sanity checks
+			if (fieldIndex > _header.fieldIndicesCount)
+				throw Common::Exception("Field indices index out of range (%d/%d)",
+				                        fieldIndex , _header.fieldIndicesCount);
+			if (fieldCount > (_header.fieldIndicesCount / 4))
+				throw Common::Exception("Field indices count out of range (%d/%d)",
+				                        fieldCount, _header.fieldIndicesCount / 4);
+
+			_data.seek(_header.fieldIndicesOffset + fieldIndex);
+			_data.readArrayUint32LE(&indices[0], fieldCount);
+		}
+
+		_structs.push_back(new GFFStruct(*this, id));
+
+		GFFStruct::FieldArray &fields = _structs.back()->_fields;
+		fields.reserve(fieldCount);
+
+		for (std::vector<uint32>::const_iterator f = indices.begin(); f != indices.end(); ++f) {
+			// Sanity checks
+			if (*f >= _header.fieldCount)
+				throw Common::Exception("Field index out of range (%d/%d)", *f, _header.fieldCount);
+
+			const uint32 *field = &rawFields[*f * 3];
+			if (field[1] >= labelIDs.size())
+				throw Common::Exception("Label index out of range (%d/%d)",
+				                        field[1], (uint32) labelIDs.size());
+
+			fields.push_back(GFFStruct::Field(labelIDs[field[1]],
+			                                  (GFFStruct::FieldType) field[0], field[2]));
+		}
+
+		// Sort by label and drop duplicate labels, keeping the last one
+		std::stable_sort(fields.begin(), fields.end());
+
+		uint32 n = 0;
+		for (uint32 j = 0; j < fields.size(); j++) {
+			if (((j + 1) < fields.size()) && (fields[j + 1].label == fields[j].label))
+				continue;
+
+			fields[n++] = fields[j];
+		}
+
+		fields.resize(n, GFFStruct::Field());
+	}
 }
 
 void GFFFile::readLists() {
-	if (!_stream->seek(_header.listIndicesOffset))
-		throw Common::Exception(Common::kSeekError);
+	_data.seek(_header.listIndicesOffset);
 
 	// Read list array
 	std::vector<uint32> rawLists;
 	rawLists.resize(_header.listIndicesCount / 4);
-	for (std::vector<uint32>::iterator it = rawLists.begin(); it != rawLists.end(); ++it)
-		*it = _stream->readUint32LE();
+	if (!rawLists.empty())
+		_data.readArrayUint32LE(&rawLists[0], rawLists.size());
 
 	// Counting the actual amount of lists
 	uint32 listCount = 0;
@@ -194,21 +319,15 @@ void GFFFile::readLists() {
 
 }
 
-Common::SeekableReadStream &GFFFile::getStream() const {
-	return *_stream;
-}
-
-Common::SeekableReadStream &GFFFile::getFieldData() const {
-	_stream->seek(_header.fieldDataOffset);
-
-	return *_stream;
+const Common::MemoryReader &GFFFile::getData() const {
+	return _data;
 }
 
 
-GFFStruct::Field::Field() : type(kFieldTypeNone), data(0), extended(false) {
+GFFStruct::Field::Field() : label(kGFFLabelNone), type(kFieldTypeNone), data(0), extended(false) {
 }
 
-GFFStruct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
+GFFStruct::Field::Field(uint32 l, FieldType t, uint32 d) : label(l), type(t), data(d) {
 	// These field types need extended field data
 	extended = (type == kFieldTypeUint64     ) ||
 	           (type == kFieldTypeSint64     ) ||
@@ -221,367 +340,407 @@ GFFStruct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
 	           (type == kFieldTypeVector     );
 }
 
+bool GFFStruct::Field::operator<(const Field &field) const {
+	return label < field.label;
+}
 
-GFFStruct::GFFStruct(const GFFFile &parent, Common::SeekableReadStream &gff) :
-	_parent(&parent) {
 
-	_id         = gff.readUint32LE();
-	_fieldIndex = gff.readUint32LE();
-	_fieldCount = gff.readUint32LE();
+GFFStruct::GFFStruct(const GFFFile &parent, uint32 id) : _parent(&parent), _id(id) {
 }
 
 GFFStruct::~GFFStruct() {
 }
 
-void GFFStruct::load() const {
-	if (!_fields.empty())
-		return;
+Common::MemoryReader GFFStruct::getData(const Field &field) const {
+	assert(field.extended);
+
+	// A plain view of the parent's data, to not touch the data's shared reference count
+	const Common::MemoryReader &gff = _parent->getData();
+	Common::MemoryReader data(gff.getData(), gff.size());
 
-	Common::SeekableReadStream &gff = _parent->getStream();
+	data.seek(_parent->_header.fieldDataOffset + field.data);
 
-	// Read the field(s)
-	if      (_fieldCount == 1)
-		readField (gff, _fieldIndex);
-	else if (_fieldCount > 1)
-		readFields(gff, _fieldIndex, _fieldCount);
+	return data;
 }
 
-void GFFStruct::readField(Common::SeekableReadStream &gff, uint32 index) const {
-	// Sanity check
-	if (index > _parent->_header.fieldCount)
-		throw Common::Exception("Field index out of range (%d/%d)",
-				index, _parent->_header.fieldCount);
+const GFFStruct::Field *GFFStruct::getField(const Common::UString &name) const {
+	return getField(_parent->getLabelID(name));
+}
 
-	// Seek
-	if (!gff.seek(_parent->_header.fieldOffset + index * 12))
-		throw Common::Exception(Common::kSeekError);
+const GFFStruct::Field *GFFStruct::getField(uint32 label) const {
+	if (label == kGFFLabelNone)
+		return 0;
 
-	// Read the field data
-	uint32 type  = gff.readUint32LE();
-	uint32 label = gff.readUint32LE();
-	uint32 data  = gff.readUint32LE();
+	FieldArray::const_iterator field =
+		std::lower_bound(_fields.begin(), _fields.end(), Field(label, kFieldTypeNone, 0));
+	if ((field == _fields.end()) || (field->label != label))
+		return 0;
 
-	// And add it to the map
-	_fields[readLabel(gff, label)] = Field((FieldType) type, data);
+	return &*field;
 }
 
-void GFFStruct::readFields(Common::SeekableReadStream &gff,
-                           uint32 index, uint32 count) const {
-	// Sanity check
-	if (index > _parent->_header.fieldIndicesCount)
-		throw Common::Exception("Field indices index out of range (%d/%d)",
-		                        index , _parent->_header.fieldIndicesCount);
-
-	// Seek
-	if (!gff.seek(_parent->_header.fieldIndicesOffset + index))
-		throw Common::Exception(Common::kSeekError);
+uint GFFStruct::getFieldCount() const {
+	return _fields.size();
+}
 
-	// Read the field indices
-	std::vector<uint32> indices;
-	readIndices(gff, indices, count);
+uint32 GFFStruct::getLabelID(const Common::UString &label) const {
+	return _parent->getLabelID(label);
+}
 
-	// Read the fields
-	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
-		readField(gff, *i);
+bool GFFStruct::hasField(const Common::UString &field) const {
+	return getField(field) != 0;
 }
 
-void GFFStruct::readIndices(Common::SeekableReadStream &gff,
-                            std::vector<uint32> &indices, uint32 count) const {
-	indices.reserve(count);
-	while (count-- > 0)
-		indices.push_back(gff.readUint32LE());
+bool GFFStruct::hasField(uint32 label) const {
+	return getField(label) != 0;
 }
 
-Common::UString GFFStruct::readLabel(Common::SeekableReadStream &gff, uint32 index) const {
-	gff.seek(_parent->_header.labelOffset + index * 16);
+char GFFStruct::getChar(const Common::UString &field, char def) const {
+	const Field *f = getField(field);
+
+	return f ? readChar(*f) : def;
+}
 
-	Common::UString label;
-	label.readFixedASCII(gff, 16);
+char GFFStruct::getChar(uint32 label, char def) const {
+	const Field *f = getField(label);
 
-	return label;
+	return f ? readChar(*f) : def;
 }
 
-Common::SeekableReadStream &GFFStruct::getData(const Field &field) const {
-	assert(field.extended);
+uint64 GFFStruct::getUint(const Common::UString &field, uint64 def) const {
+	const Field *f = getField(field);
 
-	Common::SeekableReadStream &data = _parent->getFieldData();
+	return f ? readUint(*f) : def;
+}
 
-	data.seek(field.data, SEEK_CUR);
+uint64 GFFStruct::getUint(uint32 label, uint64 def) const {
+	const Field *f = getField(label);
 
-	return data;
+	return f ? readUint(*f) : def;
 }
 
-const GFFStruct::Field *GFFStruct::getField(const Common::UString &name) const {
-	FieldMap::const_iterator field = _fields.find(name);
-	if (field == _fields.end())
-		return 0;
+int64 GFFStruct::getSint(const Common::UString &field, int64 def) const {
+	const Field *f = getField(field);
 
-	return &field->second;
+	return f ? readSint(*f) : def;
 }
 
-uint GFFStruct::getFieldCount() const {
-	return _fields.size();
+int64 GFFStruct::getSint(uint32 label, int64 def) const {
+	const Field *f = getField(label);
+
+	return f ? readSint(*f) : def;
 }
 
-bool GFFStruct::hasField(const Common::UString &field) const {
-	load();
+bool GFFStruct::getBool(const Common::UString &field, bool def) const {
+	const Field *f = getField(field);
 
-	return getField(field) != 0;
+	return f ? (readUint(*f) != 0) : def;
 }
 
-char GFFStruct::getChar(const Common::UString &field, char def) const {
-	load();
+bool GFFStruct::getBool(uint32 label, bool def) const {
+	const Field *f = getField(label);
+
+	return f ? (readUint(*f) != 0) : def;
+}
 
+double GFFStruct::getDouble(const Common::UString &field, double def) const {
 	const Field *f = getField(field);
-	if (!f)
-		return def;
-	if (f->type != kFieldTypeChar)
-		throw Common::Exception("Field is not a char type");
 
-	return (char) f->data;
+	return f ? readDouble(*f) : def;
 }
 
-uint64 GFFStruct::getUint(const Common::UString &field, uint64 def) const {
-	load();
+double GFFStruct::getDouble(uint32 label, double def) const {
+	const Field *f = getField(label);
 
-	const Field *f = getField(field);
-	if (!f)
-		return def;
+	return f ? readDouble(*f) : def;
+}
 
-	// Int types
-	if (f->type == kFieldTypeByte)
-		return (uint64) ((uint8 ) f->data);
-	if (f->type == kFieldTypeUint16)
-		return (uint64) ((uint16) f->data);
-	if (f->type == kFieldTypeUint32)
-		return (uint64) ((uint32) f->data);
-	if (f->type == kFieldTypeChar)
-		return (uint64) ((int64) ((int8 ) ((uint8 ) f->data)));
-	if (f->type == kFieldTypeSint16)
-		return (uint64) ((int64) ((int16) ((uint16) f->data)));
-	if (f->type == kFieldTypeSint32)
-		return (uint64) ((int64) ((int32) ((uint32) f->data)));
-	if (f->type == kFieldTypeUint64)
-		return (uint64) getData(*f).readUint64LE();
-	if (f->type == kFieldTypeSint64)
-		return ( int64) getData(*f).readUint64LE();
+Common::UString GFFStruct::getString(const Common::UString &field,
+                                     const Common::UString &def) const {
+	const Field *f = getField(field);
 
-	throw Common::Exception("Field is not an int type");
+	return f ? readString(*f) : def;
 }
 
-int64 GFFStruct::getSint(const Common::UString &field, int64 def) const {
-	load();
+Common::UString GFFStruct::getString(uint32 label, const Common::UString &def) const {
+	const Field *f = getField(label);
+
+	return f ? readString(*f) : def;
+}
 
+void GFFStruct::getLocString(const Common::UString &field, LocString &str) const {
 	const Field *f = getField(field);
-	if (!f)
-		return def;
+	if (f)
+		readLocString(*f, str);
+}
 
-	// Int types
-	if (f->type == kFieldTypeByte)
-		return (int64) ((int8 ) ((uint8 ) f->data));
-	if (f->type == kFieldTypeUint16)
-		return (int64) ((int16) ((uint16) f->data));
-	if (f->type == kFieldTypeUint32)
-		return (int64) ((int32) ((uint32) f->data));
-	if (f->type == kFieldTypeChar)
-		return (int64) ((int8 ) ((uint8 ) f->data));
-	if (f->type == kFieldTypeSint16)
-		return (int64) ((int16) ((uint16) f->data));
-	if (f->type == kFieldTypeSint32)
-		return (int64) ((int32) ((uint32) f->data));
-	if (f->type == kFieldTypeUint64)
-		return (int64) getData(*f).readUint64LE();
-	if (f->type == kFieldTypeSint64)
-		return (int64) getData(*f).readUint64LE();
+void GFFStruct::getLocString(uint32 label, LocString &str) const {
+	const Field *f = getField(label);
+	if (f)
+		readLocString(*f, str);
+}
 
-	throw Common::Exception("Field is not an int type");
+Common::SeekableReadStream *GFFStruct::getData(const Common::UString &field) const {
+	const Field *f = getField(field);
+
+	return f ? readData(*f) : 0;
 }
 
-bool GFFStruct::getBool(const Common::UString &field, bool def) const {
-	load();
+Common::SeekableReadStream *GFFStruct::getData(uint32 label) const {
+	const Field *f = getField(label);
 
-	return getUint(field, def) != 0;
+	return f ? readData(*f) : 0;
 }
 
-double GFFStruct::getDouble(const Common::UString &field, double def) const {
-	load();
+void GFFStruct::getVector(const Common::UString &field,
+                          float &x, float &y, float &z) const {
+	const Field *f = getField(field);
+	if (f)
+		readVector(*f, x, y, z);
+}
 
+void GFFStruct::getVector(uint32 label, float &x, float &y, float &z) const {
+	const Field *f = getField(label);
+	if (f)
+		readVector(*f, x, y, z);
+}
+
+void GFFStruct::getOrientation(const Common::UString &field,
+                               float &a, float &b, float &c, float &d) const {
 	const Field *f = getField(field);
+	if (f)
+		readOrientation(*f, a, b, c, d);
+}
+
+void GFFStruct::getOrientation(uint32 label, float &a, float &b, float &c, float &d) const {
+	const Field *f = getField(label);
+	if (f)
+		readOrientation(*f, a, b, c, d);
+}
+
+void GFFStruct::getVector(const Common::UString &field,
+                          double &x, double &y, double &z) const {
+	getVector(getLabelID(field), x, y, z);
+}
+
+void GFFStruct::getVector(uint32 label, double &x, double &y, double &z) const {
+	const Field *f = getField(label);
 	if (!f)
-		return def;
+		return;
 
-	if (f->type == kFieldTypeFloat)
-		return convertIEEEFloat(f->data);
-	if (f->type == kFieldTypeDouble)
-		return getData(*f).readIEEEDoubleLE();
+	float fX, fY, fZ;
+	readVector(*f, fX, fY, fZ);
 
-	throw Common::Exception("Field is not a double type");
+	x = fX;
+	y = fY;
+	z = fZ;
 }
 
-Common::UString GFFStruct::getString(const Common::UString &field,
-                                        const Common::UString &def) const {
-	load();
+void GFFStruct::getOrientation(const Common::UString &field,
+                               double &a, double &b, double &c, double &d) const {
+	getOrientation(getLabelID(field), a, b, c, d);
+}
 
-	const Field *f = getField(field);
+void GFFStruct::getOrientation(uint32 label, double &a, double &b, double &c, double &d) const {
+	const Field *f = getField(label);
 	if (!f)
-		return def;
+		return;
+
+	float fA, fB, fC, fD;
+	readOrientation(*f, fA, fB, fC, fD);
+
+	a = fA;
+	b = fB;
+	c = fC;
+	d = fD;
+}
+
+const GFFStruct &GFFStruct::getStruct(const Common::UString &field) const {
+	return readStruct(getField(field));
+}
+
+const GFFStruct &GFFStruct::getStruct(uint32 label) const {
+	return readStruct(getField(label));
+}
+
+const GFFList &GFFStruct::getList(const Common::UString &field, uint32 &size) const {
+	return readList(getField(field), size);
+}
+
+const GFFList &GFFStruct::getList(uint32 label, uint32 &size) const {
+	return readList(getField(label), size);
+}
+
+const GFFList &GFFStruct::getList(const Common::UString &field) const {
+	uint32 size;
+
+	return readList(getField(field), size);
+}
+
+const GFFList &GFFStruct::getList(uint32 label) const {
+	uint32 size;
+
+	return readList(getField(label), size);
+}
+
+char GFFStruct::readChar(const Field &field) const {
+	if (field.type != kFieldTypeChar)
+		throw Common::Exception("Field is not a char type");
+
+	return (char) field.data;
+}
+
+uint64 GFFStruct::readUint(const Field &field) const {
+	// Int types
+	if (field.type == kFieldTypeByte)
+		return (uint64) ((uint8 ) field.data);
+	if (field.type == kFieldTypeUint16)
+		return (uint64) ((uint16) field.data);
+	if (field.type == kFieldTypeUint32)
+		return (uint64) ((uint32) field.data);
+	if (field.type == kFieldTypeChar)
+		return (uint64) ((int64) ((int8 ) ((uint8 ) field.data)));
+	if (field.type == kFieldTypeSint16)
+		return (uint64) ((int64) ((int16) ((uint16) field.data)));
+	if (field.type == kFieldTypeSint32)
+		return (uint64) ((int64) ((int32) ((uint32) field.data)));
+	if (field.type == kFieldTypeUint64)
+		return (uint64) getData(field).readUint64LE();
+	if (field.type == kFieldTypeSint64)
+		return ( int64) getData(field).readUint64LE();
+
+	throw Common::Exception("Field is not an int type");
+}
+
+int64 GFFStruct::readSint(const Field &field) const {
+	// Int types
+	if (field.type == kFieldTypeByte)
+		return (int64) ((int8 ) ((uint8 ) field.data));
+	if (field.type == kFieldTypeUint16)
+		return (int64) ((int16) ((uint16) field.data));
+	if (field.type == kFieldTypeUint32)
+		return (int64) ((int32) ((uint32) field.data));
+	if (field.type == kFieldTypeChar)
+		return (int64) ((int8 ) ((uint8 ) field.data));
+	if (field.type == kFieldTypeSint16)
+		return (int64) ((int16) ((uint16) field.data));
+	if (field.type == kFieldTypeSint32)
+		return (int64) ((int32) ((uint32) field.data));
+	if (field.type == kFieldTypeUint64)
+		return (int64) getData(field).readUint64LE();
+	if (field.type == kFieldTypeSint64)
+		return (int64) getData(field).readUint64LE();
 
-	if (f->type == kFieldTypeExoString) {
-		Common::SeekableReadStream &data = getData(*f);
+	throw Common::Exception("Field is not an int type");
+}
+
+double GFFStruct::readDouble(const Field &field) const {
+	if (field.type == kFieldTypeFloat)
+		return convertIEEEFloat(field.data);
+	if (field.type == kFieldTypeDouble)
+		return getData(field).readIEEEDoubleLE();
+
+	throw Common::Exception("Field is not a double type");
+}
+
+Common::UString GFFStruct::readString(const Field &field) const {
+	if (field.type == kFieldTypeExoString) {
+		Common::MemoryReader data = getData(field);
 
 		uint32 length = data.readUint32LE();
 
-		Common::UString str;
-		str.readFixedASCII(data, length);
-		return str;
+		return data.readFixedASCII(length);
 	}
 
-	if (f->type == kFieldTypeResRef) {
-		Common::SeekableReadStream &data = getData(*f);
+	if (field.type == kFieldTypeResRef) {
+		Common::MemoryReader data = getData(field);
 
 		uint32 length = data.readByte();
 
-		Common::UString str;
-		str.readFixedASCII(data, length);
-		return str;
+		return data.readFixedASCII(length);
 	}
 
-	if ((f->type == kFieldTypeByte  ) ||
-	    (f->type == kFieldTypeUint16) ||
-	    (f->type == kFieldTypeUint32) ||
-	    (f->type == kFieldTypeUint64)) {
+	if ((field.type == kFieldTypeByte  ) ||
+	    (field.type == kFieldTypeUint16) ||
+	    (field.type == kFieldTypeUint32) ||
+	    (field.type == kFieldTypeUint64)) {
 
-		return Common::UString::sprintf("%lu", getUint(field));
+		return Common::UString::sprintf("%lu", readUint(field));
 	}
 
-	if ((f->type == kFieldTypeChar  ) ||
-	    (f->type == kFieldTypeSint16) ||
-	    (f->type == kFieldTypeSint32) ||
-	    (f->type == kFieldTypeSint64)) {
+	if ((field.type == kFieldTypeChar  ) ||
+	    (field.type == kFieldTypeSint16) ||
+	    (field.type == kFieldTypeSint32) ||
+	    (field.type == kFieldTypeSint64)) {
 
-		return Common::UString::sprintf("%ld", getSint(field));
+		return Common::UString::sprintf("%ld", readSint(field));
 	}
 
-	if ((f->type == kFieldTypeFloat) ||
-	    (f->type == kFieldTypeDouble)) {
+	if ((field.type == kFieldTypeFloat) ||
+	    (field.type == kFieldTypeDouble)) {
 
-		return Common::UString::sprintf("%lf", getDouble(field));
+		return Common::UString::sprintf("%lf", readDouble(field));
 	}
 
-	if (f->type == kFieldTypeVector) {
+	if (field.type == kFieldTypeVector) {
 		float x, y, z;
 
-		getVector(field, x, y, z);
+		readVector(field, x, y, z);
 		return Common::UString::sprintf("%f/%f/%f", x, y, z);
 	}
 
-	if (f->type == kFieldTypeOrientation) {
+	if (field.type == kFieldTypeOrientation) {
 		float a, b, c, d;
 
-		getOrientation(field, a, b, c, d);
+		readOrientation(field, a, b, c, d);
 		return Common::UString::sprintf("%f/%f/%f/%f", a, b, c, d);
 	}
 
 	throw Common::Exception("Field is not a string(able) type");
 }
 
-void GFFStruct::getLocString(const Common::UString &field, LocString &str) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return;
-	if (f->type != kFieldTypeLocString)
+void GFFStruct::readLocString(const Field &field, LocString &str) const {
+	if (field.type != kFieldTypeLocString)
 		throw Common::Exception("Field is not of a localized string type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	Common::MemoryReader data = getData(field);
 
 	uint32 size = data.readUint32LE();
 
-	Common::SeekableSubReadStream gff(&data, data.pos(), data.pos() + size);
+	Common::MemoryReader locString = data.getSubReader(data.pos(), size);
+	Common::MemoryReadStream gff(locString.getData(), locString.size());
 
 	str.readLocString(gff);
 }
 
-Common::SeekableReadStream *GFFStruct::getData(const Common::UString &field) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return 0;
-	if (f->type != kFieldTypeVoid)
+Common::SeekableReadStream *GFFStruct::readData(const Field &field) const {
+	if (field.type != kFieldTypeVoid)
 		throw Common::Exception("Field is not a data type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	Common::MemoryReader data = getData(field);
 
 	uint32 size = data.readUint32LE();
 
 	return data.readStream(size);
 }
 
-void GFFStruct::getVector(const Common::UString &field,
-                          float &x, float &y, float &z) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return;
-	if (f->type != kFieldTypeVector)
-		throw Common::Exception("Field is not a vector type");
-
-	Common::SeekableReadStream &data = getData(*f);
-
-	x = data.readIEEEFloatLE();
-	y = data.readIEEEFloatLE();
-	z = data.readIEEEFloatLE();
-}
-
-void GFFStruct::getOrientation(const Common::UString &field,
-                               float &a, float &b, float &c, float &d) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return;
-	if (f->type != kFieldTypeOrientation)
-		throw Common::Exception("Field is not an orientation type");
-
-	Common::SeekableReadStream &data = getData(*f);
-
-	a = data.readIEEEFloatLE();
-	b = data.readIEEEFloatLE();
-	c = data.readIEEEFloatLE();
-	d = data.readIEEEFloatLE();
-}
-
-void GFFStruct::getVector(const Common::UString &field,
-                          double &x, double &y, double &z) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return;
-	if (f->type != kFieldTypeVector)
+void GFFStruct::readVector(const Field &field, float &x, float &y, float &z) const {
+	if (field.type != kFieldTypeVector)
 		throw Common::Exception("Field is not a vector type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	Common::MemoryReader data = getData(field);
 
 	x = data.readIEEEFloatLE();
 	y = data.readIEEEFloatLE();
 	z = data.readIEEEFloatLE();
 }
 
-void GFFStruct::getOrientation(const Common::UString &field,
-                               double &a, double &b, double &c, double &d) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
-		return;
-	if (f->type != kFieldTypeOrientation)
+void GFFStruct::readOrientation(const Field &field,
+                                float &a, float &b, float &c, float &d) const {
+	if (field.type != kFieldTypeOrientation)
 		throw Common::Exception("Field is not an orientation type");
 
-	Common::SeekableReadStream &data = getData(*f);
+	Common::MemoryReader data = getData(field);
 
 	a = data.readIEEEFloatLE();
 	b = data.readIEEEFloatLE();
@@ -589,36 +748,24 @@ void GFFStruct::getOrientation(const Common::UString &field,
 	d = data.readIEEEFloatLE();
 }
 
-const GFFStruct &GFFStruct::getStruct(const Common::UString &field) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
+const GFFStruct &GFFStruct::readStruct(const Field *field) const {
+	if (!field)
 		throw Common::Exception("No such field");
-	if (f->type != kFieldTypeStruct)
+	if (field->type != kFieldTypeStruct)
 		throw Common::Exception("Field is not a struct type");
 
 	// Direct index into the struct array
-	return _parent->getStruct(f->data);
+	return _parent->getStruct(field->data);
 }
 
-const GFFList &GFFStruct::getList(const Common::UString &field, uint32 &size) const {
-	load();
-
-	const Field *f = getField(field);
-	if (!f)
+const GFFList &GFFStruct::readList(const Field *field, uint32 &size) const {
+	if (!field)
 		throw Common::Exception("No such field");
-	if (f->type != kFieldTypeList)
+	if (field->type != kFieldTypeList)
 		throw Common::Exception("Field is not a list type");
 
 	// Byte offset into the list area, all 32bit values.
-	return _parent->getList(f->data / 4, size);
-}
-
-const GFFList &GFFStruct::getList(const Common::UString &field) const {
-	uint32 size;
-
-	return getList(field, size);
+	return _parent->getList(field->data / 4, size);
 }
 
 } // End of namespace Aurora
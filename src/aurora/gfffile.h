@@ -32,10 +32,10 @@
 
 #include <vector>
 #include <list>
-#include <map>
 
 #include "common/types.h"
 #include "common/ustring.h"
+#include "common/memreader.h"
 
 #include "aurora/types.h"
 #include "aurora/aurorafile.h"
@@ -51,6 +51,17 @@ class GFFStruct;
 
 typedef std::list<GFFStruct *> GFFList;
 
+/** The label ID of a label not found in a GFF. */
+static const uint32 kGFFLabelNone = 0xFFFFFFFF;
+
+/** A GFF file.
+ *
+ *  The whole GFF is decoded when it's constructed. Afterwards, neither the
+ *  GFFFile nor its structs change, and all reads go through their own
+ *  readers instead of a shared stream position. So any number of threads
+ *  can read the same GFFFile concurrently, as long as it isn't destroyed
+ *  while they do.
+ */
 class GFFFile : public AuroraBase {
 public:
 	GFFFile(Common::SeekableReadStream *gff, uint32 id);
@@ -60,6 +71,13 @@ public:
 	/** Returns the top-level struct. */
 	const GFFStruct &getTopLevel() const;
 
+	/** Return the ID this GFF uses for a field label, or kGFFLabelNone.
+	 *
+	 *  The ID can be used to look up a field in any struct of this GFF
+	 *  without comparing strings. It is only valid for this GFF.
+	 */
+	uint32 getLabelID(const Common::UString &label) const;
+
 private:
 	/** A GFF header. */
 	struct Header {
@@ -82,17 +100,23 @@ private:
 		void clear();
 
 		/** Read the header out of a gff. */
-		void read(Common::SeekableReadStream &gff);
+		void read(Common::MemoryReader &gff);
 	};
 
 	typedef std::vector<GFFStruct *> StructArray;
 	typedef std::vector<GFFList> ListArray;
+	typedef std::vector<Common::UString> LabelArray;
 
 
+	/** The GFF's stream, if _data views its memory. */
 	Common::SeekableReadStream *_stream;
 
+	/** The whole GFF. Only read through copies once loaded. */
+	Common::MemoryReader _data;
+
 	Header _header; ///< The GFF's header
 
+	LabelArray  _labels;  ///< Our field labels, sorted. The index is the label ID.
 	StructArray _structs; ///< Our structs.
 	ListArray   _lists;   ///< Our lists.
 
@@ -103,10 +127,8 @@ private:
 	std::vector<uint32> _listOffsetToIndex;
 
 
-	/** Return the GFF stream. */
-	Common::SeekableReadStream &getStream() const;
-	/** Return the GFF stream seeked to the start of the field data. */
-	Common::SeekableReadStream &getFieldData() const;
+	/** Return the whole GFF's data. */
+	const Common::MemoryReader &getData() const;
 
 	/** Return a struct within the GFF. */
 	const GFFStruct &getStruct(uint32 i) const;
@@ -115,7 +137,8 @@ private:
 
 	// Loading helpers
 	void load(uint32 id);
-	void readStructs();
+	void readLabels(std::vector<uint32> &labelIDs);
+	void readStructs(const std::vector<uint32> &labelIDs);
 	void readLists();
 
 	friend class GFFStruct;
@@ -126,21 +149,35 @@ class GFFStruct {
 public:
 	uint getFieldCount() const;
 
+	/** Return the ID the GFF uses for a field label, or kGFFLabelNone. */
+	uint32 getLabelID(const Common::UString &label) const;
+
 	bool hasField(const Common::UString &field) const;
+	bool hasField(uint32 label) const;
 
 	char   getChar(const Common::UString &field, char   def = '\0' ) const;
 	uint64 getUint(const Common::UString &field, uint64 def = 0    ) const;
 	 int64 getSint(const Common::UString &field,  int64 def = 0    ) const;
 	bool   getBool(const Common::UString &field, bool   def = false) const;
 
+	char   getChar(uint32 label, char   def = '\0' ) const;
+	uint64 getUint(uint32 label, uint64 def = 0    ) const;
+	 int64 getSint(uint32 label,  int64 def = 0    ) const;
+	bool   getBool(uint32 label, bool   def = false) const;
+
 	double getDouble(const Common::UString &field, double def = 0.0) const;
+	double getDouble(uint32 label, double def = 0.0) const;
 
 	Common::UString getString(const Common::UString &field,
 	                          const Common::UString &def = "") const;
+	Common::UString getString(uint32 label,
+	                          const Common::UString &def = "") const;
 
 	void getLocString(const Common::UString &field, LocString &str) const;
+	void getLocString(uint32 label, LocString &str) const;
 
 	Common::SeekableReadStream *getData(const Common::UString &field) const;
+	Common::SeekableReadStream *getData(uint32 label) const;
 
 	void getVector     (const Common::UString &field,
 			float &x, float &y, float &z          ) const;
@@ -152,10 +189,20 @@ public:
 	void getOrientation(const Common::UString &field,
 			double &a, double &b, double &c, double &d) const;
 
+	void getVector     (uint32 label, float &x, float &y, float &z          ) const;
+	void getOrientation(uint32 label, float &a, float &b, float &c, float &d) const;
+
+	void getVector     (uint32 label, double &x, double &y, double &z           ) const;
+	void getOrientation(uint32 label, double &a, double &b, double &c, double &d) const;
+
 	const GFFStruct &getStruct(const Common::UString &field) const;
 	const GFFList   &getList  (const Common::UString &field) const;
 	const GFFList   &getList  (const Common::UString &field, uint32 &size) const;
 
+	const GFFStruct &getStruct(uint32 label) const;
+	const GFFList   &getList  (uint32 label) const;
+	const GFFList   &getList  (uint32 label, uint32 &size) const;
+
 private:
 	/** The type of a GFF field. */
 	enum FieldType {
@@ -183,40 +230,52 @@ private:
 
 	/** A GFF field. */
 	struct Field {
+		uint32    label;    ///< ID of the field's label.
 		FieldType type;     ///< Type of the field.
 		uint32    data;     ///< Data of the field.
 		bool      extended; ///< Does this field need extended data?
 
 		Field();
-		Field(FieldType t, uint32 d);
+		Field(uint32 l, FieldType t, uint32 d);
+
+		bool operator<(const Field &field) const;
 	};
 
-	typedef std::map<Common::UString, Field> FieldMap;
+	typedef std::vector<Field> FieldArray;
 
 	const GFFFile *_parent; ///< The parent GFF.
 
-	uint32 _id;         ///< The struct's ID.
-	uint32 _fieldIndex; ///< Field / Field indices index.
-	uint32 _fieldCount; ///< Field count.
+	uint32 _id; ///< The struct's ID.
 
-	mutable FieldMap _fields; ///< The fields, indexed by their label.
+	FieldArray _fields; ///< The fields, sorted by label ID.
 
-	GFFStruct(const GFFFile &parent, Common::SeekableReadStream &gff);
+	GFFStruct(const GFFFile &parent, uint32 id);
 	~GFFStruct();
 
-	void load() const;
-
-	/** Returns the field with this tag. */
+	/** Returns the field with this label. */
 	const Field *getField(const Common::UString &name) const;
-	/** Returns the extended field data for this field. */
-	Common::SeekableReadStream &getData(const Field &field) const;
+	/** Returns the field with this label ID. */
+	const Field *getField(uint32 label) const;
+	/** Returns a reader positioned at the extended field data for this field. */
+	Common::MemoryReader getData(const Field &field) const;
 
-	// Loading helpers
-	void readField  (Common::SeekableReadStream &gff, uint32 index) const;
-	void readFields (Common::SeekableReadStream &gff, uint32 index, uint32 count) const;
-	void readIndices(Common::SeekableReadStream &gff,
-	                 std::vector<uint32> &indices, uint32 count) const;
-	Common::UString readLabel(Common::SeekableReadStream &gff, uint32 index) const;
+	// Typed field readers
+	char   readChar  (const Field &field) const;
+	uint64 readUint  (const Field &field) const;
+	 int64 readSint  (const Field &field) const;
+	double readDouble(const Field &field) const;
+
+	Common::UString readString(const Field &field) const;
+
+	void readLocString(const Field &field, LocString &str) const;
+
+	Common::SeekableReadStream *readData(const Field &field) const;
+
+	void readVector     (const Field &field, float &x, float &y, float &z          ) const;
+	void readOrientation(const Field &field, float &a, float &b, float &c, float &d) const;
+
+	const GFFStruct &readStruct(const Field *field) const;
+	const GFFList   &readList  (const Field *field, uint32 &size) const;
 
 	friend class GFFFile;
 };
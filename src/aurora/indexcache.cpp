@@ -0,0 +1,451 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file aurora/indexcache.cpp
+ *  A persistent cache of archive and directory indices.
+ */
+
+#include <string>
+#include <cstring>
+#include <list>
+
+#include "common/util.h"
+#include "common/error.h"
+#include "common/stream.h"
+#include "common/file.h"
+#include "common/filepath.h"
+
+#include "aurora/indexcache.h"
+#include "aurora/error.h"
+
+static const uint32 kCacheID  = MKID_BE('EIDX');
+static const uint32 kVersion2 = MKID_BE('V2.0');
+
+namespace Aurora {
+
+static Common::UString readString(Common::SeekableReadStream &stream) {
+	uint32 length = stream.readUint32LE();
+	if (length > ((uint32) (stream.size() - stream.pos())))
+		throw Common::Exception(Common::kReadError);
+
+	std::string str(length, '\0');
+	if (length > 0)
+		stream.read(&str[0], length);
+
+	return str;
+}
+
+static void writeString(Common::WriteStream &stream, const Common::UString &str) {
+	uint32 length = std::strlen(str.c_str());
+
+	stream.writeUint32LE(length);
+	stream.write(str.c_str(), length);
+}
+
+static uint32 getStringSize(const Common::UString &str) {
+	return 4 + std::strlen(str.c_str());
+}
+
+
+IndexCache::Resource::Resource(const Common::UString &n, FileType t, uint32 o, uint32 s) :
+	name(n), type(t), offset(o), size(s) {
+}
+
+
+IndexCache::Entry::Entry() : parsed(false), offset(0), size(0) {
+}
+
+
+IndexCache::IndexCache() : _changed(false) {
+}
+
+IndexCache::~IndexCache() {
+}
+
+void IndexCache::clear() {
+	_entries.clear();
+	_file.close();
+
+	_changed = false;
+}
+
+bool IndexCache::changed() const {
+	return _changed;
+}
+
+bool IndexCache::load(const Common::UString &fileName) {
+	clear();
+
+	if (!_file.open(fileName))
+		return false;
+
+	Common::SeekableReadStream *cache = _file.createReadStream(0, _file.size());
+
+	try {
+		if (cache->readUint32BE() != kCacheID)
+			throw Common::Exception("Not an index cache file");
+		if (cache->readUint32BE() != kVersion2)
+			throw Common::Exception("Unsupported index cache version");
+
+		readEntries(*cache);
+
+	} catch (Common::Exception &e) {
+		delete cache;
+
+		e.add("Failed reading index cache \"%s\"", fileName.c_str());
+		Common::printException(e, "WARNING: ");
+
+		clear();
+		return false;
+	}
+
+	delete cache;
+	return true;
+}
+
+void IndexCache::readEntries(Common::SeekableReadStream &cache) {
+	// Only note where each entry is, it's parsed when it's needed
+	uint32 entryCount = cache.readUint32LE();
+	for (uint32 i = 0; i < entryCount; i++) {
+		Common::UString key = readString(cache);
+
+		Entry &entry = _entries[key];
+
+		entry.size   = cache.readUint32LE();
+		entry.offset = cache.pos();
+
+		if (cache.eos() || cache.err() || (entry.size > ((uint32) (cache.size() - cache.pos()))))
+			throw Common::Exception(Common::kReadError);
+
+		cache.skip(entry.size);
+	}
+}
+
+void IndexCache::readFileHeaders(Common::SeekableReadStream &stream, FileList &files) {
+	files.resize(stream.readUint32LE());
+	for (FileList::iterator f = files.begin(); f != files.end(); ++f) {
+		f->path = readString(stream);
+		f->size = stream.readUint32LE();
+		f->time = stream.readUint32LE();
+
+		if (stream.eos() || stream.err())
+			throw Common::Exception(Common::kReadError);
+	}
+}
+
+void IndexCache::readResources(Common::SeekableReadStream &stream, FileList &files) {
+	for (FileList::iterator f = files.begin(); f != files.end(); ++f) {
+		f->resources.resize(stream.readUint32LE());
+		for (ResourceList::iterator r = f->resources.begin(); r != f->resources.end(); ++r) {
+			r->name   = readString(stream);
+			r->type   = (FileType) stream.readUint32LE();
+			r->offset = stream.readUint32LE();
+			r->size   = stream.readUint32LE();
+		}
+
+		if (stream.eos() || stream.err())
+			throw Common::Exception(Common::kReadError);
+	}
+}
+
+void IndexCache::parseEntry(Entry &entry) const {
+	Common::SeekableReadStream *data = _file.createReadStream(entry.offset, entry.size);
+
+	try {
+		readFileHeaders(*data, entry.files);
+		readResources(*data, entry.files);
+	} catch (...) {
+		delete data;
+		throw;
+	}
+
+	delete data;
+
+	entry.parsed = true;
+}
+
+bool IndexCache::isEntryValid(const Entry &entry) const {
+	FileList headers;
+
+	const FileList *files = &entry.files;
+	if (!entry.parsed) {
+		// Only the files themselves are needed, not their resources
+		Common::SeekableReadStream *data = _file.createReadStream(entry.offset, entry.size);
+
+		try {
+			readFileHeaders(*data, headers);
+		} catch (Common::Exception &e) {
+			delete data;
+			return false;
+		}
+
+		delete data;
+
+		files = &headers;
+	}
+
+	for (FileList::const_iterator f = files->begin(); f != files->end(); ++f)
+		if (!isValid(*f))
+			return false;
+
+	return true;
+}
+
+uint32 IndexCache::getEntrySize(const FileList &files) {
+	uint32 size = 4;
+
+	for (FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		size += getStringSize(f->path) + 4 + 4 + 4;
+
+		for (ResourceList::const_iterator r = f->resources.begin(); r != f->resources.end(); ++r)
+			size += getStringSize(r->name) + 4 + 4 + 4;
+	}
+
+	return size;
+}
+
+void IndexCache::writeEntry(Common::WriteStream &stream, const FileList &files) {
+	stream.writeUint32LE(files.size());
+	for (FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		writeString(stream, f->path);
+		stream.writeUint32LE(f->size);
+		stream.writeUint32LE(f->time);
+	}
+
+	for (FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		stream.writeUint32LE(f->resources.size());
+		for (ResourceList::const_iterator r = f->resources.begin(); r != f->resources.end(); ++r) {
+			writeString(stream, r->name);
+			stream.writeUint32LE((uint32) r->type);
+			stream.writeUint32LE(r->offset);
+			stream.writeUint32LE(r->size);
+		}
+	}
+}
+
+void IndexCache::save(const Common::UString &fileName) {
+	// Drop all entries whose files changed or vanished
+	for (EntryMap::iterator e = _entries.begin(); e != _entries.end(); ) {
+		if (!isEntryValid(e->second))
+			_entries.erase(e++);
+		else
+			++e;
+	}
+
+	// Entries never parsed are written back as they are. Their data has to
+	// be read before the cache file is overwritten.
+	std::list< std::vector<byte> > unparsed;
+	for (EntryMap::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		if (e->second.parsed)
+			continue;
+
+		unparsed.push_back(std::vector<byte>(e->second.size));
+		if (e->second.size == 0)
+			continue;
+
+		Common::SeekableReadStream *data = _file.createReadStream(e->second.offset, e->second.size);
+		data->read(&unparsed.back()[0], e->second.size);
+		delete data;
+	}
+
+	_file.close();
+
+	try {
+		Common::DumpFile cache;
+		if (!cache.open(fileName))
+			throw Common::Exception(Common::kOpenError);
+
+		cache.writeUint32BE(kCacheID);
+		cache.writeUint32BE(kVersion2);
+
+		cache.writeUint32LE(_entries.size());
+
+		std::list< std::vector<byte> >::const_iterator data = unparsed.begin();
+		for (EntryMap::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+			writeString(cache, e->first);
+
+			if (e->second.parsed) {
+				cache.writeUint32LE(getEntrySize(e->second.files));
+				writeEntry(cache, e->second.files);
+				continue;
+			}
+
+			cache.writeUint32LE(data->size());
+			if (!data->empty())
+				cache.write(&(*data)[0], data->size());
+
+			++data;
+		}
+
+		if (!cache.flush() || cache.err())
+			throw Common::Exception(Common::kWriteError);
+
+		cache.close();
+
+	} catch (...) {
+		// The data of the unparsed entries was in the old cache file
+		for (EntryMap::iterator e = _entries.begin(); e != _entries.end(); ) {
+			if (!e->second.parsed)
+				_entries.erase(e++);
+			else
+				++e;
+		}
+
+		throw;
+	}
+
+	// Map the new cache file, again parsing entries only when they're needed
+	load(fileName);
+}
+
+const IndexCache::FileList *IndexCache::find(const Common::UString &key) {
+	EntryMap::iterator entry = _entries.find(key);
+	if (entry == _entries.end())
+		return 0;
+
+	if (!entry->second.parsed) {
+		try {
+			parseEntry(entry->second);
+		} catch (Common::Exception &e) {
+			e.add("Failed reading index cache entry \"%s\"", key.c_str());
+			Common::printException(e, "WARNING: ");
+
+			_entries.erase(entry);
+			return 0;
+		}
+	}
+
+	// Make sure none of the files changed since the entry was created
+	for (FileList::const_iterator f = entry->second.files.begin(); f != entry->second.files.end(); ++f)
+		if (!isValid(*f))
+			return 0;
+
+	return &entry->second.files;
+}
+
+void IndexCache::add(const Common::UString &key, const FileList &files) {
+	Entry &entry = _entries[key];
+
+	entry.parsed = true;
+	entry.files  = files;
+
+	_changed = true;
+}
+
+bool IndexCache::stat(const Common::UString &path, File &file) {
+	file.path = path;
+	file.size = 0;
+
+	if (!Common::FilePath::isDirectory(path)) {
+		if (!Common::FilePath::isRegularFile(path))
+			return false;
+
+		if ((file.size = Common::FilePath::getFileSize(path)) == Common::kFileInvalid)
+			return false;
+	}
+
+	if ((file.time = Common::FilePath::getModificationTime(path)) == Common::kFileInvalid)
+		return false;
+
+	return true;
+}
+
+bool IndexCache::isValid(const File &file) {
+	File current;
+	if (!stat(file.path, current))
+		return false;
+
+	return (current.size == file.size) && (current.time == file.time);
+}
+
+
+CachedArchive::CachedArchive(const IndexCache::File &file) : _fileName(file.path) {
+	_resources.resize(file.resources.size());
+	_iResources.resize(file.resources.size());
+
+	uint32 index = 0;
+	ResourceList::iterator res = _resources.begin();
+	for (IndexCache::ResourceList::const_iterator r = file.resources.begin();
+	     r != file.resources.end(); ++r, ++res, ++index) {
+
+		res->name  = r->name;
+		res->type  = r->type;
+		res->index = index;
+
+		_iResources[index].offset = r->offset;
+		_iResources[index].size   = r->size;
+	}
+
+	_mappedFile.open(_fileName);
+}
+
+CachedArchive::~CachedArchive() {
+}
+
+void CachedArchive::clear() {
+	_resources.clear();
+}
+
+const Archive::ResourceList &CachedArchive::getResources() const {
+	return _resources;
+}
+
+const CachedArchive::IResource &CachedArchive::getIResource(uint32 index) const {
+	if (index >= _iResources.size())
+		throw Common::Exception("Resource index out of range (%d/%d)", index, _iResources.size());
+
+	return _iResources[index];
+}
+
+uint32 CachedArchive::getResourceSize(uint32 index) const {
+	return getIResource(index).size;
+}
+
+Common::SeekableReadStream *CachedArchive::getResource(uint32 index) const {
+	const IResource &res = getIResource(index);
+	if (res.size == 0)
+		return new Common::MemoryReadStream(0, 0);
+
+	if (_mappedFile.isOpen())
+		return _mappedFile.createReadStream(res.offset, res.size);
+
+	Common::File file;
+	if (!file.open(_fileName))
+		throw Common::Exception(Common::kOpenError);
+
+	if (!file.seek(res.offset))
+		throw Common::Exception(Common::kSeekError);
+
+	Common::SeekableReadStream *resStream = file.readStream(res.size);
+
+	if (!resStream || (((uint32) resStream->size()) != res.size)) {
+		delete resStream;
+		throw Common::Exception(Common::kReadError);
+	}
+
+	return resStream;
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,204 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file aurora/indexcache.h
+ *  A persistent cache of archive and directory indices.
+ */
+
+#ifndef AURORA_INDEXCACHE_H
+#define AURORA_INDEXCACHE_H
+
+#include <vector>
+#include <map>
+
+#include "common/types.h"
+#include "common/ustring.h"
+#include "common/file.h"
+
+#include "aurora/types.h"
+#include "aurora/archive.h"
+
+namespace Aurora {
+
+/** A persistent cache of archive and directory indices.
+ *
+ *  Every cache entry consists of the files it was built from, together with
+ *  the resources found in them. An entry is only valid as long as the size
+ *  and the modification time of all its files still match.
+ *
+ *  The cache file stays mapped into memory, and an entry is only parsed
+ *  once it's looked up. When the cache is saved, outdated entries are
+ *  dropped, and entries never looked up are copied over unparsed.
+ */
+class IndexCache {
+public:
+	/** A resource within a cached file. */
+	struct Resource {
+		Common::UString name; ///< The resource's name. For directories, the file's path.
+		FileType        type; ///< The resource's type.
+
+		uint32 offset; ///< The offset of the resource within the file.
+		uint32 size;   ///< The resource's size.
+
+		Resource(const Common::UString &n = "", FileType t = kFileTypeNone, uint32 o = 0, uint32 s = 0);
+	};
+
+	typedef std::vector<Resource> ResourceList;
+
+	/** A file a cache entry was built from. */
+	struct File {
+		Common::UString path; ///< The file's path.
+
+		uint32 size; ///< The file's size. 0 for directories.
+		uint32 time; ///< The file's modification time.
+
+		ResourceList resources; ///< The resources found in the file.
+	};
+
+	typedef std::vector<File> FileList;
+
+	IndexCache();
+	~IndexCache();
+
+	/** Clear the cache. */
+	void clear();
+
+	/** Was the cache changed since it was loaded? */
+	bool changed() const;
+
+	/** Load the cache from a file.
+	 *
+	 *  @param  fileName The file to load from.
+	 *  @return true if the cache file was loaded, false if it's missing or invalid.
+	 */
+	bool load(const Common::UString &fileName);
+
+	/** Save the cache into a file. */
+	void save(const Common::UString &fileName);
+
+	/** Find a cache entry, parsing it if necessary.
+	 *
+	 *  @param  key The unique key of the entry.
+	 *  @return The files of the entry, or 0 if there's no such entry or it's outdated.
+	 */
+	const FileList *find(const Common::UString &key);
+
+	/** Add (or replace) a cache entry. */
+	void add(const Common::UString &key, const FileList &files);
+
+	/** Fill in the path, size and modification time of a file or directory.
+	 *
+	 *  @return false if no such file or directory exists.
+	 */
+	static bool stat(const Common::UString &path, File &file);
+
+private:
+	/** A cache entry. */
+	struct Entry {
+		bool parsed; ///< Were the files read out of the cache file yet?
+
+		FileList files; ///< The entry's files, once parsed.
+
+		// For entries not yet parsed
+		uint32 offset; ///< The offset of the entry's data within the cache file.
+		uint32 size;   ///< The size of the entry's data.
+
+		Entry();
+	};
+
+	typedef std::map<Common::UString, Entry> EntryMap;
+
+	EntryMap _entries;
+
+	/** The loaded cache file, holding the data of all entries not yet parsed. */
+	Common::MappedFile _file;
+
+	bool _changed;
+
+	void readEntries(Common::SeekableReadStream &cache);
+
+	/** Read the files of an entry out of the cache file. */
+	void parseEntry(Entry &entry) const;
+	/** Are all files of the entry unchanged? */
+	bool isEntryValid(const Entry &entry) const;
+
+	static void readFileHeaders(Common::SeekableReadStream &stream, FileList &files);
+	static void readResources(Common::SeekableReadStream &stream, FileList &files);
+
+	/** Return the number of bytes writeEntry() writes for these files. */
+	static uint32 getEntrySize(const FileList &files);
+	static void writeEntry(Common::WriteStream &stream, const FileList &files);
+
+	static bool isValid(const File &file);
+};
+
+/** An archive restored from the index cache.
+ *
+ *  All its resources are plain, uncompressed data within a single file.
+ */
+class CachedArchive : public Archive {
+public:
+	CachedArchive(const IndexCache::File &file);
+	~CachedArchive();
+
+	/** Clear the resource list. */
+	void clear();
+
+	/** Return the list of resources. */
+	const ResourceList &getResources() const;
+
+	/** Return the size of a resource. */
+	uint32 getResourceSize(uint32 index) const;
+
+	/** Return a stream of the resource's contents. */
+	Common::SeekableReadStream *getResource(uint32 index) const;
+
+private:
+	/** Internal resource information. */
+	struct IResource {
+		uint32 offset; ///< The offset of the resource within the file.
+		uint32 size;   ///< The resource's size.
+	};
+
+	typedef std::vector<IResource> IResourceList;
+
+	/** External list of resource names and types. */
+	ResourceList _resources;
+
+	/** Internal list of resource offsets and sizes. */
+	IResourceList _iResources;
+
+	/** The name of the archive file. */
+	Common::UString _fileName;
+
+	/** The archive file mapped into memory, if possible. */
+	Common::MappedFile _mappedFile;
+
+	const IResource &getIResource(uint32 index) const;
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_INDEXCACHE_H
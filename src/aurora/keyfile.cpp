@@ -30,6 +30,7 @@
 #include "common/util.h"
 #include "common/error.h"
 #include "common/stream.h"
+#include "common/memreader.h"
 #include "common/file.h"
 
 #include "aurora/keyfile.h"
@@ -122,19 +123,21 @@ void KEYFile::readBIFList(Common::SeekableReadStream &key, uint32 offset) {
 }
 
 void KEYFile::readResList(Common::SeekableReadStream &key, uint32 offset) {
-	if (!key.seek(offset))
-		throw Common::Exception(Common::kSeekError);
+	const uint32 entrySize = (_version == kVersion11) ? 26 : 22;
+
+	// Read the whole table at once
+	Common::MemoryReader table(key, offset, _resources.size() * entrySize);
 
 	for (ResourceList::iterator res = _resources.begin(); res != _resources.end(); ++res) {
-		res->name.readFixedASCII(key, 16);
-		res->type = (FileType) key.readUint16LE();
+		res->name = table.readFixedASCII(16);
+		res->type = (FileType) table.readUint16LE();
 
-		uint32 id = key.readUint32LE();
+		uint32 id = table.readUint32LE();
 
 		// The new flags field holds the bifIndex now. The rest contains fixed
 		// resource info.
 		if (_version == kVersion11) {
-			uint32 flags = key.readUint32LE();
+			uint32 flags = table.readUint32LE();
 			res->bifIndex = (flags & 0xFFF00000) >> 20;
 		} else
 			res->bifIndex = id >> 20;
@@ -48,6 +48,37 @@ static const uint32 kScriptObjectSelf        = 0x00000000;
 static const uint32 kScriptObjectInvalid     = 0x00000001;
 static const uint32 kScriptObjectTypeInvalid = 0x7F000000;
 
+static const uint32 kScriptStart = 13; // 8 byte header + 5 byte program size dummy op
+
+/** Marks a jump target that's not the start of an instruction. */
+static const uint32 kInvalidTarget = 0xFFFFFFFF;
+
+/** Marks an instruction that couldn't be read completely. */
+static const uint8 kOpcodeTruncated = 0xFF;
+
+enum {
+	kOpcodeCPDOWNSP   = 0x01,
+	kOpcodeCPTOPSP    = 0x03,
+	kOpcodeCONST      = 0x04,
+	kOpcodeACTION     = 0x05,
+	kOpcodeEQ         = 0x0B,
+	kOpcodeNEQ        = 0x0C,
+	kOpcodeMOVSP      = 0x1B,
+	kOpcodeJMP        = 0x1D,
+	kOpcodeJSR        = 0x1E,
+	kOpcodeJZ         = 0x1F,
+	kOpcodeDESTRUCT   = 0x21,
+	kOpcodeDECSP      = 0x23,
+	kOpcodeINCSP      = 0x24,
+	kOpcodeJNZ        = 0x25,
+	kOpcodeCPDOWNBP   = 0x26,
+	kOpcodeCPTOPBP    = 0x27,
+	kOpcodeDECBP      = 0x28,
+	kOpcodeINCBP      = 0x29,
+	kOpcodeSTORESTATE = 0x2C,
+	kOpcodeNOP        = 0x2D
+};
+
 namespace Aurora {
 
 namespace NWScript {
@@ -261,24 +292,92 @@ void NCSFile::setupOpcodes() {
 
 #undef OPCODE
 
-NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _owner(0), _triggerer(0) {
-	_script = ncs;
+NCSFile::ProgramCache NCSFile::_cache;
+
+NCSFile::Instruction::Instruction() : address(0), opcode(0), type(kInstTypeNone),
+	constFloat(0.0), target(kInvalidTarget) {
+
+	args[0] = args[1] = args[2] = 0;
+}
+
+
+uint32 NCSFile::Program::findInstruction(uint32 address) const {
+	if (address == size)
+		return instructions.size();
+
+	// The instructions are ordered by their address
+	uint32 first = 0, last = instructions.size();
+	while (first < last) {
+		const uint32 middle = first + (last - first) / 2;
+
+		if      (instructions[middle].address < address)
+			first = middle + 1;
+		else if (instructions[middle].address > address)
+			last  = middle;
+		else
+			return middle;
+	}
+
+	return kInvalidTarget;
+}
+
+
+NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _pc(0), _instruction(0),
+	_owner(0), _triggerer(0) {
+
+	setupOpcodes();
+
+	try {
+		load(*ncs);
+	} catch (...) {
+		delete ncs;
+		throw;
+	}
 
-	load();
+	delete ncs;
+
+	reset();
 }
 
-NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _script(0),
+NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _pc(0), _instruction(0),
 	_owner(0), _triggerer(0) {
 
-	_script = ResMan.getResource(ncs, kFileTypeNCS);
-	if (!_script)
+	setupOpcodes();
+
+	Common::UString cacheName = ncs;
+	cacheName.tolower();
+
+	ProgramCache::const_iterator cached = _cache.find(cacheName);
+	if (cached != _cache.end()) {
+		_program = cached->second;
+
+		reset();
+		return;
+	}
+
+	Common::SeekableReadStream *script = ResMan.getResource(ncs, kFileTypeNCS);
+	if (!script)
 		throw Common::Exception("No such NCS \"%s\"", ncs.c_str());
 
-	load();
+	try {
+		load(*script);
+	} catch (...) {
+		delete script;
+		throw;
+	}
+
+	delete script;
+
+	_cache.insert(std::make_pair(cacheName, _program));
+
+	reset();
 }
 
 NCSFile::~NCSFile() {
-	delete _script;
+}
+
+void NCSFile::clearCache() {
+	_cache.clear();
 }
 
 const Common::UString &NCSFile::getName() const {
@@ -288,13 +387,13 @@ const Common::UString &NCSFile::getName() const {
 ScriptState NCSFile::getEmptyState() {
 	ScriptState state;
 
-	state.offset = 13; // 8 byte header + 5 byte program size dummy op
+	state.offset = kScriptStart;
 
 	return state;
 }
 
-void NCSFile::load() {
-	readHeader(*_script);
+void NCSFile::load(Common::SeekableReadStream &ncs) {
+	readHeader(ncs);
 
 	if (_id != kNCSTag)
 		throw Common::Exception("Try to load non-NCS file");
@@ -302,19 +401,154 @@ void NCSFile::load() {
 	if (_version != kVersion10)
 		throw Common::Exception("Unsupported NCS file version %08X", _version);
 
-	byte lengthOpcode = _script->readByte();
+	byte lengthOpcode = ncs.readByte();
 	if (lengthOpcode != 0x42)
 		throw Common::Exception("Script size opcode != 0x42 (0x%02X)", lengthOpcode);
 
-	uint32 length = _script->readUint32BE();
-	if (length > ((uint32) _script->size()))
-		throw Common::Exception("Script size %d > stream size %d", length, _script->size());
-	if (length < ((uint32) _script->size()))
-		warning("TODO: NCSFile::load(): Script size %d < stream size %d", length, _script->size());
+	uint32 length = ncs.readUint32BE();
+	if (length > ((uint32) ncs.size()))
+		throw Common::Exception("Script size %d > stream size %d", length, ncs.size());
+	if (length < ((uint32) ncs.size()))
+		warning("TODO: NCSFile::load(): Script size %d < stream size %d", length, ncs.size());
 
-	setupOpcodes();
+	Program *program = new Program;
 
-	reset();
+	try {
+		decode(ncs, *program);
+	} catch (...) {
+		delete program;
+		throw;
+	}
+
+	_program.reset(program);
+}
+
+void NCSFile::decode(Common::SeekableReadStream &ncs, Program &program) {
+	program.size = ncs.size();
+
+	if (!ncs.seek(kScriptStart))
+		throw Common::Exception(Common::kSeekError);
+
+	while (!ncs.eos() && (ncs.pos() < ncs.size())) {
+		program.instructions.push_back(Instruction());
+		Instruction &instruction = program.instructions.back();
+
+		instruction.address = ncs.pos();
+		instruction.opcode  = ncs.readByte();
+		instruction.type    = (InstructionType) ncs.readByte();
+
+		if (ncs.err())
+			throw Common::Exception(Common::kReadError);
+
+		if (ncs.eos()) {
+			instruction.opcode = kOpcodeTruncated;
+			break;
+		}
+
+		// We can't know the length of an unknown instruction, so stop there
+		if (!readOperands(ncs, instruction))
+			break;
+
+		if (ncs.err())
+			throw Common::Exception(Common::kReadError);
+
+		if (ncs.eos()) {
+			instruction.opcode = kOpcodeTruncated;
+			break;
+		}
+	}
+
+	resolveJumps(program);
+}
+
+bool NCSFile::readOperands(Common::SeekableReadStream &ncs, Instruction &instruction) {
+	switch (instruction.opcode) {
+		case kOpcodeCONST:
+			switch (instruction.type) {
+				case kInstTypeInt:
+					instruction.args[0] = ncs.readSint32BE();
+					break;
+
+				case kInstTypeFloat:
+					instruction.constFloat = ncs.readIEEEFloatBE();
+					break;
+
+				case kInstTypeString:
+					instruction.constString.readFixedASCII(ncs, ncs.readUint16BE());
+					break;
+
+				case kInstTypeObject:
+					instruction.args[0] = ncs.readUint32BE();
+					break;
+
+				default:
+					// Unknown constant type, o_const() will throw
+					return false;
+			}
+			break;
+
+		case kOpcodeACTION:
+			instruction.args[0] = ncs.readUint16BE();
+			instruction.args[1] = ncs.readByte();
+			break;
+
+		case kOpcodeEQ:
+		case kOpcodeNEQ:
+			if (instruction.type == kInstTypeStructStruct)
+				instruction.args[0] = ncs.readUint16BE();
+			break;
+
+		case kOpcodeMOVSP:
+		case kOpcodeJMP:
+		case kOpcodeJSR:
+		case kOpcodeJZ:
+		case kOpcodeDECSP:
+		case kOpcodeINCSP:
+		case kOpcodeJNZ:
+		case kOpcodeDECBP:
+		case kOpcodeINCBP:
+			instruction.args[0] = ncs.readSint32BE();
+			break;
+
+		case kOpcodeCPDOWNSP:
+		case kOpcodeCPTOPSP:
+		case kOpcodeCPDOWNBP:
+		case kOpcodeCPTOPBP:
+			instruction.args[0] = ncs.readSint32BE();
+			instruction.args[1] = ncs.readSint16BE();
+			break;
+
+		case kOpcodeDESTRUCT:
+			instruction.args[0] = ncs.readSint16BE();
+			instruction.args[1] = ncs.readSint16BE();
+			instruction.args[2] = ncs.readSint16BE();
+			break;
+
+		case kOpcodeSTORESTATE:
+			instruction.args[0] = ncs.readUint32BE();
+			instruction.args[1] = ncs.readUint32BE();
+			break;
+
+		default:
+			// Unknown instructions can't be decoded any further
+			if (instruction.opcode > kOpcodeNOP)
+				return false;
+			break;
+	}
+
+	return true;
+}
+
+void NCSFile::resolveJumps(Program &program) {
+	for (std::vector<Instruction>::iterator i = program.instructions.begin();
+	     i != program.instructions.end(); ++i) {
+
+		if ((i->opcode != kOpcodeJMP) && (i->opcode != kOpcodeJSR) &&
+		    (i->opcode != kOpcodeJZ ) && (i->opcode != kOpcodeJNZ))
+			continue;
+
+		i->target = program.findInstruction(i->address + i->args[0]);
+	}
 }
 
 void NCSFile::reset() {
@@ -326,7 +560,8 @@ void NCSFile::reset() {
 	_storedState.setType(kTypeVoid);
 	_return.setType(kTypeVoid);
 
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+	_pc          = _program->findInstruction(kScriptStart);
+	_instruction = 0;
 }
 
 const Variable &NCSFile::run(Object *owner, Object *triggerer) {
@@ -339,7 +574,9 @@ const Variable &NCSFile::run(const ScriptState &state, Object *owner, Object *tr
 
 	reset();
 
-	_script->seek(state.offset);
+	_pc = _program->findInstruction(state.offset);
+	if (_pc == kInvalidTarget)
+		throw Common::Exception("NCSFile::run(): Illegal script offset %d", state.offset);
 
 	// Push global variables
 	std::vector<class Variable>::const_reverse_iterator var;
@@ -359,12 +596,9 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 	_owner     = owner;
 	_triggerer = triggerer;
 
-	while (!_script->eos() && !_script->err())
+	while (_pc < _program->instructions.size())
 		executeStep();
 
-	if (_script->err())
-		throw Common::Exception(Common::kReadError);
-
 	if (!_stack.empty())
 		_return = _stack.top();
 
@@ -379,16 +613,19 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 }
 
 void NCSFile::executeStep() {
-	byte opcode = _script->readByte();
-	InstructionType type = (InstructionType)_script->readByte();
+	_instruction = &_program->instructions[_pc++];
+
+	const uint8 opcode = _instruction->opcode;
 
+	if (opcode == kOpcodeTruncated)
+		throw Common::Exception(Common::kReadError);
 	if (opcode >= _opcodeListSize)
 		throw Common::Exception("NCSFile::executeStep(): Illegal instruction 0x%02x", opcode);
 
 	debugC(1, kDebugScripts, "NWScript opcode %s [0x%02X]", _opcodes[opcode].desc, opcode);
 
 	try {
-		(this->*(_opcodes[opcode].proc))(type);
+		(this->*(_opcodes[opcode].proc))(_instruction->type);
 	} catch (Common::Exception e) {
 		throw e;
 	}
@@ -398,13 +635,16 @@ void NCSFile::executeStep() {
 	       _returnOffsets.empty() ? -1 : _returnOffsets.top());
 }
 
-void NCSFile::decompile() {
-	uint32 oldScriptPos = _script->pos();
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+void NCSFile::jump() {
+	if (_instruction->target == kInvalidTarget)
+		throw Common::Exception("NCSFile::jump(): Illegal jump target %d",
+		                        _instruction->address + _instruction->args[0]);
 
-	// TODO
+	_pc = _instruction->target;
+}
 
-	_script->seek(oldScriptPos);
+void NCSFile::decompile() {
+	// TODO
 }
 
 // OPCODES!
@@ -443,21 +683,21 @@ void NCSFile::o_rsadd(InstructionType type) {
 void NCSFile::o_const(InstructionType type) {
 	switch (type) {
 		case kInstTypeInt:
-			_stack.push(_script->readSint32BE());
+			_stack.push(_instruction->args[0]);
 			break;
 
 		case kInstTypeFloat:
-			_stack.push(_script->readIEEEFloatBE());
+			_stack.push(_instruction->constFloat);
 			break;
 
 		case kInstTypeString: {
 			_stack.push(kTypeString);
-			_stack.top().getString().readFixedASCII(*_script, _script->readUint16BE());
+			_stack.top().getString() = _instruction->constString;
 			break;
 		}
 
 		case kInstTypeObject: {
-			uint32 objectID = _script->readUint32BE();
+			uint32 objectID = (uint32) _instruction->args[0];
 
 			if      (objectID == kScriptObjectSelf)
 				_stack.push(_owner);
@@ -560,8 +800,8 @@ void NCSFile::o_action(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_action(): Illegal type %d", type);
 
-	uint16 routineNumber = _script->readUint16BE();
-	uint8  argCount      = _script->readByte();
+	uint16 routineNumber = _instruction->args[0];
+	uint8  argCount      = _instruction->args[1];
 
 	Aurora::NWScript::FunctionContext ctx = FunctionMan.createContext(routineNumber);
 
@@ -640,8 +880,7 @@ void NCSFile::o_booland(InstructionType type) {
 }
 
 void NCSFile::o_eq(InstructionType type) {
-	if (type == kInstTypeStructStruct) // TODO!
-		_script->readUint16BE();
+	// TODO: kInstTypeStructStruct, with its size in args[0]
 
 	Variable arg1 = _stack.pop();
 	Variable arg2 = _stack.pop();
@@ -650,8 +889,7 @@ void NCSFile::o_eq(InstructionType type) {
 }
 
 void NCSFile::o_neq(InstructionType type) {
-	if (type == kInstTypeStructStruct) // TODO!
-		_script->readUint16BE();
+	// TODO: kInstTypeStructStruct, with its size in args[0]
 
 	Variable arg1 = _stack.pop();
 	Variable arg2 = _stack.pop();
@@ -859,25 +1097,22 @@ void NCSFile::o_movsp(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", type);
 
-	_stack.setStackPtr(_stack.getStackPtr() - _script->readSint32BE());
+	_stack.setStackPtr(_stack.getStackPtr() - _instruction->args[0]);
 }
 
 void NCSFile::o_jmp(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-	_script->seek(offset - 6, SEEK_CUR);
+	jump();
 }
 
 void NCSFile::o_jz(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-
 	if (!_stack.pop().getInt())
-		_script->seek(offset - 6, SEEK_CUR);
+		jump();
 }
 
 void NCSFile::o_not(InstructionType type) {
@@ -891,7 +1126,7 @@ void NCSFile::o_decsp(InstructionType type) {
 	if (type != kInstTypeInt)
 		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = _instruction->args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() - 1);
 }
@@ -900,7 +1135,7 @@ void NCSFile::o_incsp(InstructionType type) {
 	if (type != kInstTypeInt)
 		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = _instruction->args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() + 1);
 }
@@ -909,17 +1144,15 @@ void NCSFile::o_jnz(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-
 	if (_stack.pop().getInt())
-		_script->seek(offset - 6, SEEK_CUR);
+		jump();
 }
 
 void NCSFile::o_decbp(InstructionType type) {
 	if (type != kInstTypeInt)
 		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = _instruction->args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() - 1);
 }
@@ -928,7 +1161,7 @@ void NCSFile::o_incbp(InstructionType type) {
 	if (type != kInstTypeInt)
 		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = _instruction->args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() + 1);
 }
@@ -956,8 +1189,8 @@ void NCSFile::o_cpdownsp(InstructionType type) {
 	if (type != kInstTypeDirect)
 		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = _instruction->args[0];
+	int16 size   = _instruction->args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal size %d", size);
@@ -976,8 +1209,8 @@ void NCSFile::o_cptopsp(InstructionType type) {
 	if (type != kInstTypeDirect)
 		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = _instruction->args[0];
+	int16 size   = _instruction->args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopsp(): Illegal size %d", size);
@@ -1241,28 +1474,27 @@ void NCSFile::o_jsr(InstructionType type) {
 	if (type != kInstTypeNone)
 		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE();
-
-	// Push the current script position
-	_returnOffsets.push(_script->pos());
+	// Push the instruction to return to
+	_returnOffsets.push(_pc);
 
-	_script->seek(offset - 6, SEEK_CUR);
+	jump();
 }
 
 void NCSFile::o_retn(InstructionType type) {
-	uint32 returnAddress = _script->size();
+	// Returning from the top level ends the script
+	uint32 returnAddress = _program->instructions.size();
 	if (!_returnOffsets.empty()) {
 		returnAddress = _returnOffsets.top();
 		_returnOffsets.pop();
 	}
 
-	_script->seek(returnAddress);
+	_pc = returnAddress;
 }
 
 void NCSFile::o_destruct(InstructionType type) {
-	int16 stackSize        = _script->readSint16BE();
-	int16 dontRemoveOffset = _script->readSint16BE();
-	int16 dontRemoveSize   = _script->readSint16BE();
+	int16 stackSize        = _instruction->args[0];
+	int16 dontRemoveOffset = _instruction->args[1];
+	int16 dontRemoveSize   = _instruction->args[2];
 
 	if ((stackSize % 4) != 0)
 		throw Common::Exception("NCSFile::o_destruct(): Illegal stack size %d", stackSize);
@@ -1293,8 +1525,8 @@ void NCSFile::o_cpdownbp(InstructionType type) {
 	if (type != kInstTypeDirect)
 		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = _instruction->args[0] - 4;
+	int16 size   = _instruction->args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal size %d", size);
@@ -1313,8 +1545,8 @@ void NCSFile::o_cptopbp(InstructionType type) {
 	if (type != kInstTypeDirect)
 		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = _instruction->args[0] - 4;
+	int16 size   = _instruction->args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopbp(): Illegal size %d", size);
@@ -1329,8 +1561,8 @@ void NCSFile::o_cptopbp(InstructionType type) {
 
 void NCSFile::o_storestate(InstructionType type) {
 	uint8  offset = (uint8) type;
-	uint32 sizeBP = _script->readUint32BE();
-	uint32 sizeSP = _script->readUint32BE();
+	uint32 sizeBP = _instruction->args[0];
+	uint32 sizeSP = _instruction->args[1];
 
 	if ((sizeBP % 4) != 0)
 		throw Common::Exception("NCSFile::o_storestate(): Illegal BP size %d", sizeBP);
@@ -1340,7 +1572,7 @@ void NCSFile::o_storestate(InstructionType type) {
 	_storedState.setType(kTypeScriptState);
 	ScriptState &state = _storedState.getScriptState();
 
-	state.offset = _script->pos() - 10 + offset;
+	state.offset = _instruction->address + offset;
 
 	sizeBP /= 4;
 	sizeSP /= 4;
@@ -32,8 +32,12 @@
 
 #include <vector>
 #include <stack>
+#include <map>
+
+#include "boost/shared_ptr.hpp"
 
 #include "common/types.h"
+#include "common/ustring.h"
 
 #include "aurora/types.h"
 #include "aurora/aurorafile.h"
@@ -42,7 +46,6 @@
 #include "aurora/nwscript/variable.h"
 
 namespace Common {
-	class UString;
 	class SeekableReadStream;
 }
 
@@ -84,13 +87,22 @@ private:
 
 #define DECLARE_OPCODE(x) void x(InstructionType type)
 
-/** An NCS, BioWare's NWN Compile Script. */
+/** An NCS, BioWare's NWN Compile Script.
+ *
+ *  The bytecode is decoded once into a list of instructions, with all
+ *  operands read and all jump targets resolved. Scripts loaded by name
+ *  are cached, so that running the same script again only needs a fresh
+ *  stack.
+ */
 class NCSFile : public AuroraBase {
 public:
 	NCSFile(Common::SeekableReadStream *ncs);
 	NCSFile(const Common::UString &ncs);
 	~NCSFile();
 
+	/** Forget all cached scripts, for example because the resources changed. */
+	static void clearCache();
+
 	const Common::UString &getName() const;
 
 	/** Run the current script, from start to finish. */
@@ -132,10 +144,48 @@ private:
 		kInstTypeFloatVector      = 60
 	};
 
+	/** A decoded instruction. */
+	struct Instruction {
+		uint32 address; ///< The offset of the instruction within the script.
+
+		uint8           opcode;
+		InstructionType type;
+
+		int32 args[3]; ///< The integer operands.
+
+		float           constFloat;  ///< The operand of a float constant.
+		Common::UString constString; ///< The operand of a string constant.
+
+		/** The index of the instruction a jump goes to. */
+		uint32 target;
+
+		Instruction();
+	};
+
+	/** A script, decoded into instructions. */
+	struct Program {
+		uint32 size; ///< The size of the script in bytes.
+
+		std::vector<Instruction> instructions;
+
+		/** Find the index of the instruction at this offset within the script. */
+		uint32 findInstruction(uint32 address) const;
+	};
+
+	typedef boost::shared_ptr<const Program> ProgramPtr;
+	typedef std::map<Common::UString, ProgramPtr> ProgramCache;
+
+	/** All scripts loaded by name so far. */
+	static ProgramCache _cache;
+
 	Common::UString _name;
 
 	NCSStack _stack;
-	Common::SeekableReadStream *_script;
+
+	ProgramPtr _program;
+
+	uint32 _pc; ///< The index of the next instruction to execute.
+	const Instruction *_instruction; ///< The instruction currently executing.
 
 	Variable _return;
 
@@ -155,7 +205,14 @@ private:
 	uint32 _opcodeListSize;
 	void setupOpcodes();
 
-	void load();
+	void load(Common::SeekableReadStream &ncs);
+
+	/** Decode all instructions of the script. */
+	static void decode(Common::SeekableReadStream &ncs, Program &program);
+	/** Read the operands of an instruction. */
+	static bool readOperands(Common::SeekableReadStream &ncs, Instruction &instruction);
+	/** Resolve the targets of all jumps. */
+	static void resolveJumps(Program &program);
 
 	/** Reset the script for another execution. */
 	void reset();
@@ -165,6 +222,9 @@ private:
 	/** Execute one script step. */
 	void executeStep();
 
+	/** Continue execution at the target of the current jump instruction. */
+	void jump();
+
 	void decompile(); // TODO
 
 	void callEngine(Aurora::NWScript::FunctionContext &ctx, uint32 function, uint8 argCount);
@@ -27,12 +27,15 @@
  *  The global resource manager for Aurora resources.
  */
 
+#include <algorithm>
+
 #include "boost/algorithm/string.hpp"
 
 #include "common/util.h"
 #include "common/stream.h"
 #include "common/filepath.h"
 #include "common/file.h"
+#include "common/threadpool.h"
 
 #include "aurora/resman.h"
 #include "aurora/util.h"
@@ -56,10 +59,32 @@ static const char *kArchiveGlob[Aurora::kArchiveMAX] = {
 	".*\\.key", ".*\\.bif", ".*\\.(erf|mod|hak|nwm)", ".*\\.rim", ".*\\.zip", ".*\\.exe"
 };
 
+/** Initial number of slots in the resource index. */
+static const uint32 kIndexInitialSize = 4096;
+/** Marker for an unused slot in the resource index. */
+static const uint32 kIndexEmpty       = 0xFFFFFFFF;
+
+/** Number of threads used to open and parse archive files. */
+static const uint kArchiveThreadCount = 4;
+
 namespace Aurora {
 
+static bool compareResourceID(const ResourceManager::ResourceID &a, const ResourceManager::ResourceID &b) {
+	if (a.name != b.name)
+		return a.name < b.name;
+
+	return a.type < b.type;
+}
+
+/** A resource to be dumped: its ID and the index of its family. */
+typedef std::pair<ResourceManager::ResourceID, uint32> DumpEntry;
+
+static bool compareDumpEntry(const DumpEntry &a, const DumpEntry &b) {
+	return compareResourceID(a.first, b.first);
+}
+
 ResourceManager::Resource::Resource() : type(kFileTypeNone), priority(0),
-		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF) {
+		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF), change(0) {
 }
 
 bool ResourceManager::Resource::operator<(const Resource &right) const {
@@ -82,7 +107,11 @@ ResourceManager::ChangeID::ChangeID(ChangeSetList::iterator c) : _empty(false),
 }
 
 
-ResourceManager::ResourceManager() : _rimsAreERFs(false) {
+ResourceManager::IndexSlot::IndexSlot() : hash(0), type(kFileTypeNone), family(kIndexEmpty) {
+}
+
+
+ResourceManager::ResourceManager() : _rimsAreERFs(false), _indexUsed(0) {
 	_resourceTypeTypes[kResourceImage].push_back(kFileTypeDDS);
 	_resourceTypeTypes[kResourceImage].push_back(kFileTypeTPC);
 	_resourceTypeTypes[kResourceImage].push_back(kFileTypeTXB);
@@ -137,7 +166,10 @@ void ResourceManager::clear() {
 		delete *archive;
 	_archives.clear();
 
-	_resources.clear();
+	_families.clear();
+
+	_index.clear();
+	_indexUsed = 0;
 
 	_typeAliases.clear();
 
@@ -247,39 +279,188 @@ ResourceManager::ChangeID ResourceManager::addArchive(ArchiveType archive,
 	if (archive == kArchiveKEY)
 		return indexKEY(realName, priority);
 
-	if (archive == kArchiveERF) {
-		ERFFile *erf = new ERFFile(realName);
+	if ((archive == kArchiveERF) || (archive == kArchiveRIM) || (archive == kArchiveZIP)) {
+		Archive *arch = openArchive(archive, realName);
 
 		ChangeID change = newChangeSet();
 
-		return indexArchive(erf, priority, change);
+		return indexArchive(arch, priority, change);
 	}
 
-	if (archive == kArchiveRIM) {
-		RIMFile *rim = new RIMFile(realName);
+	if (archive == kArchiveEXE) {
+		PEFile *pe = new PEFile(realName, _cursorRemap);
 
 		ChangeID change = newChangeSet();
 
-		return indexArchive(rim, priority, change);
+		return indexArchive(pe, priority, change);
 	}
 
-	if (archive == kArchiveZIP) {
-		ZIPFile *zip = new ZIPFile(realName);
+	return ChangeID();
+}
 
-		ChangeID change = newChangeSet();
+/** Return the index cache key of an archive file, or an empty string if it isn't cacheable. */
+static Common::UString getArchiveCacheKey(ArchiveType archive, const Common::UString &file) {
+	if (archive == kArchiveERF)
+		return "erf:" + file;
+	if (archive == kArchiveRIM)
+		return "rim:" + file;
+
+	return "";
+}
+
+/** Open and parse an archive file. Safe to be called from any thread. */
+static Archive *loadArchive(ArchiveType archive, const Common::UString &file) {
+	if (archive == kArchiveERF)
+		return new ERFFile(file);
+	if (archive == kArchiveRIM)
+		return new RIMFile(file);
+	if (archive == kArchiveZIP)
+		return new ZIPFile(file);
+
+	throw Common::Exception("Invalid archive type %d", (int) archive);
+}
+
+/** Opening and parsing an archive file in a worker thread. */
+class ArchiveLoadJob : public Common::ThreadPool::Job {
+public:
+	ArchiveType     type;
+	Common::UString file;
+
+	Archive *archive;
+	bool     cached; ///< Was the archive restored from the index cache?
 
-		return indexArchive(zip, priority, change);
+	bool              failed;
+	Common::Exception error;
+
+	ArchiveLoadJob() : type(kArchiveMAX), archive(0), cached(false), failed(false) {
 	}
 
-	if (archive == kArchiveEXE) {
-		PEFile *pe = new PEFile(realName, _cursorRemap);
+	void run() {
+		try {
+			archive = loadArchive(type, file);
+		} catch (Common::Exception &e) {
+			error  = e;
+			failed = true;
+		}
+	}
+};
 
-		ChangeID change = newChangeSet();
+/** Opening and parsing a BIF file, and merging in the KEY's information, in a worker thread. */
+class BIFLoadJob : public Common::ThreadPool::Job {
+public:
+	const KEYFile *key;
 
-		return indexArchive(pe, priority, change);
+	Common::UString file;
+	uint32          index;
+
+	BIFFile *bif;
+
+	bool              failed;
+	Common::Exception error;
+
+	BIFLoadJob() : key(0), index(0), bif(0), failed(false) {
 	}
 
-	return ChangeID();
+	void run() {
+		try {
+			bif = new BIFFile(file);
+
+			bif->mergeKEY(*key, index);
+		} catch (Common::Exception &e) {
+			delete bif;
+			bif = 0;
+
+			error  = e;
+			failed = true;
+		}
+	}
+};
+
+Archive *ResourceManager::openArchive(ArchiveType archive, const Common::UString &file) {
+	const Common::UString cacheKey = getArchiveCacheKey(archive, file);
+
+	Archive *arch = cacheKey.empty() ? 0 : getCachedArchive(cacheKey);
+	if (arch)
+		return arch;
+
+	arch = loadArchive(archive, file);
+	cacheLoadedArchive(archive, *arch, file);
+
+	return arch;
+}
+
+void ResourceManager::addArchives(ArchiveType archive, const std::vector<Common::UString> &files,
+		uint32 priority, std::vector<ChangeID> *changes) {
+
+	assert((archive >= 0) && (archive < kArchiveMAX));
+
+	// Only ERF, RIM and ZIP files can be loaded in parallel
+	if ((archive != kArchiveERF) && (archive != kArchiveRIM) && (archive != kArchiveZIP)) {
+		for (std::vector<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f) {
+			ChangeID change = addArchive(archive, *f, priority++);
+			if (changes)
+				changes->push_back(change);
+		}
+
+		return;
+	}
+
+	std::vector<ArchiveLoadJob> jobs;
+	jobs.resize(files.size());
+
+	// Find all archive files first, so that nothing is loaded if one is missing
+	for (uint32 i = 0; i < files.size(); i++) {
+		jobs[i].type = archive;
+		jobs[i].file = findArchive(files[i], _archiveDirs[archive], _archiveFiles[archive]);
+
+		if (jobs[i].file.empty())
+			throw Common::Exception("No such archive file \"%s\"", files[i].c_str());
+	}
+
+	// Load everything that's not in the index cache in parallel
+	{
+		Common::ThreadPool pool(MIN<uint>(kArchiveThreadCount, jobs.size()));
+
+		for (std::vector<ArchiveLoadJob>::iterator j = jobs.begin(); j != jobs.end(); ++j) {
+			const Common::UString cacheKey = getArchiveCacheKey(archive, j->file);
+
+			if (!cacheKey.empty() && (j->archive = getCachedArchive(cacheKey))) {
+				j->cached = true;
+				continue;
+			}
+
+			pool.add(*j);
+		}
+
+		pool.wait();
+	}
+
+	uint32 resourceCount = 0;
+	for (std::vector<ArchiveLoadJob>::const_iterator j = jobs.begin(); j != jobs.end(); ++j)
+		if (j->archive)
+			resourceCount += j->archive->getResources().size();
+
+	reserveIndex(resourceCount);
+
+	// Add the archives in order, stopping at the first failed one
+	for (std::vector<ArchiveLoadJob>::iterator j = jobs.begin(); j != jobs.end(); ++j) {
+		if (j->failed) {
+			for (std::vector<ArchiveLoadJob>::iterator k = j; k != jobs.end(); ++k)
+				delete k->archive;
+
+			j->error.add("Failed opening archive file \"%s\"", j->file.c_str());
+			throw j->error;
+		}
+
+		if (!j->cached)
+			cacheLoadedArchive(archive, *j->archive, j->file);
+
+		ChangeID change = newChangeSet();
+		indexArchive(j->archive, priority++, change);
+
+		if (changes)
+			changes->push_back(change);
+	}
 }
 
 void ResourceManager::findBIFs(const KEYFile &key, std::vector<Common::UString> &bifs) {
@@ -301,32 +482,58 @@ void ResourceManager::findBIFs(const KEYFile &key, std::vector<Common::UString>
 void ResourceManager::mergeKEYBIF(const KEYFile &key, std::vector<Common::UString> &bifs,
 		std::vector<BIFFile *> &bifFiles) {
 
-	bifFiles.reserve(bifs.size());
+	std::vector<BIFLoadJob> jobs;
+	jobs.resize(bifs.size());
 
-	BIFFile *curBIF = 0;
+	// Load all needed BIF files in parallel
+	{
+		Common::ThreadPool pool(MIN<uint>(kArchiveThreadCount, jobs.size()));
 
-	// Try to load all needed BIF files
-	try {
+		for (uint32 i = 0; i < jobs.size(); i++) {
+			jobs[i].key   = &key;
+			jobs[i].file  = bifs[i];
+			jobs[i].index = i;
 
-		uint32 index = 0;
-		for (std::vector<Common::UString>::const_iterator bif = bifs.begin(); bif != bifs.end(); ++index, ++bif) {
-			curBIF = new BIFFile(*bif);
+			pool.add(jobs[i]);
+		}
 
-			curBIF->mergeKEY(key, index);
+		pool.wait();
+	}
 
-			bifFiles.push_back(curBIF);
-		}
+	for (std::vector<BIFLoadJob>::iterator j = jobs.begin(); j != jobs.end(); ++j) {
+		if (!j->failed)
+			continue;
 
-	} catch (Common::Exception &e) {
-		delete curBIF;
+		for (std::vector<BIFLoadJob>::iterator k = jobs.begin(); k != jobs.end(); ++k)
+			delete k->bif;
 
-		e.add("Failed opening needed BIFs");
-		throw e;
+		j->error.add("Failed opening needed BIFs");
+		throw j->error;
 	}
 
+	bifFiles.reserve(jobs.size());
+	for (std::vector<BIFLoadJob>::const_iterator j = jobs.begin(); j != jobs.end(); ++j)
+		bifFiles.push_back(j->bif);
 }
 
 ResourceManager::ChangeID ResourceManager::indexKEY(const Common::UString &file, uint32 priority) {
+	const IndexCache::FileList *cached = useIndexCache() ? _indexCache.find("key:" + file) : 0;
+	if (cached) {
+		ChangeID change = newChangeSet();
+
+		uint32 resourceCount = 0;
+		for (IndexCache::FileList::const_iterator f = cached->begin(); f != cached->end(); ++f)
+			resourceCount += f->resources.size();
+
+		reserveIndex(resourceCount);
+
+		// The first cached file is the KEY itself, all others are its BIFs
+		for (IndexCache::FileList::const_iterator bif = ++cached->begin(); bif != cached->end(); ++bif)
+			indexArchive(new CachedArchive(*bif), priority, change);
+
+		return change;
+	}
+
 	KEYFile key(file);
 
 	// Search the correct BIFs
@@ -336,14 +543,107 @@ ResourceManager::ChangeID ResourceManager::indexKEY(const Common::UString &file,
 	std::vector<BIFFile *> bifFiles;
 	mergeKEYBIF(key, bifs, bifFiles);
 
+	if (useIndexCache()) {
+		IndexCache::FileList cacheFiles;
+
+		cacheFiles.resize(1 + bifFiles.size());
+
+		bool valid = IndexCache::stat(file, cacheFiles[0]);
+		for (uint32 i = 0; valid && (i < bifFiles.size()); i++)
+			valid = cacheArchiveFile(cacheFiles[i + 1], *bifFiles[i], bifs[i]);
+
+		if (valid)
+			_indexCache.add("key:" + file, cacheFiles);
+	}
+
+	uint32 resourceCount = 0;
+	for (std::vector<BIFFile *>::const_iterator bifFile = bifFiles.begin(); bifFile != bifFiles.end(); ++bifFile)
+		resourceCount += (*bifFile)->getResources().size();
+
+	reserveIndex(resourceCount);
+
 	ChangeID change = newChangeSet();
 
+	// Add all BIFs in one go, in the order the KEY lists them
 	for (std::vector<BIFFile *>::iterator bifFile = bifFiles.begin(); bifFile != bifFiles.end(); ++bifFile)
 		indexArchive(*bifFile, priority, change);
 
 	return change;
 }
 
+bool ResourceManager::useIndexCache() const {
+	return !_indexCacheFile.empty();
+}
+
+Archive *ResourceManager::getCachedArchive(const Common::UString &key) {
+	if (!useIndexCache())
+		return 0;
+
+	const IndexCache::FileList *cached = _indexCache.find(key);
+	if (!cached || (cached->size() != 1))
+		return 0;
+
+	return new CachedArchive(cached->front());
+}
+
+void ResourceManager::cacheLoadedArchive(ArchiveType type, const Archive &archive,
+		const Common::UString &file) {
+
+	if (type == kArchiveERF)
+		cacheArchive(getArchiveCacheKey(type, file), static_cast<const ERFFile &>(archive), file);
+	else if (type == kArchiveRIM)
+		cacheArchive(getArchiveCacheKey(type, file), static_cast<const RIMFile &>(archive), file);
+}
+
+template<class T>
+void ResourceManager::cacheArchive(const Common::UString &key, const T &archive,
+		const Common::UString &file) {
+
+	if (!useIndexCache())
+		return;
+
+	IndexCache::FileList cacheFiles;
+
+	cacheFiles.resize(1);
+	if (cacheArchiveFile(cacheFiles[0], archive, file))
+		_indexCache.add(key, cacheFiles);
+}
+
+template<class T>
+bool ResourceManager::cacheArchiveFile(IndexCache::File &cacheFile, const T &archive,
+		const Common::UString &file) {
+
+	if (!IndexCache::stat(file, cacheFile))
+		return false;
+
+	const Archive::ResourceList &resources = archive.getResources();
+
+	cacheFile.resources.reserve(resources.size());
+	for (Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r)
+		cacheFile.resources.push_back(IndexCache::Resource(r->name, r->type,
+				archive.getResourceOffset(r->index), archive.getResourceSize(r->index)));
+
+	return true;
+}
+
+void ResourceManager::setIndexCache(const Common::UString &file) {
+	_indexCacheFile = file;
+
+	_indexCache.load(_indexCacheFile);
+}
+
+void ResourceManager::saveIndexCache() {
+	if (!useIndexCache() || !_indexCache.changed())
+		return;
+
+	try {
+		_indexCache.save(_indexCacheFile);
+	} catch (Common::Exception &e) {
+		e.add("Failed writing index cache \"%s\"", _indexCacheFile.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+}
+
 ResourceManager::ChangeID ResourceManager::indexArchive(Archive *archive, uint32 priority, ChangeID &change) {
 	_archives.push_back(archive);
 
@@ -377,24 +677,50 @@ ResourceManager::ChangeID ResourceManager::addResourceDir(const Common::UString
 	if (directory.empty())
 		throw Common::Exception("No such directory \"%s\"", dir.c_str());
 
-	// Find files
-	Common::FileList files;
-	files.addDirectory(directory, depth);
-
 	ChangeID change = newChangeSet();
 
-	if (!glob) {
-		// Add the files
+	// The directory's modification time only covers its direct contents
+	const bool cacheable = useIndexCache() && (depth == 0);
+
+	const Common::UString cacheKey = "dir:" + directory + ":" + (glob ? glob : "");
+
+	const IndexCache::FileList *cached = cacheable ? _indexCache.find(cacheKey) : 0;
+	if (cached) {
+		std::list<Common::UString> files;
+
+		const IndexCache::ResourceList &cachedFiles = cached->front().resources;
+		for (IndexCache::ResourceList::const_iterator f = cachedFiles.begin(); f != cachedFiles.end(); ++f)
+			files.push_back(f->name);
+
 		addResources(files, change, priority);
 		return change;
 	}
 
-	// Find files matching the glob pattern
-	Common::FileList globFiles;
-	files.getSubList(glob, globFiles, true);
+	// Find files
+	Common::FileList dirFiles;
+	dirFiles.addDirectory(directory, depth);
+
+	std::list<Common::UString> files;
+	if (!glob)
+		dirFiles.getFileNames(files);
+	else
+		// Find files matching the glob pattern
+		dirFiles.getSubList(glob, files, true);
+
+	if (cacheable) {
+		IndexCache::FileList cacheFiles;
+
+		cacheFiles.resize(1);
+		if (IndexCache::stat(directory, cacheFiles[0])) {
+			for (std::list<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f)
+				cacheFiles[0].resources.push_back(IndexCache::Resource(*f));
+
+			_indexCache.add(cacheKey, cacheFiles);
+		}
+	}
 
 	// Add the files
-	addResources(globFiles, change, priority);
+	addResources(files, change, priority);
 	return change;
 }
 
@@ -403,20 +729,20 @@ void ResourceManager::undo(ChangeID &change) {
 		// Nothing to do
 		return;
 
-	// Go through all changes in the resource map
-	for (std::list<ResourceChange>::iterator resChange = change._change->resources.begin();
-	     resChange != change._change->resources.end(); ++resChange) {
+	// Go through all resource families this change touched
+	for (std::vector<uint32>::const_iterator f = change._change->families.begin();
+	     f != change._change->families.end(); ++f) {
 
-		// Remove the resource
-		resChange->typeIt->second.erase(resChange->resIt);
+		ResourceList &resources = _families[*f].resources;
 
-		// If the resource list is empty, remove that one too
-		if (resChange->typeIt->second.empty())
-			resChange->nameIt->second.erase(resChange->typeIt);
+		// Remove all resources added by this change, keeping the others in priority order.
+		// The (now possibly empty) family stays in the index, to be reused later.
+		ResourceList::iterator res = resources.begin();
+		for (ResourceList::iterator r = resources.begin(); r != resources.end(); ++r)
+			if (r->change != &*change._change)
+				*res++ = *r;
 
-		// And if the type map is empty too, remove that one as well
-		if (resChange->nameIt->second.empty())
-			_resources.erase(resChange->nameIt);
+		resources.erase(res, resources.end());
 	}
 
 	// Removing all changes in the archive list
@@ -528,32 +854,57 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 	return 0;
 }
 
+void ResourceManager::getAvailableResources(std::list<ResourceID> &list) const {
+	std::list<ResourceID> found;
+
+	for (ResourceFamilyList::const_iterator f = _families.begin(); f != _families.end(); ++f) {
+		if (f->resources.empty())
+			continue;
+
+		found.push_back(ResourceID());
+
+		found.back().name = f->name;
+		found.back().type = f->type;
+	}
+
+	// Keep the list ordered by name
+	found.sort(compareResourceID);
+
+	list.splice(list.end(), found);
+}
+
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r)
-		for (ResourceTypeMap::const_iterator rt = r->second.begin(); rt != r->second.end(); ++rt)
-			if (rt->first == type) {
-				list.push_back(ResourceID());
+	std::vector<FileType> types;
 
-				list.back().name = r->first;
-				list.back().type = rt->first;
-			}
+	types.push_back(type);
 
+	getAvailableResources(types, list);
 }
 
 void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r)
-		for (ResourceTypeMap::const_iterator rt = r->second.begin(); rt != r->second.end(); ++rt)
-			for (std::vector<FileType>::const_iterator wt = types.begin(); wt != types.end(); ++wt)
-				if (rt->first == *wt) {
-					list.push_back(ResourceID());
+	std::list<ResourceID> found;
+
+	for (ResourceFamilyList::const_iterator f = _families.begin(); f != _families.end(); ++f) {
+		if (f->resources.empty())
+			continue;
 
-					list.back().name = r->first;
-					list.back().type = rt->first;
-				}
+		for (std::vector<FileType>::const_iterator wt = types.begin(); wt != types.end(); ++wt)
+			if (f->type == *wt) {
+				found.push_back(ResourceID());
+
+				found.back().name = f->name;
+				found.back().type = f->type;
+			}
+	}
+
+	// Keep the list ordered by name
+	found.sort(compareResourceID);
+
+	list.splice(list.end(), found);
 }
 
 void ResourceManager::getAvailableResources(ResourceType type,
@@ -582,68 +933,130 @@ void ResourceManager::addResource(Resource &resource, Common::UString name, Chan
 	if (alias != _typeAliases.end())
 		resource.type = alias->second;
 
-	ResourceMap::iterator resTypeMap = _resources.find(name);
-	if (resTypeMap == _resources.end()) {
-		// We don't yet have a resource with this name, create a new type map for it
+	const uint32 hash = hashName(name);
+
+	uint32 family = findFamily(name, hash, resource.type);
+	if (family == kIndexEmpty)
+		// We don't yet have a resource with that name and type, create a new family for it
+		family = addFamily(name, hash, resource.type);
+
+	resource.change = &*change._change;
 
-		std::pair<ResourceMap::iterator, bool> result;
+	// Insert the resource after all others with a lower or the same priority.
+	// That way, the last resource in the list is always the one to be used.
+	ResourceList &resources = _families[family].resources;
+	resources.insert(std::upper_bound(resources.begin(), resources.end(), resource), resource);
 
-		result = _resources.insert(std::make_pair(name, ResourceTypeMap()));
+	// Remember the resource family in the change set
+	change._change->families.push_back(family);
+}
+
+void ResourceManager::addResources(const std::list<Common::UString> &files,
+		ChangeID &change, uint32 priority) {
+
+	for (std::list<Common::UString>::const_iterator file = files.begin(); file != files.end(); ++file) {
+		Resource res;
+		res.priority = priority;
+		res.source   = kSourceFile;
+		res.path     = *file;
+		res.type     = getFileType(*file);
 
-		resTypeMap = result.first;
+		addResource(res, Common::FilePath::getStem(*file), change);
 	}
+}
 
-	ResourceTypeMap::iterator resList = resTypeMap->second.find(resource.type);
-	if (resList == resTypeMap->second.end()) {
-		// We don't yet have a resource with that name and type, create a new resource list for it
+uint32 ResourceManager::hashName(const Common::UString &name) {
+	return Common::hashUStringCaseInsensitive()(name);
+}
+
+/** Find the index slot a resource name and type hash into. */
+static inline uint32 getIndexSlot(uint32 hash, FileType type, uint32 mask) {
+	return (hash ^ ((uint32) type * 0x9E3779B1)) & mask;
+}
 
-		std::pair<ResourceTypeMap::iterator, bool> result;
+uint32 ResourceManager::findFamily(const Common::UString &name, uint32 hash, FileType type) const {
+	if (_index.empty())
+		return kIndexEmpty;
 
-		result = resTypeMap->second.insert(std::make_pair(resource.type, ResourceList()));
+	const uint32 mask = _index.size() - 1;
 
-		resList = result.first;
+	// Linear probing until we hit an empty slot
+	for (uint32 slot = getIndexSlot(hash, type, mask); ; slot = (slot + 1) & mask) {
+		const IndexSlot &s = _index[slot];
+		if (s.family == kIndexEmpty)
+			return kIndexEmpty;
+
+		if ((s.hash == hash) && (s.type == type) && _families[s.family].name.equalsIgnoreCase(name))
+			return s.family;
 	}
+}
+
+uint32 ResourceManager::addFamily(const Common::UString &name, uint32 hash, FileType type) {
+	// Keep the index at most 3/4 full, doubling its size (keeping it a power of two)
+	if (((_indexUsed + 1) * 4) > (_index.size() * 3))
+		resizeIndex(_index.empty() ? kIndexInitialSize : (_index.size() * 2));
 
-	// Add the resource to the list
-	resList->second.push_back(resource);
+	_families.push_back(ResourceFamily());
 
-	// And sort the list by priority
-	resList->second.sort();
+	ResourceFamily &family = _families.back();
+	family.name = name;
+	family.type = type;
+	family.hash = hash;
 
-	// Remember the resource in the change set
-	change._change->resources.push_back(ResourceChange());
-	change._change->resources.back().nameIt = resTypeMap;
-	change._change->resources.back().typeIt = resList;
-	change._change->resources.back().resIt  = --resList->second.end();
+	insertIndex(_families.size() - 1);
+
+	return _families.size() - 1;
 }
 
-void ResourceManager::addResources(const Common::FileList &files, ChangeID &change, uint32 priority) {
-	for (Common::FileList::const_iterator file = files.begin(); file != files.end(); ++file) {
-		Resource res;
-		res.priority = priority;
-		res.source   = kSourceFile;
-		res.path     = *file;
-		res.type     = getFileType(*file);
+void ResourceManager::insertIndex(uint32 family) {
+	const ResourceFamily &f = _families[family];
 
-		addResource(res, Common::FilePath::getStem(*file), change);
-	}
+	const uint32 mask = _index.size() - 1;
+
+	uint32 slot = getIndexSlot(f.hash, f.type, mask);
+	while (_index[slot].family != kIndexEmpty)
+		slot = (slot + 1) & mask;
+
+	_index[slot].hash   = f.hash;
+	_index[slot].type   = f.type;
+	_index[slot].family = family;
+
+	_indexUsed++;
 }
 
-const ResourceManager::Resource *ResourceManager::getRes(Common::UString name,
-		const std::vector<FileType> &types) const {
+void ResourceManager::resizeIndex(uint32 size) {
+	_index.clear();
+	_index.resize(size);
 
-	name.tolower();
+	_indexUsed = 0;
 
-	// Find the resources with the same name
-	ResourceMap::const_iterator resFamily = _resources.find(name);
-	if (resFamily == _resources.end())
-		return 0;
+	for (uint32 i = 0; i < _families.size(); i++)
+		insertIndex(i);
+}
+
+void ResourceManager::reserveIndex(uint32 count) {
+	// Make room for up to count new families, so that adding a whole batch
+	// of archives resizes the index at most once
+	uint32 size = _index.empty() ? kIndexInitialSize : _index.size();
+	while (((_indexUsed + count) * 4) > (size * 3))
+		size *= 2;
+
+	_families.reserve(_families.size() + count);
+
+	if (size != _index.size())
+		resizeIndex(size);
+}
+
+const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
+		const std::vector<FileType> &types) const {
+
+	const uint32 hash = hashName(name);
 
 	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
 		// Find the specific resource of the given type
-		ResourceTypeMap::const_iterator res = resFamily->second.find(*type);
-		if ((res != resFamily->second.end()) && !res->second.empty())
-			return &res->second.back();
+		uint32 family = findFamily(name, hash, *type);
+		if ((family != kIndexEmpty) && !_families[family].resources.empty())
+			return &_families[family].resources.back();
 	}
 
 	return 0;
@@ -658,22 +1071,33 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.writeString("                Name                 |     Size    \n");
 	file.writeString("-------------------------------------|-------------\n");
 
-	for (ResourceMap::const_iterator itName = _resources.begin(); itName != _resources.end(); ++itName) {
-		for (ResourceTypeMap::const_iterator itType = itName->second.begin(); itType != itName->second.end(); ++itType) {
-			if (itType->second.empty())
-				continue;
+	// Sort the resources by name and type, remembering which family each one is
+	std::vector<DumpEntry> resources;
+	resources.reserve(_families.size());
 
-			const Resource &resource = itType->second.back();
+	for (uint32 f = 0; f < _families.size(); f++) {
+		if (_families[f].resources.empty())
+			continue;
 
-			const Common::UString &name = itName->first;
-			const Common::UString  ext  = setFileType("", resource.type);
-			const uint32           size = getResourceSize(resource);
+		resources.push_back(DumpEntry(ResourceID(), f));
 
-			const Common::UString line =
-				Common::UString::sprintf("%32s%4s | %12d\n", name.c_str(), ext.c_str(), size);
+		resources.back().first.name = _families[f].name;
+		resources.back().first.type = _families[f].type;
+	}
 
-			file.writeString(line);
-		}
+	std::sort(resources.begin(), resources.end(), compareDumpEntry);
+
+	for (std::vector<DumpEntry>::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		const Resource &resource = _families[r->second].resources.back();
+
+		const Common::UString &name = r->first.name;
+		const Common::UString  ext  = setFileType("", resource.type);
+		const uint32           size = getResourceSize(resource);
+
+		const Common::UString line =
+			Common::UString::sprintf("%32s%4s | %12d\n", name.c_str(), ext.c_str(), size);
+
+		file.writeString(line);
 	}
 
 	file.flush();
@@ -41,6 +41,7 @@
 #include "common/filelist.h"
 
 #include "aurora/types.h"
+#include "aurora/indexcache.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -71,6 +72,8 @@ private:
 		kSourceFile     ///< A direct file.
 	};
 
+	struct ChangeSet;
+
 	/** A resource. */
 	struct Resource {
 		FileType type; ///< The resource's type.
@@ -86,29 +89,47 @@ private:
 		// For kSourceFile
 		Common::UString path; ///< The file's path.
 
+		const ChangeSet *change; ///< The change set that added this resource.
+
 		Resource();
 
 		bool operator<(const Resource &right) const;
 	};
 
 	/** List of resources, sorted by priority. */
-	typedef std::list<Resource> ResourceList;
-	/** Map over resources with the same name but different type. */
-	typedef std::map<FileType, ResourceList> ResourceTypeMap;
-	/** Map over resources, indexed by name. */
-	typedef std::map<Common::UString, ResourceTypeMap> ResourceMap;
-
-	/** A change produced by a manager operation. */
-	struct ResourceChange {
-		ResourceMap::iterator     nameIt;
-		ResourceTypeMap::iterator typeIt;
-		ResourceList::iterator    resIt;
+	typedef std::vector<Resource> ResourceList;
+
+	/** All resources with the same name and type. */
+	struct ResourceFamily {
+		Common::UString name; ///< The resource's name, lowercased.
+		FileType        type; ///< The resource's type.
+		uint32          hash; ///< Case-insensitive hash of the resource's name.
+
+		/** All resources with that name and type, sorted by priority.
+		 *
+		 *  The last one is the one that's actually used.
+		 */
+		ResourceList resources;
+	};
+
+	/** List of all resource families, the index points into this. */
+	typedef std::vector<ResourceFamily> ResourceFamilyList;
+
+	/** A slot in the open-addressing resource index. */
+	struct IndexSlot {
+		uint32   hash;   ///< Case-insensitive hash of the resource's name.
+		FileType type;   ///< The resource's type.
+		uint32   family; ///< Index into the resource family list.
+
+		IndexSlot();
 	};
 
+	typedef std::vector<IndexSlot> ResourceIndex;
+
 	/** A set of changes produced by a manager operation. */
 	struct ChangeSet {
 		std::list<ArchiveList::iterator> archives;
-		std::list<ResourceChange>        resources;
+		std::vector<uint32>              families; ///< Families this change added resources to.
 	};
 
 	typedef std::list<ChangeSet> ChangeSetList;
@@ -182,6 +203,21 @@ public:
 	 */
 	ChangeID addArchive(ArchiveType archive, const Common::UString &file, uint32 priority = 0);
 
+	/** Add several archive files and all their resources to the resource manager.
+	 *
+	 *  The archive files are opened and parsed in parallel, but their resources
+	 *  are added in order, exactly as if addArchive() was called for each file.
+	 *
+	 *  @param  archive The type of archives to add.
+	 *  @param  files The names of the archive files to index.
+	 *  @param  priority The priority of the first archive file. Every following
+	 *          file has a priority one higher than the one before.
+	 *  @param  changes If not 0, an ID for the changes of each archive file is
+	 *          appended to this list.
+	 */
+	void addArchives(ArchiveType archive, const std::vector<Common::UString> &files,
+	                 uint32 priority = 0, std::vector<ChangeID> *changes = 0);
+
 	/** Add a directory's contents to the resource manager.
 	 *
 	 *  Relative to the base directory.
@@ -197,6 +233,18 @@ public:
 	ChangeID addResourceDir(const Common::UString &dir, const char *glob = 0,
 	                        int depth = -1, uint32 priority = 100);
 
+	/** Use a persistent cache for the indices of archives and directories.
+	 *
+	 *  Archives and directories found in the cache are indexed directly out
+	 *  of the cache, as long as their files haven't changed.
+	 *
+	 *  @param file The file containing the cache.
+	 */
+	void setIndexCache(const Common::UString &file);
+
+	/** Write any changes to the index cache back into its file. */
+	void saveIndexCache();
+
 	/** Undo the changes done in the specified change ID. */
 	void undo(ChangeID &change);
 
@@ -254,6 +302,8 @@ public:
 	Common::SeekableReadStream *getResource(ResourceType resType,
 			const Common::UString &name, FileType *foundType = 0) const;
 
+	/** Return a list of all available resources. */
+	void getAvailableResources(std::list<ResourceID> &list) const;
 	/** Return a list of all available resources of the specified type. */
 	void getAvailableResources(FileType type, std::list<ResourceID> &list) const;
 	/** Return a list of all available resources of the specified type. */
@@ -278,10 +328,16 @@ private:
 
 	std::map<FileType, FileType> _typeAliases;
 
-	ResourceMap _resources;
+	ResourceFamilyList _families; ///< All resources, grouped by name and type.
+
+	ResourceIndex _index;     ///< Hash index over the resource families.
+	uint32        _indexUsed; ///< Number of used slots in the index.
 
 	ChangeSetList _changes;
 
+	Common::UString _indexCacheFile; ///< The file holding the index cache.
+	IndexCache      _indexCache;     ///< The index cache.
+
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
 	Common::UString findArchive(const Common::UString &file,
@@ -290,14 +346,33 @@ private:
 	ChangeID indexKEY(const Common::UString &file, uint32 priority);
 	ChangeID indexArchive(Archive *archive, uint32 priority, ChangeID &change);
 
+	Archive *openArchive(ArchiveType archive, const Common::UString &file);
+
+	// Index cache helpers
+	bool useIndexCache() const;
+
+	Archive *getCachedArchive(const Common::UString &key);
+	void cacheLoadedArchive(ArchiveType type, const Archive &archive, const Common::UString &file);
+	template<class T> void cacheArchive(const Common::UString &key, const T &archive, const Common::UString &file);
+	template<class T> static bool cacheArchiveFile(IndexCache::File &cacheFile, const T &archive, const Common::UString &file);
+
 	// KEY/BIF loading helpers
 	void findBIFs   (const KEYFile &key, std::vector<Common::UString> &bifs);
 	void mergeKEYBIF(const KEYFile &key, std::vector<Common::UString> &bifs, std::vector<BIFFile *> &bifFiles);
 
 	void addResource(Resource &resource, Common::UString name, ChangeID &change);
-	void addResources(const Common::FileList &files, ChangeID &change, uint32 priority);
+	void addResources(const std::list<Common::UString> &files, ChangeID &change, uint32 priority);
+
+	// Resource index helpers
+	static uint32 hashName(const Common::UString &name);
+
+	uint32 findFamily(const Common::UString &name, uint32 hash, FileType type) const;
+	uint32 addFamily(const Common::UString &name, uint32 hash, FileType type);
+	void   insertIndex(uint32 family);
+	void   resizeIndex(uint32 size);
+	void   reserveIndex(uint32 count);
 
-	const Resource *getRes(Common::UString name, const std::vector<FileType> &types) const;
+	const Resource *getRes(const Common::UString &name, const std::vector<FileType> &types) const;
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res) const;
 
@@ -83,6 +83,8 @@ void RIMFile::load() {
 		throw e;
 	}
 
+	// If possible, map the RIM, so getResource() doesn't need to copy
+	_mappedFile.open(_fileName);
 }
 
 void RIMFile::readResList(Common::SeekableReadStream &rim, uint32 offset) {
@@ -117,11 +119,18 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+uint32 RIMFile::getResourceOffset(uint32 index) const {
+	return getIResource(index).offset;
+}
+
 Common::SeekableReadStream *RIMFile::getResource(uint32 index) const {
 	const IResource &res = getIResource(index);
 	if (res.size == 0)
 		return new Common::MemoryReadStream(0, 0);
 
+	if (_mappedFile.isOpen())
+		return _mappedFile.createReadStream(res.offset, res.size);
+
 	Common::File rim;
 	open(rim);
 
@@ -42,7 +42,6 @@
 
 namespace Common {
 	class SeekableReadStream;
-	class File;
 }
 
 namespace Aurora {
@@ -62,6 +61,9 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Return the offset of a resource within the RIM file. */
+	uint32 getResourceOffset(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index) const;
 
@@ -83,6 +85,9 @@ private:
 	/** The name of the RIM file. */
 	Common::UString _fileName;
 
+	/** The RIM file mapped into memory, if possible. */
+	Common::MappedFile _mappedFile;
+
 	void open(Common::File &file) const;
 
 	void load();
@@ -0,0 +1,264 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+/** @file bench/gff.cpp
+ *  Benchmark of loading and reading area and creature GFFs.
+ *
+ *  Loads the given .git, .are, .utc and .bic files a number of times, and
+ *  reads the fields the NWN engine reads when it loads areas and creatures.
+ *  Times are summed up per file type.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/util.h"
+#include "common/error.h"
+#include "common/ustring.h"
+#include "common/stream.h"
+#include "common/file.h"
+
+#include "aurora/types.h"
+#include "aurora/util.h"
+#include "aurora/locstring.h"
+#include "aurora/gfffile.h"
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/** Read the fields of all structs in a list. */
+typedef uint32 (*ReadFunc)(const Aurora::GFFStruct &strct);
+
+static uint32 readList(const Aurora::GFFStruct &strct, const char *list, ReadFunc readFunc) {
+	if (!strct.hasField(list))
+		return 0;
+
+	uint32 checksum = 0;
+
+	const Aurora::GFFList &structs = strct.getList(list);
+	for (Aurora::GFFList::const_iterator s = structs.begin(); s != structs.end(); ++s)
+		checksum += (*readFunc)(**s);
+
+	return checksum;
+}
+
+static uint32 readInstance(const Aurora::GFFStruct &instance) {
+	uint32 checksum = 0;
+
+	checksum += instance.getString("TemplateResRef").size();
+	checksum += instance.getString("Tag").size();
+
+	checksum += (uint32) instance.getDouble("XPosition");
+	checksum += (uint32) instance.getDouble("YPosition");
+	checksum += (uint32) instance.getDouble("ZPosition");
+	checksum += (uint32) instance.getDouble("XOrientation");
+	checksum += (uint32) instance.getDouble("YOrientation");
+
+	return checksum;
+}
+
+static uint32 readGIT(const Aurora::GFFStruct &git) {
+	uint32 checksum = 0;
+
+	checksum += readList(git, "Creature List" , &readInstance);
+	checksum += readList(git, "Door List"     , &readInstance);
+	checksum += readList(git, "Placeable List", &readInstance);
+	checksum += readList(git, "WaypointList"  , &readInstance);
+	checksum += readList(git, "SoundList"     , &readInstance);
+	checksum += readList(git, "TriggerList"   , &readInstance);
+	checksum += readList(git, "StoreList"     , &readInstance);
+	checksum += readList(git, "Encounter List", &readInstance);
+
+	return checksum;
+}
+
+static uint32 readTile(const Aurora::GFFStruct &tile) {
+	return tile.getUint("Tile_ID") + tile.getUint("Tile_Orientation") + tile.getUint("Tile_Height");
+}
+
+static uint32 readARE(const Aurora::GFFStruct &are) {
+	uint32 checksum = 0;
+
+	Aurora::LocString name;
+	are.getLocString("Name", name);
+
+	checksum += are.getString("Tag").size();
+	checksum += are.getString("Tileset").size();
+	checksum += are.getUint("Width") + are.getUint("Height");
+
+	checksum += readList(are, "Tile_List", &readTile);
+
+	return checksum;
+}
+
+static uint32 readClass(const Aurora::GFFStruct &cClass) {
+	return cClass.getUint("Class") + cClass.getUint("ClassLevel");
+}
+
+static uint32 readFeat(const Aurora::GFFStruct &feat) {
+	return feat.getUint("Feat");
+}
+
+static uint32 readSkill(const Aurora::GFFStruct &skill) {
+	return (uint32) skill.getSint("Rank");
+}
+
+static uint32 readCreature(const Aurora::GFFStruct &creature) {
+	uint32 checksum = 0;
+
+	Aurora::LocString firstName, lastName, description;
+	creature.getLocString("FirstName"  , firstName);
+	creature.getLocString("LastName"   , lastName);
+	creature.getLocString("Description", description);
+
+	checksum += creature.getString("Tag").size();
+	checksum += creature.getString("Conversation").size();
+	checksum += creature.getString("Deity").size();
+	checksum += creature.getString("Subrace").size();
+
+	checksum += creature.getUint("Str") + creature.getUint("Dex") + creature.getUint("Con");
+	checksum += creature.getUint("Int") + creature.getUint("Wis") + creature.getUint("Cha");
+
+	checksum += creature.getUint("Appearance_Type") + creature.getUint("Gender");
+	checksum += creature.getUint("Race") + creature.getUint("GoodEvil") + creature.getUint("LawfulChaotic");
+
+	checksum += (uint32) creature.getSint("HitPoints");
+	checksum += (uint32) creature.getSint("CurrentHitPoints");
+	checksum += (uint32) creature.getSint("MaxHitPoints");
+
+	checksum += readList(creature, "ClassList", &readClass);
+	checksum += readList(creature, "FeatList" , &readFeat);
+	checksum += readList(creature, "SkillList", &readSkill);
+
+	return checksum;
+}
+
+struct GFFType {
+	Aurora::FileType type;
+	uint32 id;
+
+	ReadFunc read;
+
+	uint32 fileCount;
+	uint32 size;
+
+	double loadTime;
+	double readTime;
+};
+
+static GFFType kGFFTypes[] = {
+	{ Aurora::kFileTypeGIT, MKID_BE('GIT '), &readGIT     , 0, 0, 0.0, 0.0 },
+	{ Aurora::kFileTypeARE, MKID_BE('ARE '), &readARE     , 0, 0, 0.0, 0.0 },
+	{ Aurora::kFileTypeUTC, MKID_BE('UTC '), &readCreature, 0, 0, 0.0, 0.0 },
+	{ Aurora::kFileTypeBIC, MKID_BE('BIC '), &readCreature, 0, 0, 0.0, 0.0 }
+};
+
+static GFFType *findGFFType(Aurora::FileType type) {
+	for (int i = 0; i < ARRAYSIZE(kGFFTypes); i++)
+		if (kGFFTypes[i].type == type)
+			return &kGFFTypes[i];
+
+	return 0;
+}
+
+static void readFile(const Common::UString &fileName, std::vector<byte> &data) {
+	Common::File file;
+	if (!file.open(fileName))
+		throw Common::Exception(Common::kOpenError);
+
+	data.resize(file.size());
+	if (data.empty() || (file.read(&data[0], data.size()) != data.size()))
+		throw Common::Exception(Common::kReadError);
+}
+
+static void benchGFF(const Common::UString &fileName, int passes) {
+	GFFType *type = findGFFType(Aurora::getFileType(fileName));
+	if (!type)
+		throw Common::Exception("Not a .git, .are, .utc or .bic file");
+
+	std::vector<byte> data;
+	readFile(fileName, data);
+
+	type->fileCount++;
+	type->size += data.size();
+
+	uint32 checksum = 0;
+
+	for (int i = 0; i < passes; i++) {
+		std::clock_t start = std::clock();
+
+		Aurora::GFFFile gff(new Common::MemoryReadStream(&data[0], data.size()), type->id);
+
+		type->loadTime += getMilliseconds(start);
+
+		start = std::clock();
+
+		checksum += (*type->read)(gff.getTopLevel());
+
+		type->readTime += getMilliseconds(start);
+	}
+
+	// Make sure the reads can't be optimized away
+	if (checksum == 0xFFFFFFFF)
+		std::printf("%s\n", fileName.c_str());
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		std::printf("Usage: %s <passes> <GFF file> [<GFF file> [...]]\n", argv[0]);
+		return 1;
+	}
+
+	const int passes = MAX(std::atoi(argv[1]), 1);
+
+	for (int i = 2; i < argc; i++) {
+		try {
+			benchGFF(argv[i], passes);
+		} catch (Common::Exception &e) {
+			e.add("Failed benchmarking \"%s\"", argv[i]);
+
+			Common::printException(e);
+			return 1;
+		}
+	}
+
+	for (int i = 0; i < ARRAYSIZE(kGFFTypes); i++) {
+		const GFFType &type = kGFFTypes[i];
+		if (type.fileCount == 0)
+			continue;
+
+		const double loads = ((double) passes) * type.fileCount;
+
+		std::printf("%-4s: %4u files, %8u bytes: load %.3fms, read %.3fms per file\n",
+		            Aurora::setFileType("", type.type).c_str() + 1, type.fileCount, type.size,
+		            type.loadTime / loads, type.readTime / loads);
+	}
+
+	return 0;
+}
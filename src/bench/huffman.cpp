@@ -0,0 +1,296 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+/** @file bench/huffman.cpp
+ *  Benchmark of Huffman decoding.
+ *
+ *  Builds Huffman codes for a few symbol distributions, encodes random
+ *  symbols with them, both MSB and LSB first, and decodes them again with
+ *  Common::Huffman and with a plain bit by bit search through the codes,
+ *  like the decoder used to do. Both have to get back the original symbols.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+
+#include "common/types.h"
+#include "common/util.h"
+#include "common/error.h"
+#include "common/bitstream.h"
+#include "common/huffman.h"
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/** A set of Huffman codes, with the probability of each symbol. */
+struct Codes {
+	std::vector<uint32> weights;
+	std::vector<uint8>  lengths;
+	std::vector<uint32> codes;
+	uint8 maxLength;
+
+	/** The indices of the codes of each length, for the bit by bit search. */
+	std::vector< std::vector<uint32> > byLength;
+};
+
+/** Find the code lengths of an optimal Huffman code for these weights. */
+static void buildLengths(Codes &codes) {
+	typedef std::pair<uint64, uint32> Node; // Weight, node index
+
+	const uint32 count = codes.weights.size();
+
+	std::vector<uint32> parents(2 * count, 0);
+	std::priority_queue<Node, std::vector<Node>, std::greater<Node> > queue;
+
+	for (uint32 i = 0; i < count; i++)
+		queue.push(Node(codes.weights[i], i));
+
+	uint32 next = count;
+	while (queue.size() > 1) {
+		const Node a = queue.top();
+		queue.pop();
+		const Node b = queue.top();
+		queue.pop();
+
+		parents[a.second] = next;
+		parents[b.second] = next;
+
+		queue.push(Node(a.first + b.first, next++));
+	}
+
+	const uint32 root = next - 1;
+
+	codes.lengths.resize(count);
+	codes.maxLength = 0;
+
+	for (uint32 i = 0; i < count; i++) {
+		uint8 length = 0;
+		for (uint32 n = i; n != root; n = parents[n])
+			length++;
+
+		codes.lengths[i] = length;
+		codes.maxLength  = MAX(codes.maxLength, length);
+	}
+}
+
+/** Assign canonical codes to the code lengths. */
+static void buildCodes(Codes &codes) {
+	const uint32 count = codes.lengths.size();
+
+	codes.codes.resize(count);
+
+	uint32 code = 0;
+	for (uint8 length = 1; length <= codes.maxLength; length++) {
+		for (uint32 i = 0; i < count; i++)
+			if (codes.lengths[i] == length)
+				codes.codes[i] = code++;
+
+		code <<= 1;
+	}
+}
+
+/** Mirror each code, so that it stays free of prefixes when read LSB first. */
+static void reverseCodes(Codes &codes) {
+	for (uint32 i = 0; i < codes.codes.size(); i++) {
+		uint32 reversed = 0;
+		for (uint8 j = 0; j < codes.lengths[i]; j++)
+			reversed |= ((codes.codes[i] >> j) & 1) << (codes.lengths[i] - 1 - j);
+
+		codes.codes[i] = reversed;
+	}
+}
+
+static void sortByLength(Codes &codes) {
+	codes.byLength.clear();
+	codes.byLength.resize(codes.maxLength + 1);
+
+	for (uint32 i = 0; i < codes.codes.size(); i++)
+		codes.byLength[codes.lengths[i]].push_back(i);
+}
+
+/** Codes for symbols with the probabilities weight[i] / sum(weight). */
+static void buildCodes(Codes &codes, const std::vector<uint32> &weights) {
+	codes.weights = weights;
+
+	buildLengths(codes);
+	buildCodes(codes);
+	sortByLength(codes);
+}
+
+/** Draw random symbols with the codes' probabilities. */
+static void drawSymbols(const Codes &codes, uint32 count, std::vector<uint32> &symbols) {
+	std::vector<uint32> cumulative;
+
+	uint32 sum = 0;
+	for (std::vector<uint32>::const_iterator w = codes.weights.begin(); w != codes.weights.end(); ++w)
+		cumulative.push_back(sum += *w);
+
+	symbols.resize(count);
+	for (uint32 i = 0; i < count; i++) {
+		const uint32 r = ((((uint32) std::rand()) << 15) ^ ((uint32) std::rand())) % sum;
+
+		symbols[i] = std::upper_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin();
+	}
+}
+
+/** Write the symbols' codes into a bit stream, 8 bits per byte. */
+static void encode(const Codes &codes, const std::vector<uint32> &symbols, bool msbFirst,
+                   std::vector<byte> &data) {
+
+	data.clear();
+	uint32 bit = 0;
+
+	for (std::vector<uint32>::const_iterator s = symbols.begin(); s != symbols.end(); ++s) {
+		const uint32 code   = codes.codes[*s];
+		const uint8  length = codes.lengths[*s];
+
+		for (uint8 i = 0; i < length; i++, bit++) {
+			// MSB first, the code is read starting with its highest bit, else with its lowest
+			const uint32 value = (code >> (msbFirst ? (length - 1 - i) : i)) & 1;
+
+			if ((bit & 7) == 0)
+				data.push_back(0);
+
+			if (value)
+				data.back() |= msbFirst ? (0x80 >> (bit & 7)) : (1 << (bit & 7));
+		}
+	}
+
+	// Padding, so that the bit stream can always look ahead a full code
+	data.resize(data.size() + 8, 0);
+}
+
+/** Decode a symbol by reading one bit after the other and searching for a matching code. */
+static uint32 getSymbolLinear(const Codes &codes, Common::BitStream &bits) {
+	uint32 code = 0;
+
+	for (uint8 length = 1; length <= codes.maxLength; length++) {
+		bits.addBit(code, length - 1);
+
+		const std::vector<uint32> &indices = codes.byLength[length];
+		for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+			if (codes.codes[*i] == code)
+				return *i;
+	}
+
+	throw Common::Exception("Unknown Huffman code");
+}
+
+template<class BitStreamType>
+static double decode(const Codes &codes, const Common::Huffman *huffman,
+                     const std::vector<byte> &data, const std::vector<uint32> &symbols,
+                     uint32 &errors) {
+
+	BitStreamType bits(&data[0], data.size());
+
+	std::clock_t start = std::clock();
+
+	for (std::vector<uint32>::const_iterator s = symbols.begin(); s != symbols.end(); ++s) {
+		const uint32 symbol = huffman ? huffman->getSymbol(bits) : getSymbolLinear(codes, bits);
+		if (symbol != *s)
+			errors++;
+	}
+
+	return getMilliseconds(start);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 2) {
+		std::printf("Usage: %s [<symbols>]\n", argv[0]);
+		return 1;
+	}
+
+	const uint32 symbolCount = (argc == 2) ? MAX(std::atoi(argv[1]), 1) : 200000;
+
+	uint32 errors = 0;
+
+	try {
+		for (int t = 0; t < 3; t++) {
+			std::vector<uint32> weights;
+			const char *name = 0;
+
+			if        (t == 0) {
+				// Small tables with skewed probabilities, like Bink's
+				name = "16 symbols, skewed";
+				for (uint32 i = 0; i < 16; i++)
+					weights.push_back(1 << (16 - i));
+			} else if (t == 1) {
+				// Byte values with a Zipf distribution, like most compressed data
+				name = "256 symbols, Zipf";
+				for (uint32 i = 0; i < 256; i++)
+					weights.push_back(65536 / (i + 1));
+			} else {
+				// Everything equally likely, long codes all the time
+				name = "1024 symbols, flat";
+				for (uint32 i = 0; i < 1024; i++)
+					weights.push_back(1);
+			}
+
+			Codes codes;
+			buildCodes(codes, weights);
+
+			std::vector<uint32> symbols;
+			drawSymbols(codes, symbolCount, symbols);
+
+			for (int msbFirst = 1; msbFirst >= 0; msbFirst--) {
+				if (!msbFirst)
+					reverseCodes(codes);
+
+				Common::Huffman huffman(codes.maxLength, codes.codes.size(), &codes.codes[0], &codes.lengths[0]);
+
+				std::vector<byte> data;
+				encode(codes, symbols, msbFirst, data);
+
+				double tableTime, linearTime;
+				if (msbFirst) {
+					tableTime  = decode<Common::BitStreamMemory8MSB>(codes, &huffman, data, symbols, errors);
+					linearTime = decode<Common::BitStreamMemory8MSB>(codes, 0, data, symbols, errors);
+				} else {
+					tableTime  = decode<Common::BitStreamMemory8LSB>(codes, &huffman, data, symbols, errors);
+					linearTime = decode<Common::BitStreamMemory8LSB>(codes, 0, data, symbols, errors);
+				}
+
+				std::printf("%-19s (max. %2u bits), %s first: %.1fns per symbol, bit by bit %.1fns per symbol\n",
+				            name, codes.maxLength, msbFirst ? "MSB" : "LSB",
+				            tableTime * 1000000.0 / symbolCount, linearTime * 1000000.0 / symbolCount);
+			}
+		}
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		return 1;
+	}
+
+	if (errors > 0)
+		std::printf("%u symbols decoded wrongly!\n", errors);
+
+	return (errors == 0) ? 0 : 1;
+}
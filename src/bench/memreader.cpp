@@ -0,0 +1,594 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file bench/memreader.cpp
+ *  Benchmark of MemoryReader against reading through a stream.
+ *
+ *  Builds synthetic GFF, binary 2DA, binary model and texture header data
+ *  in memory, then parses each of them twice: the way the parsers used to,
+ *  with one virtual call per value on a MemoryReadStream, and the way they
+ *  do now, through a MemoryReader. Both have to come to the same result.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/util.h"
+#include "common/error.h"
+#include "common/endianness.h"
+#include "common/ustring.h"
+#include "common/stream.h"
+#include "common/streamtokenizer.h"
+#include "common/memreader.h"
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/** Little endian data, built up in memory. */
+class DataWriter {
+public:
+	uint32 size() const {
+		return _data.size();
+	}
+
+	const byte *getData() const {
+		return &_data[0];
+	}
+
+	void writeByte(byte value) {
+		_data.push_back(value);
+	}
+
+	void writeUint16LE(uint16 value) {
+		byte *data = grow(2);
+		WRITE_LE_UINT16(data, value);
+	}
+
+	void writeUint32LE(uint32 value) {
+		byte *data = grow(4);
+		WRITE_LE_UINT32(data, value);
+	}
+
+	void writeIEEEFloatLE(float value) {
+		uint32 bits;
+		std::memcpy(&bits, &value, 4);
+
+		writeUint32LE(bits);
+	}
+
+	/** Write the string, cut off or padded with zeros to size bytes. */
+	void writeString(const char *str, uint32 size) {
+		byte *data = grow(size);
+		std::strncpy((char *) data, str, size);
+	}
+
+	void writeZeros(uint32 size) {
+		grow(size);
+	}
+
+private:
+	std::vector<byte> _data;
+
+	byte *grow(uint32 n) {
+		_data.resize(_data.size() + n, 0);
+
+		return &_data[_data.size() - n];
+	}
+};
+
+
+// -- GFF: structs pointing to fields pointing to labels --
+
+static const uint32 kGFFStructCount     = 20000;
+static const uint32 kGFFFieldsPerStruct = 8;
+static const uint32 kGFFLabelCount      = 64;
+
+struct GFFHeader {
+	uint32 structOffset, structCount;
+	uint32 fieldOffset, fieldCount;
+	uint32 labelOffset, labelCount;
+	uint32 fieldIndicesOffset, fieldIndicesCount;
+};
+
+static void buildGFF(DataWriter &gff) {
+	const uint32 fieldCount = kGFFStructCount * kGFFFieldsPerStruct;
+
+	GFFHeader header;
+	header.structOffset       = 8 * 4;
+	header.structCount        = kGFFStructCount;
+	header.fieldOffset        = header.structOffset + header.structCount * 12;
+	header.fieldCount         = fieldCount;
+	header.labelOffset        = header.fieldOffset + header.fieldCount * 12;
+	header.labelCount         = kGFFLabelCount;
+	header.fieldIndicesOffset = header.labelOffset + header.labelCount * 16;
+	header.fieldIndicesCount  = fieldCount * 4;
+
+	gff.writeUint32LE(header.structOffset);
+	gff.writeUint32LE(header.structCount);
+	gff.writeUint32LE(header.fieldOffset);
+	gff.writeUint32LE(header.fieldCount);
+	gff.writeUint32LE(header.labelOffset);
+	gff.writeUint32LE(header.labelCount);
+	gff.writeUint32LE(header.fieldIndicesOffset);
+	gff.writeUint32LE(header.fieldIndicesCount);
+
+	for (uint32 i = 0; i < kGFFStructCount; i++) {
+		gff.writeUint32LE(i);
+		gff.writeUint32LE(i * kGFFFieldsPerStruct * 4);
+		gff.writeUint32LE(kGFFFieldsPerStruct);
+	}
+
+	for (uint32 i = 0; i < fieldCount; i++) {
+		gff.writeUint32LE(i % 16);
+		gff.writeUint32LE((i * 7) % kGFFLabelCount);
+		gff.writeUint32LE(i);
+	}
+
+	for (uint32 i = 0; i < kGFFLabelCount; i++) {
+		char label[17];
+		std::snprintf(label, sizeof(label), "Label%u", i);
+
+		gff.writeString(label, 16);
+	}
+
+	// Point the structs to their fields in a shuffled order
+	for (uint32 i = 0; i < fieldCount; i++)
+		gff.writeUint32LE((i * 7919) % fieldCount);
+}
+
+static uint32 parseGFFStream(const DataWriter &data) {
+	Common::MemoryReadStream gff(data.getData(), data.size());
+
+	GFFHeader header;
+	header.structOffset       = gff.readUint32LE();
+	header.structCount        = gff.readUint32LE();
+	header.fieldOffset        = gff.readUint32LE();
+	header.fieldCount         = gff.readUint32LE();
+	header.labelOffset        = gff.readUint32LE();
+	header.labelCount         = gff.readUint32LE();
+	header.fieldIndicesOffset = gff.readUint32LE();
+	header.fieldIndicesCount  = gff.readUint32LE();
+
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < header.structCount; i++) {
+		if (!gff.seek(header.structOffset + i * 12))
+			throw Common::Exception(Common::kSeekError);
+
+		gff.readUint32LE();
+		const uint32 fieldIndex = gff.readUint32LE();
+		const uint32 fieldCount = gff.readUint32LE();
+
+		if (!gff.seek(header.fieldIndicesOffset + fieldIndex))
+			throw Common::Exception(Common::kSeekError);
+
+		std::vector<uint32> indices;
+		indices.reserve(fieldCount);
+		for (uint32 j = 0; j < fieldCount; j++)
+			indices.push_back(gff.readUint32LE());
+
+		for (std::vector<uint32>::const_iterator f = indices.begin(); f != indices.end(); ++f) {
+			if (!gff.seek(header.fieldOffset + *f * 12))
+				throw Common::Exception(Common::kSeekError);
+
+			const uint32 type  = gff.readUint32LE();
+			const uint32 label = gff.readUint32LE();
+			const uint32 value = gff.readUint32LE();
+
+			if (!gff.seek(header.labelOffset + label * 16))
+				throw Common::Exception(Common::kSeekError);
+
+			char labelData[16];
+			if (gff.read(labelData, 16) != 16)
+				throw Common::Exception(Common::kReadError);
+
+			checksum += type + value + (byte) labelData[5];
+		}
+	}
+
+	if (gff.err())
+		throw Common::Exception(Common::kReadError);
+
+	return checksum;
+}
+
+static uint32 parseGFFReader(const DataWriter &data) {
+	Common::MemoryReader gff(data.getData(), data.size());
+
+	GFFHeader header;
+	header.structOffset       = gff.readUint32LE();
+	header.structCount        = gff.readUint32LE();
+	header.fieldOffset        = gff.readUint32LE();
+	header.fieldCount         = gff.readUint32LE();
+	header.labelOffset        = gff.readUint32LE();
+	header.labelCount         = gff.readUint32LE();
+	header.fieldIndicesOffset = gff.readUint32LE();
+	header.fieldIndicesCount  = gff.readUint32LE();
+
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < header.structCount; i++) {
+		gff.seek(header.structOffset + i * 12);
+
+		gff.readUint32LE();
+		const uint32 fieldIndex = gff.readUint32LE();
+		const uint32 fieldCount = gff.readUint32LE();
+
+		gff.seek(header.fieldIndicesOffset + fieldIndex);
+
+		std::vector<uint32> indices;
+		indices.resize(fieldCount);
+		if (fieldCount > 0)
+			gff.readArrayUint32LE(&indices[0], fieldCount);
+
+		for (std::vector<uint32>::const_iterator f = indices.begin(); f != indices.end(); ++f) {
+			gff.seek(header.fieldOffset + *f * 12);
+
+			const uint32 type  = gff.readUint32LE();
+			const uint32 label = gff.readUint32LE();
+			const uint32 value = gff.readUint32LE();
+
+			gff.seek(header.labelOffset + label * 16);
+
+			char labelData[16];
+			gff.read(labelData, 16);
+
+			checksum += type + value + (byte) labelData[5];
+		}
+	}
+
+	return checksum;
+}
+
+
+// -- 2DA: a cell offset table, followed by the cells' strings --
+
+static const uint32 kTwoDARowCount    = 2000;
+static const uint32 kTwoDAColumnCount = 40;
+
+static void buildTwoDA(DataWriter &twoda) {
+	// Many cells share the same few strings, like in a real 2DA
+	static const char *kCells[] = { "", "1", "25", "0x0800", "0.5", "ASpellName", "****" };
+
+	std::vector<uint16> cellOffsets;
+	uint32 offset = 0;
+	for (int i = 0; i < ARRAYSIZE(kCells); i++) {
+		cellOffsets.push_back(offset);
+		offset += std::strlen(kCells[i]) + 1;
+	}
+
+	for (uint32 i = 0; i < (kTwoDARowCount * kTwoDAColumnCount); i++)
+		twoda.writeUint16LE(cellOffsets[(i * 31) % ARRAYSIZE(kCells)]);
+
+	twoda.writeUint16LE(0); // Reserved
+
+	for (int i = 0; i < ARRAYSIZE(kCells); i++)
+		twoda.writeString(kCells[i], std::strlen(kCells[i]) + 1);
+}
+
+static uint32 parseTwoDAStream(const DataWriter &data) {
+	Common::MemoryReadStream twoda(data.getData(), data.size());
+
+	const uint32 cellCount = kTwoDARowCount * kTwoDAColumnCount;
+
+	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleHeed);
+	tokenize.addSeparator('\0');
+
+	std::vector<uint32> offsets;
+	offsets.resize(cellCount);
+	for (uint32 i = 0; i < cellCount; i++)
+		offsets[i] = twoda.readUint16LE();
+
+	twoda.skip(2); // Reserved
+
+	const uint32 dataOffset = twoda.pos();
+
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < cellCount; i++) {
+		if (!twoda.seek(dataOffset + offsets[i]))
+			throw Common::Exception(Common::kSeekError);
+
+		Common::UString cell = tokenize.getToken(twoda);
+		if (cell.empty())
+			cell = "****";
+
+		checksum += cell.size();
+	}
+
+	return checksum;
+}
+
+static uint32 parseTwoDAReader(const DataWriter &data) {
+	Common::MemoryReader twoda(data.getData(), data.size());
+
+	const uint32 cellCount = kTwoDARowCount * kTwoDAColumnCount;
+
+	std::vector<uint16> offsets;
+	offsets.resize(cellCount);
+	twoda.readArrayUint16LE(&offsets[0], cellCount);
+
+	twoda.skip(2); // Reserved
+
+	const uint32 dataOffset = twoda.pos();
+
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < cellCount; i++) {
+		twoda.seek(dataOffset + offsets[i]);
+
+		Common::UString cell = twoda.readStringASCII();
+		if (cell.empty())
+			cell = "****";
+
+		checksum += cell.size();
+	}
+
+	return checksum;
+}
+
+
+// -- Model: vertex positions, texture coordinates and faces of a binary mesh --
+
+static const uint32 kModelVertexCount = 60000;
+static const uint32 kModelFaceCount   = 100000;
+
+static void buildModel(DataWriter &mdl) {
+	for (uint32 i = 0; i < kModelVertexCount * 3; i++)
+		mdl.writeIEEEFloatLE(i * 0.25f);
+
+	for (uint32 i = 0; i < kModelVertexCount * 2; i++)
+		mdl.writeIEEEFloatLE(i * 0.125f);
+
+	for (uint32 i = 0; i < kModelFaceCount; i++) {
+		mdl.writeZeros(3 * 4 + 4 + 4 + 3 * 2);
+
+		mdl.writeUint16LE((i * 3 + 0) % kModelVertexCount);
+		mdl.writeUint16LE((i * 3 + 1) % kModelVertexCount);
+		mdl.writeUint16LE((i * 3 + 2) % kModelVertexCount);
+	}
+}
+
+static uint32 parseModelStream(const DataWriter &data) {
+	Common::MemoryReadStream mdl(data.getData(), data.size());
+
+	std::vector<float> vX, vY, vZ, tX, tY;
+	vX.resize(kModelVertexCount);
+	vY.resize(kModelVertexCount);
+	vZ.resize(kModelVertexCount);
+	tX.resize(kModelVertexCount);
+	tY.resize(kModelVertexCount);
+
+	mdl.seekTo(0);
+	for (uint32 i = 0; i < kModelVertexCount; i++) {
+		vX[i] = mdl.readIEEEFloatLE();
+		vY[i] = mdl.readIEEEFloatLE();
+		vZ[i] = mdl.readIEEEFloatLE();
+	}
+
+	mdl.seekTo(kModelVertexCount * 3 * 4);
+	for (uint32 i = 0; i < kModelVertexCount; i++) {
+		tX[i] = mdl.readIEEEFloatLE();
+		tY[i] = mdl.readIEEEFloatLE();
+	}
+
+	mdl.seekTo(kModelVertexCount * 5 * 4);
+
+	uint32 checksum = 0;
+	for (uint32 i = 0; i < kModelFaceCount; i++) {
+		mdl.skip(3 * 4); // Normal
+		mdl.skip(    4); // Distance
+		mdl.skip(    4); // ID
+		mdl.skip(3 * 2); // Adjacent face number
+
+		const uint16 v1 = mdl.readUint16LE();
+		const uint16 v2 = mdl.readUint16LE();
+		const uint16 v3 = mdl.readUint16LE();
+
+		checksum += (uint32) (vX[v1] + vY[v2] + vZ[v3] + tX[v1] + tY[v3]);
+	}
+
+	return checksum;
+}
+
+static uint32 parseModelReader(const DataWriter &data) {
+	Common::MemoryReader mdl(data.getData(), data.size());
+
+	std::vector<float> vX, vY, vZ, tX, tY;
+	vX.resize(kModelVertexCount);
+	vY.resize(kModelVertexCount);
+	vZ.resize(kModelVertexCount);
+	tX.resize(kModelVertexCount);
+	tY.resize(kModelVertexCount);
+
+	mdl.seek(0);
+	for (uint32 i = 0; i < kModelVertexCount; i++) {
+		vX[i] = mdl.readIEEEFloatLE();
+		vY[i] = mdl.readIEEEFloatLE();
+		vZ[i] = mdl.readIEEEFloatLE();
+	}
+
+	mdl.seek(kModelVertexCount * 3 * 4);
+	for (uint32 i = 0; i < kModelVertexCount; i++) {
+		tX[i] = mdl.readIEEEFloatLE();
+		tY[i] = mdl.readIEEEFloatLE();
+	}
+
+	mdl.seek(kModelVertexCount * 5 * 4);
+
+	uint32 checksum = 0;
+	for (uint32 i = 0; i < kModelFaceCount; i++) {
+		mdl.skip(3 * 4); // Normal
+		mdl.skip(    4); // Distance
+		mdl.skip(    4); // ID
+		mdl.skip(3 * 2); // Adjacent face number
+
+		const uint16 v1 = mdl.readUint16LE();
+		const uint16 v2 = mdl.readUint16LE();
+		const uint16 v3 = mdl.readUint16LE();
+
+		checksum += (uint32) (vX[v1] + vY[v2] + vZ[v3] + tX[v1] + tY[v3]);
+	}
+
+	return checksum;
+}
+
+
+// -- Texture headers: many small TPC headers, each in its own resource --
+
+static const uint32 kTextureCount      = 20000;
+static const uint32 kTextureHeaderSize = 128;
+
+static void buildTextures(DataWriter &tpc) {
+	for (uint32 i = 0; i < kTextureCount; i++) {
+		tpc.writeUint32LE(i * 64);               // Data size
+		tpc.writeIEEEFloatLE(1.0f);              // Alpha blending
+		tpc.writeUint16LE(1 << (i % 10));        // Width
+		tpc.writeUint16LE(1 << ((i + 3) % 10));  // Height
+		tpc.writeByte(2 + (i % 3) * 2);          // Encoding
+		tpc.writeByte(i % 10);                   // Mip maps
+		tpc.writeZeros(kTextureHeaderSize - 14); // Reserved
+	}
+}
+
+static uint32 parseTexturesStream(const DataWriter &data) {
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < kTextureCount; i++) {
+		Common::MemoryReadStream tpc(data.getData() + i * kTextureHeaderSize, kTextureHeaderSize);
+
+		const uint32 dataSize = tpc.readUint32LE();
+		tpc.readIEEEFloatLE();
+
+		const uint16 width    = tpc.readUint16LE();
+		const uint16 height   = tpc.readUint16LE();
+		const byte   encoding = tpc.readByte();
+		const byte   mipMaps  = tpc.readByte();
+
+		tpc.skip(kTextureHeaderSize - 14);
+
+		if (tpc.err())
+			throw Common::Exception(Common::kReadError);
+
+		checksum += dataSize + width + height + encoding + mipMaps;
+	}
+
+	return checksum;
+}
+
+static uint32 parseTexturesReader(const DataWriter &data) {
+	uint32 checksum = 0;
+
+	for (uint32 i = 0; i < kTextureCount; i++) {
+		Common::MemoryReader tpc(data.getData() + i * kTextureHeaderSize, kTextureHeaderSize);
+
+		const uint32 dataSize = tpc.readUint32LE();
+		tpc.readIEEEFloatLE();
+
+		const uint16 width    = tpc.readUint16LE();
+		const uint16 height   = tpc.readUint16LE();
+		const byte   encoding = tpc.readByte();
+		const byte   mipMaps  = tpc.readByte();
+
+		tpc.skip(kTextureHeaderSize - 14);
+
+		checksum += dataSize + width + height + encoding + mipMaps;
+	}
+
+	return checksum;
+}
+
+
+typedef void   (*BuildFunc)(DataWriter &data);
+typedef uint32 (*ParseFunc)(const DataWriter &data);
+
+struct Format {
+	const char *name;
+
+	BuildFunc build;
+	ParseFunc parseStream;
+	ParseFunc parseReader;
+};
+
+static const Format kFormats[] = {
+	{ "GFF"            , &buildGFF     , &parseGFFStream     , &parseGFFReader      },
+	{ "2DA"            , &buildTwoDA   , &parseTwoDAStream   , &parseTwoDAReader    },
+	{ "Model"          , &buildModel   , &parseModelStream   , &parseModelReader    },
+	{ "Texture headers", &buildTextures, &parseTexturesStream, &parseTexturesReader }
+};
+
+/** Parse the data a number of times, and return the time taken per pass. */
+static double parse(ParseFunc parseFunc, const DataWriter &data, int passes, uint32 &checksum) {
+	std::clock_t start = std::clock();
+
+	for (int i = 0; i < passes; i++)
+		checksum = (*parseFunc)(data);
+
+	return getMilliseconds(start) / passes;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 2) {
+		std::printf("Usage: %s [<passes>]\n", argv[0]);
+		return 1;
+	}
+
+	const int passes = (argc == 2) ? MAX(std::atoi(argv[1]), 1) : 10;
+
+	int mismatches = 0;
+
+	try {
+		for (int i = 0; i < ARRAYSIZE(kFormats); i++) {
+			DataWriter data;
+			(*kFormats[i].build)(data);
+
+			uint32 streamChecksum = 0, readerChecksum = 0;
+
+			const double streamTime = parse(kFormats[i].parseStream, data, passes, streamChecksum);
+			const double readerTime = parse(kFormats[i].parseReader, data, passes, readerChecksum);
+
+			const bool matches = streamChecksum == readerChecksum;
+			if (!matches)
+				mismatches++;
+
+			std::printf("%-15s (%7u bytes): stream %.2fms, MemoryReader %.2fms (%.1fx)%s\n",
+			            kFormats[i].name, data.size(), streamTime, readerTime,
+			            (readerTime > 0.0) ? (streamTime / readerTime) : 0.0,
+			            matches ? "" : " (results differ!)");
+		}
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		return 1;
+	}
+
+	return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file bench/model.cpp
+ *  Benchmark of loading many instances of the same models.
+ *
+ *  Indexes a Neverwinter Nights installation and loads each of the given
+ *  models (like area tiles or placeables) a number of times, once parsing
+ *  every instance on its own and once through the model loader's cache,
+ *  which parses each model once and shares its data between instances.
+ *  The memory the instances take up is measured by counting the bytes
+ *  allocated while loading them.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/util.h"
+#include "common/error.h"
+#include "common/ustring.h"
+#include "common/filepath.h"
+
+#include "aurora/types.h"
+#include "aurora/resman.h"
+
+#include "graphics/aurora/types.h"
+#include "graphics/aurora/model.h"
+
+#include "engines/nwn/modelloader.h"
+
+/** The number of bytes currently allocated with new. */
+static size_t allocatedBytes = 0;
+
+/** Room in front of each allocation to remember its size, keeping the alignment. */
+static const size_t kAllocHeader = 16;
+
+void *operator new(size_t size, const std::nothrow_t &) throw() {
+	byte *data = (byte *) std::malloc(size + kAllocHeader);
+	if (!data)
+		return 0;
+
+	*((size_t *) data) = size;
+	allocatedBytes += size;
+
+	return data + kAllocHeader;
+}
+
+void *operator new(size_t size) {
+	void *data = operator new(size, std::nothrow);
+	if (!data)
+		throw std::bad_alloc();
+
+	return data;
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) throw() {
+	if (!ptr)
+		return;
+
+	byte *data = ((byte *) ptr) - kAllocHeader;
+
+	allocatedBytes -= *((size_t *) data);
+	std::free(data);
+}
+
+void operator delete(void *ptr) throw() {
+	operator delete(ptr, std::nothrow);
+}
+
+/** The optional KEYs, in order of their priority. */
+static const char *kOptionalKEYs[] = {
+	"patch.key", "xp1.key", "xp1patch.key", "xp2.key", "xp2patch.key", "xp3.key", "xp3patch.key"
+};
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void indexNWN(const Common::UString &directory) {
+	ResMan.registerDataBaseDir(directory);
+
+	ResMan.addArchiveDir(Aurora::kArchiveBIF, "data");
+
+	ResMan.addArchive(Aurora::kArchiveKEY, "chitin.key", 0);
+
+	uint32 priority = 1;
+	for (int i = 0; i < ARRAYSIZE(kOptionalKEYs); i++, priority++)
+		if (ResMan.hasArchive(Aurora::kArchiveKEY, kOptionalKEYs[i]))
+			ResMan.addArchive(Aurora::kArchiveKEY, kOptionalKEYs[i], priority);
+
+	if (!Common::FilePath::findSubDirectory(directory, "override", true).empty())
+		ResMan.addResourceDir("override", 0, 0, 1000);
+}
+
+/** Load the model a number of times, returning the time taken and the bytes the instances occupy. */
+static bool loadInstances(Engines::ModelLoader &loader, const Common::UString &name,
+                          int instances, bool shared, double &time, size_t &memory) {
+
+	std::vector<Graphics::Aurora::Model *> models;
+	models.reserve(instances);
+
+	const size_t allocatedBefore = allocatedBytes;
+
+	std::clock_t start = std::clock();
+
+	bool success = true;
+	for (int i = 0; i < instances; i++) {
+		Graphics::Aurora::Model *model = 0;
+
+		try {
+			if (shared)
+				model = loader.get(name, Graphics::Aurora::kModelTypeObject, "");
+			else
+				model = loader.load(name, Graphics::Aurora::kModelTypeObject, "");
+		} catch (Common::Exception &e) {
+			e.add("Failed to load model \"%s\"", name.c_str());
+			Common::printException(e, "WARNING: ");
+
+			success = false;
+			break;
+		}
+
+		models.push_back(model);
+	}
+
+	time   = getMilliseconds(start);
+	memory = allocatedBytes - allocatedBefore;
+
+	for (std::vector<Graphics::Aurora::Model *>::iterator m = models.begin(); m != models.end(); ++m)
+		loader.free(*m);
+
+	loader.clearCache();
+
+	return success;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		std::printf("Usage: %s <NWN directory> <instances> <model> [<model> [...]]\n", argv[0]);
+		return 1;
+	}
+
+	const int instances = MAX(std::atoi(argv[2]), 1);
+
+	try {
+		indexNWN(argv[1]);
+
+		Engines::NWN::NWNModelLoader loader;
+
+		double totalTimes[2] = { 0.0, 0.0 };
+		size_t totalMemory[2] = { 0, 0 };
+
+		for (int i = 3; i < argc; i++) {
+			double times[2];
+			size_t memory[2];
+
+			// Keep one instance around, so that both runs find the textures already loaded
+			Graphics::Aurora::Model *textures = 0;
+			try {
+				textures = loader.load(argv[i], Graphics::Aurora::kModelTypeObject, "");
+			} catch (Common::Exception &e) {
+				e.add("Failed to load model \"%s\"", argv[i]);
+				Common::printException(e, "WARNING: ");
+				continue;
+			}
+
+			const bool success =
+				loadInstances(loader, argv[i], instances, false, times[0], memory[0]) &&
+				loadInstances(loader, argv[i], instances, true , times[1], memory[1]);
+
+			loader.free(textures);
+
+			if (!success)
+				continue;
+
+			std::printf("%s: %d instances\n", argv[i], instances);
+			std::printf("  parsed each: %.3fms, %u bytes\n", times[0], (uint) memory[0]);
+			std::printf("  shared     : %.3fms, %u bytes\n", times[1], (uint) memory[1]);
+
+			for (int j = 0; j < 2; j++) {
+				totalTimes [j] += times [j];
+				totalMemory[j] += memory[j];
+			}
+		}
+
+		std::printf("Total: parsed each %.1fms, %u bytes; shared %.1fms, %u bytes\n",
+		            totalTimes[0], (uint) totalMemory[0], totalTimes[1], (uint) totalMemory[1]);
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		return 1;
+	}
+
+	Aurora::ResourceManager::destroy();
+
+	return 0;
+}
@@ -0,0 +1,217 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file bench/resman.cpp
+ *  Benchmark of the resource manager's lookups.
+ *
+ *  Indexes a Neverwinter Nights installation (chitin.key, the patch and
+ *  expansion KEYs and all HAKs), then looks up every resource name found,
+ *  as given and in uppercase, a number of times.
+ *
+ *  If an index cache file is given, the installation is indexed three
+ *  times: without the cache, writing the cache and out of the cache. This
+ *  compares a cold startup with a cached one, and makes sure both find the
+ *  same resources.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <list>
+#include <vector>
+#include <algorithm>
+
+#include "common/util.h"
+#include "common/ustring.h"
+#include "common/error.h"
+#include "common/filelist.h"
+#include "common/filepath.h"
+
+#include "aurora/types.h"
+#include "aurora/resman.h"
+
+/** The optional KEYs, in order of their priority. */
+static const char *kOptionalKEYs[] = {
+	"patch.key", "xp1.key", "xp1patch.key", "xp2.key", "xp2patch.key", "xp3.key", "xp3patch.key"
+};
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void indexNWN(const Common::UString &directory) {
+	ResMan.registerDataBaseDir(directory);
+
+	ResMan.addArchiveDir(Aurora::kArchiveBIF, "data");
+	ResMan.addArchiveDir(Aurora::kArchiveERF, "hak");
+
+	ResMan.addArchive(Aurora::kArchiveKEY, "chitin.key", 0);
+
+	uint32 priority = 1;
+	for (int i = 0; i < ARRAYSIZE(kOptionalKEYs); i++, priority++)
+		if (ResMan.hasArchive(Aurora::kArchiveKEY, kOptionalKEYs[i]))
+			ResMan.addArchive(Aurora::kArchiveKEY, kOptionalKEYs[i], priority);
+
+	Common::FileList hakDir;
+	hakDir.addDirectory(Common::FilePath::findSubDirectory(directory, "hak", true));
+
+	std::list<Common::UString> hakFiles;
+	hakDir.getSubList(".*\\.hak", hakFiles, true);
+
+	std::vector<Common::UString> haks;
+	for (std::list<Common::UString>::const_iterator h = hakFiles.begin(); h != hakFiles.end(); ++h)
+		haks.push_back(Common::FilePath::getStem(*h) + Common::FilePath::getExtension(*h));
+
+	ResMan.addArchives(Aurora::kArchiveERF, haks, 100);
+
+	std::printf("Indexed %u HAKs\n", (uint) haks.size());
+}
+
+/** Index the installation with a fresh resource manager, and return the time it took. */
+static double timeIndexing(const Common::UString &directory, const Common::UString &indexCache) {
+	Aurora::ResourceManager::destroy();
+
+	std::clock_t start = std::clock();
+
+	if (!indexCache.empty())
+		ResMan.setIndexCache(indexCache);
+
+	indexNWN(directory);
+
+	ResMan.saveIndexCache();
+
+	return getMilliseconds(start);
+}
+
+static bool compareResourceIDs(const Aurora::ResourceManager::ResourceID &a,
+                               const Aurora::ResourceManager::ResourceID &b) {
+
+	if (a.type != b.type)
+		return a.type < b.type;
+
+	return a.name < b.name;
+}
+
+static bool equalResourceIDs(const Aurora::ResourceManager::ResourceID &a,
+                             const Aurora::ResourceManager::ResourceID &b) {
+
+	return (a.type == b.type) && (a.name == b.name);
+}
+
+static void getSortedResources(std::vector<Aurora::ResourceManager::ResourceID> &resources) {
+	std::list<Aurora::ResourceManager::ResourceID> available;
+	ResMan.getAvailableResources(available);
+
+	resources.assign(available.begin(), available.end());
+	std::sort(resources.begin(), resources.end(), compareResourceIDs);
+}
+
+int main(int argc, char **argv) {
+	if ((argc < 2) || (argc > 4)) {
+		std::printf("Usage: %s <NWN directory> [<passes> [<index cache file>]]\n", argv[0]);
+		return 1;
+	}
+
+	const int passes = (argc >= 3) ? std::atoi(argv[2]) : 20;
+
+	const Common::UString indexCache = (argc == 4) ? argv[3] : "";
+
+	try {
+		std::vector<Aurora::ResourceManager::ResourceID> resources;
+
+		if (indexCache.empty()) {
+			std::printf("Indexing: %.1fms\n", timeIndexing(argv[1], ""));
+
+			getSortedResources(resources);
+		} else {
+			const double uncachedTime = timeIndexing(argv[1], "");
+
+			std::vector<Aurora::ResourceManager::ResourceID> uncached;
+			getSortedResources(uncached);
+
+			const double writeTime = timeIndexing(argv[1], indexCache);
+			const double readTime  = timeIndexing(argv[1], indexCache);
+
+			getSortedResources(resources);
+
+			std::printf("Indexing: %.1fms without cache, %.1fms writing the cache, "
+			            "%.1fms out of the cache\n", uncachedTime, writeTime, readTime);
+
+			if ((resources.size() != uncached.size()) ||
+			    !std::equal(resources.begin(), resources.end(), uncached.begin(), equalResourceIDs)) {
+
+				std::printf("Index cache mismatch: %u resources without cache, %u out of the cache\n",
+				            (uint) uncached.size(), (uint) resources.size());
+
+				Aurora::ResourceManager::destroy();
+				return 1;
+			}
+		}
+
+		// Look each resource up as it's named, and in uppercase, like scripts tend to do
+		std::vector<Common::UString>  names;
+		std::vector<Aurora::FileType> types;
+
+		names.reserve(2 * resources.size());
+		types.reserve(2 * resources.size());
+
+		for (std::vector<Aurora::ResourceManager::ResourceID>::const_iterator r = resources.begin();
+		     r != resources.end(); ++r) {
+
+			Common::UString upperName = r->name;
+			upperName.toupper();
+
+			names.push_back(r->name);
+			types.push_back(r->type);
+			names.push_back(upperName);
+			types.push_back(r->type);
+		}
+
+		uint32 found = 0;
+
+		std::clock_t start = std::clock();
+
+		for (int i = 0; i < passes; i++)
+			for (size_t j = 0; j < names.size(); j++)
+				if (ResMan.hasResource(names[j], types[j]))
+					found++;
+
+		const double time    = getMilliseconds(start);
+		const double lookups = ((double) passes) * names.size();
+
+		std::printf("%u resources, %.0f lookups (%u found): %.1fms, %.1fns per lookup\n",
+		            (uint) resources.size(), lookups, found, time,
+		            (lookups > 0.0) ? (time * 1000000.0 / lookups) : 0.0);
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		return 1;
+	}
+
+	Aurora::ResourceManager::destroy();
+
+	return 0;
+}
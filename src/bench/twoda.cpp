@@ -0,0 +1,232 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+/** @file bench/twoda.cpp
+ *  Benchmark of loading 2DAs and looking up their cells.
+ *
+ *  Loads the given 2DA files (like spells.2da, feat.2da or appearance.2da)
+ *  and reads every cell as a string, an int and a float, once by column
+ *  index and once by column header. The memory a loaded 2DA takes up is
+ *  measured by counting the bytes allocated while loading it.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/util.h"
+#include "common/error.h"
+#include "common/ustring.h"
+#include "common/stream.h"
+#include "common/file.h"
+
+#include "aurora/2dafile.h"
+
+/** The number of bytes currently allocated with new. */
+static size_t allocatedBytes = 0;
+
+/** Room in front of each allocation to remember its size, keeping the alignment. */
+static const size_t kAllocHeader = 16;
+
+void *operator new(size_t size, const std::nothrow_t &) throw() {
+	byte *data = (byte *) std::malloc(size + kAllocHeader);
+	if (!data)
+		return 0;
+
+	*((size_t *) data) = size;
+	allocatedBytes += size;
+
+	return data + kAllocHeader;
+}
+
+void *operator new(size_t size) {
+	void *data = operator new(size, std::nothrow);
+	if (!data)
+		throw std::bad_alloc();
+
+	return data;
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) throw() {
+	if (!ptr)
+		return;
+
+	byte *data = ((byte *) ptr) - kAllocHeader;
+
+	allocatedBytes -= *((size_t *) data);
+	std::free(data);
+}
+
+void operator delete(void *ptr) throw() {
+	operator delete(ptr, std::nothrow);
+}
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void readFile(const Common::UString &fileName, std::vector<byte> &data) {
+	Common::File file;
+	if (!file.open(fileName))
+		throw Common::Exception(Common::kOpenError);
+
+	data.resize(file.size());
+	if (data.empty() || (file.read(&data[0], data.size()) != data.size()))
+		throw Common::Exception(Common::kReadError);
+}
+
+/** Time reading every cell of the 2DA by column index. */
+static void benchIndex(const Aurora::TwoDAFile &twoda, int passes, double times[3], uint32 &checksum) {
+	const uint32 rowCount    = twoda.getRowCount();
+	const uint32 columnCount = twoda.getColumnCount();
+
+	std::clock_t start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (uint32 c = 0; c < columnCount; c++)
+				checksum += twoda.getRow(r).getString(c).size();
+	times[0] += getMilliseconds(start);
+
+	start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (uint32 c = 0; c < columnCount; c++)
+				checksum += twoda.getRow(r).getInt(c);
+	times[1] += getMilliseconds(start);
+
+	start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (uint32 c = 0; c < columnCount; c++)
+				checksum += (uint32) twoda.getRow(r).getFloat(c);
+	times[2] += getMilliseconds(start);
+}
+
+/** Time reading every cell of the 2DA by column header. */
+static void benchHeader(const Aurora::TwoDAFile &twoda, int passes, double times[3], uint32 &checksum) {
+	const uint32 rowCount = twoda.getRowCount();
+
+	const std::vector<Common::UString> &headers = twoda.getHeaders();
+
+	std::clock_t start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (std::vector<Common::UString>::const_iterator h = headers.begin(); h != headers.end(); ++h)
+				checksum += twoda.getRow(r).getString(*h).size();
+	times[0] += getMilliseconds(start);
+
+	start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (std::vector<Common::UString>::const_iterator h = headers.begin(); h != headers.end(); ++h)
+				checksum += twoda.getRow(r).getInt(*h);
+	times[1] += getMilliseconds(start);
+
+	start = std::clock();
+	for (int i = 0; i < passes; i++)
+		for (uint32 r = 0; r < rowCount; r++)
+			for (std::vector<Common::UString>::const_iterator h = headers.begin(); h != headers.end(); ++h)
+				checksum += (uint32) twoda.getRow(r).getFloat(*h);
+	times[2] += getMilliseconds(start);
+}
+
+static void printLookups(const char *what, const double times[3], double lookups) {
+	if (lookups <= 0.0)
+		return;
+
+	std::printf("  by %-6s: getString %.1fns, getInt %.1fns, getFloat %.1fns per cell\n", what,
+	            times[0] * 1000000.0 / lookups, times[1] * 1000000.0 / lookups,
+	            times[2] * 1000000.0 / lookups);
+}
+
+static void bench2DA(const Common::UString &fileName, int passes) {
+	std::vector<byte> data;
+	readFile(fileName, data);
+
+	double loadTime = 0.0;
+	for (int i = 0; i < passes; i++) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+		Aurora::TwoDAFile twoda;
+
+		std::clock_t start = std::clock();
+
+		twoda.load(stream);
+
+		loadTime += getMilliseconds(start);
+	}
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	const size_t allocatedBefore = allocatedBytes;
+
+	Aurora::TwoDAFile twoda;
+	twoda.load(stream);
+
+	const size_t memory = allocatedBytes - allocatedBefore;
+
+	std::printf("%s: %u rows, %u columns, %u bytes\n", fileName.c_str(),
+	            twoda.getRowCount(), twoda.getColumnCount(), (uint) data.size());
+	std::printf("  load %.3fms, %u bytes in memory\n", loadTime / passes, (uint) memory);
+
+	uint32 checksum = 0;
+
+	double indexTimes[3] = { 0.0, 0.0, 0.0 }, headerTimes[3] = { 0.0, 0.0, 0.0 };
+	benchIndex (twoda, passes, indexTimes , checksum);
+	benchHeader(twoda, passes, headerTimes, checksum);
+
+	const double lookups = ((double) passes) * twoda.getRowCount() * twoda.getColumnCount();
+
+	printLookups("index" , indexTimes , lookups);
+	printLookups("header", headerTimes, lookups);
+
+	// Make sure the lookups can't be optimized away
+	if (checksum == 0xFFFFFFFF)
+		std::printf("\n");
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		std::printf("Usage: %s <passes> <2DA file> [<2DA file> [...]]\n", argv[0]);
+		return 1;
+	}
+
+	const int passes = MAX(std::atoi(argv[1]), 1);
+
+	for (int i = 2; i < argc; i++) {
+		try {
+			bench2DA(argv[i], passes);
+		} catch (Common::Exception &e) {
+			e.add("Failed benchmarking \"%s\"", argv[i]);
+
+			Common::printException(e);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,184 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+/** @file bench/videoframes.cpp
+ *  Stress test of the hand-over of decoded video frames between threads.
+ *
+ *  A decoding thread fills surfaces with their frame number as fast as it
+ *  can, while the main thread takes, "uploads" and shows them the same way
+ *  VideoDecoder::update() does. Every frame shown has to be complete and
+ *  newer than the last one, and the shown frame must never be written to.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <SDL_timer.h>
+
+#include "common/types.h"
+#include "common/error.h"
+#include "common/thread.h"
+
+#include "graphics/images/surface.h"
+
+#include "video/framequeue.h"
+
+static const int kSurfaceSize = 64;
+
+/** Write the frame number into every pixel of the surface. */
+static void fillFrame(Graphics::Surface &surface, uint32 frame) {
+	uint32 *data = (uint32 *) surface.getData();
+
+	for (int i = 0; i < (kSurfaceSize * kSurfaceSize); i++)
+		data[i] = frame;
+}
+
+/** Read the surface's frame number, and return whether it's the same in every pixel. */
+static bool checkFrame(const Graphics::Surface &surface, uint32 &frame) {
+	const uint32 *data = (const uint32 *) surface.getData();
+
+	frame = data[0];
+
+	for (int i = 1; i < (kSurfaceSize * kSurfaceSize); i++)
+		if (data[i] != frame)
+			return false;
+
+	return true;
+}
+
+class FrameDecoder : public Common::Thread {
+public:
+	FrameDecoder(Video::FrameQueue &queue, uint32 frameCount) :
+		_queue(&queue), _frameCount(frameCount), _done(false) {
+	}
+
+	~FrameDecoder() {
+		destroyThread();
+	}
+
+	bool isDone() const {
+		return _done;
+	}
+
+private:
+	Video::FrameQueue *_queue;
+
+	uint32 _frameCount;
+
+	volatile bool _done;
+
+	void threadMethod() {
+		Graphics::Surface *surface = _queue->getDecoding();
+
+		for (uint32 frame = 1; (frame <= _frameCount) && !_killThread; frame++) {
+			fillFrame(*surface, frame);
+
+			surface = _queue->finishDecoding();
+		}
+
+		_done = true;
+	}
+};
+
+int main(int argc, char **argv) {
+	if (argc > 2) {
+		std::printf("Usage: %s [<frames>]\n", argv[0]);
+		return 1;
+	}
+
+	const uint32 frameCount = (argc == 2) ? std::atoi(argv[1]) : 200000;
+
+	Graphics::Surface *surfaces[Video::FrameQueue::kMinSurfaceCount];
+	for (uint32 i = 0; i < Video::FrameQueue::kMinSurfaceCount; i++) {
+		surfaces[i] = new Graphics::Surface(kSurfaceSize, kSurfaceSize);
+
+		fillFrame(*surfaces[i], 0);
+	}
+
+	uint32 shownCount = 0, errors = 0;
+
+	try {
+		Video::FrameQueue queue;
+		queue.init(surfaces, Video::FrameQueue::kMinSurfaceCount);
+
+		FrameDecoder decoder(queue, frameCount);
+		if (!decoder.createThread())
+			throw Common::Exception("Failed to create the decoding thread");
+
+		uint32 lastFrame = 0;
+
+		bool done = false;
+		while (!done) {
+			// Only stop once the last frame has been taken
+			done = decoder.isDone();
+
+			Graphics::Surface *frame = queue.takeReady();
+			if (!frame)
+				continue;
+
+			// "Upload" the frame, and give the decoding thread time to scribble into it
+			uint32 number, numberAgain;
+			const bool complete = checkFrame(*frame, number);
+
+			SDL_Delay(1);
+
+			if (!complete || !checkFrame(*frame, numberAgain) || (number != numberAgain)) {
+				std::printf("Frame after %u was modified while being uploaded\n", lastFrame);
+				errors++;
+			} else if (number <= lastFrame) {
+				std::printf("Frame %u shown after frame %u\n", number, lastFrame);
+				errors++;
+			} else
+				lastFrame = number;
+
+			Graphics::Surface *shown = queue.show(frame);
+
+			uint32 shownNumber;
+			if (!checkFrame(*shown, shownNumber)) {
+				std::printf("Frame before %u was modified while being shown\n", lastFrame);
+				errors++;
+			}
+
+			queue.release(shown);
+
+			shownCount++;
+		}
+
+		if (lastFrame != frameCount) {
+			std::printf("Last frame shown was %u, not %u\n", lastFrame, frameCount);
+			errors++;
+		}
+
+	} catch (Common::Exception &e) {
+		Common::printException(e);
+		errors++;
+	}
+
+	for (uint32 i = 0; i < Video::FrameQueue::kMinSurfaceCount; i++)
+		delete surfaces[i];
+
+	std::printf("%u frames decoded, %u shown, %u errors\n", frameCount, shownCount, errors);
+
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+/** @file bench/yuv.cpp
+ *  Benchmark of the YUV to RGB conversion paths.
+ *
+ *  Converts random YUV420 and YUVA420 frames at 640x480 and 1280x720 with
+ *  every conversion path the CPU supports, and checks that they all come
+ *  to the same result as the scalar path.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/util.h"
+
+#include "graphics/yuv_to_rgb.h"
+
+struct FrameSize {
+	int width;
+	int height;
+};
+
+static const FrameSize kFrameSizes[] = { { 640, 480 }, { 1280, 720 } };
+
+static const Graphics::YUVToRGBPath kPaths[] = {
+	Graphics::kYUVToRGBPathScalar, Graphics::kYUVToRGBPathSSE2, Graphics::kYUVToRGBPathAVX2
+};
+
+static const char *kPathNames[] = { "scalar", "SSE2", "AVX2" };
+
+static double getMilliseconds(std::clock_t start) {
+	return ((double) (std::clock() - start)) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void fillRandom(std::vector<byte> &plane) {
+	for (size_t i = 0; i < plane.size(); i++)
+		plane[i] = std::rand() & 0xFF;
+}
+
+/** Convert the frame a number of times, and return the time taken per frame. */
+static double convert(std::vector<byte> &dst, const std::vector<byte> &y, const std::vector<byte> &u,
+                      const std::vector<byte> &v, const std::vector<byte> *a,
+                      int width, int height, int frames, Graphics::YUVToRGBBuffer &buffer) {
+
+	const int uvPitch = width / 2;
+
+	std::clock_t start = std::clock();
+
+	for (int i = 0; i < frames; i++) {
+		if (a)
+			Graphics::convertYUVA420ToRGBA(&dst[0], width * 4, &y[0], &u[0], &v[0], &(*a)[0],
+			                               width, height, width, uvPitch, buffer);
+		else
+			Graphics::convertYUV420ToRGBA(&dst[0], width * 4, &y[0], &u[0], &v[0],
+			                              width, height, width, uvPitch, buffer);
+	}
+
+	return getMilliseconds(start) / frames;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 2) {
+		std::printf("Usage: %s [<frames>]\n", argv[0]);
+		return 1;
+	}
+
+	const int frames = (argc == 2) ? MAX(std::atoi(argv[1]), 1) : 200;
+
+	int mismatches = 0;
+
+	Graphics::YUVToRGBBuffer buffer;
+
+	for (int s = 0; s < ARRAYSIZE(kFrameSizes); s++) {
+		const int width  = kFrameSizes[s].width;
+		const int height = kFrameSizes[s].height;
+
+		std::vector<byte> y(width * height), u((width / 2) * (height / 2)), v(u.size()), a(y.size());
+
+		fillRandom(y);
+		fillRandom(u);
+		fillRandom(v);
+		fillRandom(a);
+
+		for (int alpha = 0; alpha < 2; alpha++) {
+			const std::vector<byte> *aPlane = alpha ? &a : 0;
+
+			std::vector<byte> reference(width * height * 4), dst(reference.size());
+
+			Graphics::setYUVToRGBPath(Graphics::kYUVToRGBPathScalar);
+			convert(reference, y, u, v, aPlane, width, height, 1, buffer);
+
+			for (int p = 0; p < ARRAYSIZE(kPaths); p++) {
+				if (!Graphics::setYUVToRGBPath(kPaths[p])) {
+					std::printf("%4dx%-4d %-5s %-6s: not supported\n",
+					            width, height, alpha ? "YUVA" : "YUV", kPathNames[p]);
+					continue;
+				}
+
+				const double time = convert(dst, y, u, v, aPlane, width, height, frames, buffer);
+
+				const bool matches = std::memcmp(&dst[0], &reference[0], dst.size()) == 0;
+				if (!matches)
+					mismatches++;
+
+				std::printf("%4dx%-4d %-5s %-6s: %.3fms per frame%s\n",
+				            width, height, alpha ? "YUVA" : "YUV", kPathNames[p], time,
+				            matches ? "" : " (differs from the scalar path!)");
+			}
+		}
+	}
+
+	return (mismatches == 0) ? 0 : 1;
+}
@@ -31,8 +31,10 @@
 #define COMMON_BITSTREAM_H
 
 #include "common/types.h"
+#include "common/util.h"
 #include "common/error.h"
 #include "common/stream.h"
+#include "common/endianness.h"
 
 namespace Common {
 
@@ -63,9 +65,18 @@ public:
 	/** Read a multi-bit value from the bit stream. */
 	virtual uint32 getBits(uint8 n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without consuming it.
+	 *
+	 *  Bits beyond the end of the stream read as 0.
+	 */
+	virtual uint32 peekBits(uint8 n) = 0;
+
 	/** Add a bit to the value x, making it an n-bit value. */
 	virtual void addBit(uint32 &x, uint32 n) = 0;
 
+	/** Are the bits handed out in the order of MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -198,6 +209,35 @@ public:
 		return v;
 	}
 
+	/** Read a multi-bit value from the bit stream, without consuming it. */
+	uint32 peekBits(uint8 n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be peeked");
+
+		const uint32 available = MIN<uint32>(n, size() - pos());
+		if (available == 0)
+			return 0;
+
+		// Remember where we are
+		const uint64 value    = _value;
+		const uint8  inValue  = _inValue;
+		const int32  position = _stream->pos();
+
+		uint32 v = getBits(available);
+
+		// And go back there
+		_value   = value;
+		_inValue = inValue;
+		if (_stream->pos() != position)
+			_stream->seek(position);
+
+		// Fill in zeros for the bits past the end of the stream
+		if (isMSB2LSB && (available < n))
+			v <<= n - available;
+
+		return v;
+	}
+
 	/** Add a bit to the value x, making it an n-bit value. */
 	void addBit(uint32 &x, uint32 n) {
 		if (isMSB2LSB)
@@ -206,6 +246,11 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
@@ -239,6 +284,255 @@ public:
 	}
 };
 
+/**
+ * A template implementing a bit stream over a contiguous memory buffer,
+ * for different data memory layouts.
+ *
+ * The layout parameters are the same as for BitStreamImpl, and both hand
+ * out the exact same bits. However, instead of reading each value through
+ * a stream and each bit separately, this bit stream keeps up to 64 bits
+ * cached, refilled in bulk straight from memory, and extracts multi-bit
+ * values from that cache in one go.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class BitStreamMemoryImpl : public BitStream {
+private:
+	/** The number of bits added to the cache at once. */
+	static const uint8 kUnitBits = (valueBits == 64) ? 32 : valueBits;
+
+	const byte *_data;     ///< The data buffer.
+	bool _disposeAfterUse; ///< Should we delete[] the buffer on destruction?
+
+	uint32 _unitCount; ///< The number of units in the buffer.
+	uint32 _unit;      ///< The next unit to add to the cache.
+
+	uint64 _cache;     ///< The cached bits.
+	uint8  _cacheBits; ///< The number of bits in the cache.
+
+	/** Read the full data value containing this unit. */
+	inline uint64 readData(uint32 value) const {
+		const byte *data = _data + value * (valueBits >> 3);
+
+		if (valueBits ==  8)
+			return *data;
+
+		if (isLE) {
+			if (valueBits == 16)
+				return READ_LE_UINT16(data);
+			if (valueBits == 32)
+				return READ_LE_UINT32(data);
+			if (valueBits == 64)
+				return READ_LE_UINT64(data);
+		} else {
+			if (valueBits == 16)
+				return READ_BE_UINT16(data);
+			if (valueBits == 32)
+				return READ_BE_UINT32(data);
+			if (valueBits == 64)
+				return READ_BE_UINT64(data);
+		}
+
+		assert(false);
+		return 0;
+	}
+
+	/** Read a unit. */
+	inline uint64 readUnit(uint32 unit) const {
+		if (valueBits != 64)
+			return readData(unit);
+
+		// Split 64-bit values into two halves, in the order the bits are handed out
+		const uint64 value = readData(unit >> 1);
+		if ((unit & 1) == (isMSB2LSB ? 1 : 0))
+			return value & 0xFFFFFFFFULL;
+
+		return value >> 32;
+	}
+
+	/** Fill up the cache as far as possible. */
+	inline void refill() {
+		while ((_cacheBits <= (64 - kUnitBits)) && (_unit < _unitCount)) {
+			const uint64 unit = readUnit(_unit++);
+
+			if (isMSB2LSB)
+				_cache |= unit << (64 - kUnitBits - _cacheBits);
+			else
+				_cache |= unit << _cacheBits;
+
+			_cacheBits += kUnitBits;
+		}
+	}
+
+	/** Extract n bits, 0 < n <= 32, from the cache. */
+	inline uint32 extract(uint8 n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+
+		return (uint32) (_cache & ((1ULL << n) - 1));
+	}
+
+	/** Remove n bits, 0 < n <= the number of cached bits, from the cache. */
+	inline void consume(uint8 n) {
+		if (n >= 64)
+			_cache = 0;
+		else if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+
+	void init(uint32 size) {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
+			throw Exception("BitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		// Only full data values are used
+		_unitCount = (size / (valueBits >> 3)) * (valueBits / kUnitBits);
+
+		rewind();
+	}
+
+	void readBuffer(SeekableReadStream &stream, uint32 size) {
+		byte *data = new byte[size];
+
+		if (stream.read(data, size) != size) {
+			delete[] data;
+			throw Exception(kReadError);
+		}
+
+		_data = data;
+		_disposeAfterUse = true;
+
+		init(size);
+	}
+
+public:
+	/** Create a bit stream over this memory buffer and optionally delete[] it on destruction. */
+	BitStreamMemoryImpl(const byte *data, uint32 size, bool disposeAfterUse = false) :
+		_data(data), _disposeAfterUse(disposeAfterUse) {
+
+		init(size);
+	}
+
+	/** Create a bit stream over the whole contents of this stream. */
+	BitStreamMemoryImpl(SeekableReadStream &stream) : _data(0), _disposeAfterUse(false) {
+		if (!stream.seek(0))
+			throw Exception(kSeekError);
+
+		readBuffer(stream, stream.size());
+	}
+
+	/** Create a bit stream over the next size bytes of this stream. */
+	BitStreamMemoryImpl(SeekableReadStream &stream, uint32 size) : _data(0), _disposeAfterUse(false) {
+		readBuffer(stream, size);
+	}
+
+	~BitStreamMemoryImpl() {
+		if (_disposeAfterUse)
+			delete[] _data;
+	}
+
+	/** Read a bit from the bit stream. */
+	uint32 getBit() {
+		return getBits(1);
+	}
+
+	/** Read a multi-bit value from the bit stream. */
+	inline uint32 getBits(uint8 n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (n == 0)
+			return 0;
+
+		if (_cacheBits < n) {
+			refill();
+
+			if (_cacheBits < n)
+				throw Exception("BitStream::readValue(): End of bit stream reached");
+		}
+
+		const uint32 v = extract(n);
+		consume(n);
+
+		return v;
+	}
+
+	/** Read a multi-bit value from the bit stream, without consuming it. */
+	inline uint32 peekBits(uint8 n) {
+		if (n > 32)
+			throw Exception("Too many bits requested to be peeked");
+
+		if (n == 0)
+			return 0;
+
+		if (_cacheBits < n)
+			refill();
+
+		// Bits past the end of the stream are never set in the cache
+		return extract(n);
+	}
+
+	/** Add a bit to the value x, making it an n-bit value. */
+	void addBit(uint32 &x, uint32 n) {
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_unit = 0;
+
+		_cache     = 0;
+		_cacheBits = 0;
+	}
+
+	/** Skip the specified amount of bits. */
+	inline void skip(uint32 n) {
+		if (n <= _cacheBits) {
+			consume(n);
+			return;
+		}
+
+		n -= _cacheBits;
+
+		_cache     = 0;
+		_cacheBits = 0;
+
+		// Jump over whole units without reading them
+		const uint32 units = n / kUnitBits;
+		if (units > (_unitCount - _unit))
+			throw Exception("BitStream::readValue(): End of bit stream reached");
+
+		_unit += units;
+		n     -= units * kUnitBits;
+
+		getBits(n);
+	}
+
+	/** Return the stream position in bits. */
+	uint32 pos() const {
+		return _unit * kUnitBits - _cacheBits;
+	}
+
+	/** Return the stream size in bits. */
+	uint32 size() const {
+		return _unitCount * kUnitBits;
+	}
+
+	bool eos() const {
+		return pos() >= size();
+	}
+};
+
 // typedefs for various memory layouts.
 
 /** 8-bit data, MSB to LSB. */
@@ -273,6 +567,40 @@ typedef BitStreamImpl<64, false, true > BitStream64BEMSB;
 /** 64-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<64, false, false> BitStream64BELSB;
 
+// typedefs for various memory layouts, reading from memory buffers.
+
+/** 8-bit data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<8, false, true > BitStreamMemory8MSB;
+/** 8-bit data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<8, false, false> BitStreamMemory8LSB;
+
+/** 16-bit little-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<16, true , true > BitStreamMemory16LEMSB;
+/** 16-bit little-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<16, true , false> BitStreamMemory16LELSB;
+/** 16-bit big-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<16, false, true > BitStreamMemory16BEMSB;
+/** 16-bit big-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<16, false, false> BitStreamMemory16BELSB;
+
+/** 32-bit little-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<32, true , true > BitStreamMemory32LEMSB;
+/** 32-bit little-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<32, true , false> BitStreamMemory32LELSB;
+/** 32-bit big-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<32, false, true > BitStreamMemory32BEMSB;
+/** 32-bit big-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<32, false, false> BitStreamMemory32BELSB;
+
+/** 64-bit little-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<64, true , true > BitStreamMemory64LEMSB;
+/** 64-bit little-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<64, true , false> BitStreamMemory64LELSB;
+/** 64-bit big-endian data in memory, MSB to LSB. */
+typedef BitStreamMemoryImpl<64, false, true > BitStreamMemory64BEMSB;
+/** 64-bit big-endian data in memory, LSB to MSB. */
+typedef BitStreamMemoryImpl<64, false, false> BitStreamMemory64BELSB;
+
 } // End of namespace Common
 
 #endif // COMMON_BITSTREAM_H
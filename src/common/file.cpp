@@ -27,6 +27,18 @@
  *  File classes implementing the stream interfaces.
  */
 
+#if defined(WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined(UNIX)
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "common/util.h"
 #include "common/file.h"
 #include "common/error.h"
 #include "common/ustring.h"
@@ -182,4 +194,137 @@ uint32 DumpFile::write(const void *dataPtr, uint32 dataSize) {
 	return std::fwrite(dataPtr, 1, dataSize, _handle);
 }
 
+
+/** The actual memory mapping of a MappedFile. */
+class MappedFile::Mapping : public NonCopyable {
+public:
+	Mapping(const byte *data, uint32 size) : _data(data), _size(size) {
+	}
+
+	~Mapping() {
+#if defined(WIN32)
+		UnmapViewOfFile(_data);
+#elif defined(UNIX)
+		munmap(const_cast<byte *>(_data), _size);
+#endif
+	}
+
+	const byte *getData() const {
+		return _data;
+	}
+
+	uint32 getSize() const {
+		return _size;
+	}
+
+private:
+	const byte *_data;
+	uint32      _size;
+};
+
+/** A stream viewing a part of a mapping, keeping the mapping alive. */
+class MappedReadStream : public MemoryReadStream {
+public:
+	MappedReadStream(const boost::shared_ptr<MappedFile::Mapping> &mapping, uint32 offset, uint32 size) :
+		MemoryReadStream(mapping->getData() + offset, size), _mapping(mapping) {
+	}
+
+private:
+	boost::shared_ptr<MappedFile::Mapping> _mapping;
+};
+
+
+MappedFile::MappedFile() {
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const UString &fileName) {
+	assert(!isOpen());
+
+#if defined(WIN32)
+
+	HANDLE file = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+	                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD sizeHigh = 0;
+	DWORD size     = GetFileSize(file, &sizeHigh);
+	if ((size == INVALID_FILE_SIZE) || (sizeHigh != 0) || (size == 0) || (size > 0x7FFFFFFF)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE map = CreateFileMapping(file, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(file);
+
+	if (!map)
+		return false;
+
+	const void *data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(map);
+
+	if (!data)
+		return false;
+
+	_mapping.reset(new Mapping((const byte *) data, size));
+	return true;
+
+#elif defined(UNIX)
+
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size <= 0) || (st.st_size > 0x7FFFFFFF)) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	_mapping.reset(new Mapping((const byte *) data, st.st_size));
+	return true;
+
+#else
+
+	// No way to map files on this platform
+	return false;
+
+#endif
+}
+
+void MappedFile::close() {
+	_mapping.reset();
+}
+
+bool MappedFile::isOpen() const {
+	return _mapping.get() != 0;
+}
+
+uint32 MappedFile::size() const {
+	if (!_mapping)
+		return 0;
+
+	return _mapping->getSize();
+}
+
+SeekableReadStream *MappedFile::createReadStream(uint32 offset, uint32 size) const {
+	if (!_mapping)
+		throw Exception("File not mapped");
+
+	if ((offset > _mapping->getSize()) || (size > (_mapping->getSize() - offset)))
+		throw Exception(kReadError);
+
+	return new MappedReadStream(_mapping, offset, size);
+}
+
 } // End of namespace Common
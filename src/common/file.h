@@ -32,6 +32,8 @@
 
 #include <cstdio>
 
+#include "boost/shared_ptr.hpp"
+
 #include "common/types.h"
 #include "common/stream.h"
 #include "common/noncopyable.h"
@@ -132,6 +134,57 @@ protected:
 	int32 _size;        ///< The file's size.
 };
 
+/** A read-only, memory-mapped file.
+ *
+ *  Streams created out of a mapped file view the mapping directly, without
+ *  copying the data. The mapping stays valid until the MappedFile is closed
+ *  and the last of those streams has been destroyed.
+ */
+class MappedFile : public NonCopyable {
+public:
+	MappedFile();
+	~MappedFile();
+
+	/**
+	 * Try to map the file with the given fileName into memory.
+	 * @note Must not be called if this file already is open (i.e. if isOpen returns true).
+	 *
+	 * @param  fileName the name of the file to map
+	 * @return true if the file was mapped successfully, false otherwise
+	 */
+	bool open(const UString &fileName);
+
+	/**
+	 * Unmap the file, if mapped.
+	 */
+	void close();
+
+	/**
+	 * Checks if the object mapped a file successfully.
+	 *
+	 * @return true if any file is mapped, false otherwise.
+	 */
+	bool isOpen() const;
+
+	/** Return the size of the mapped file. */
+	uint32 size() const;
+
+	/** Create a stream viewing a part of the mapped file.
+	 *
+	 *  @param  offset The offset of the data within the file.
+	 *  @param  size The size of the data.
+	 *  @return A stream viewing the data.
+	 */
+	SeekableReadStream *createReadStream(uint32 offset, uint32 size) const;
+
+private:
+	class Mapping;
+
+	boost::shared_ptr<Mapping> _mapping; ///< The mapping, shared with all created streams.
+
+	friend class MappedReadStream;
+};
+
 } // End of namespace Common
 
 #endif // COMMON_FILE_H
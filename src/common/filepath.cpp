@@ -42,6 +42,7 @@ using boost::filesystem::exists;
 using boost::filesystem::is_regular_file;
 using boost::filesystem::is_directory;
 using boost::filesystem::file_size;
+using boost::filesystem::last_write_time;
 using boost::filesystem::directory_iterator;
 
 // boost-string_algo
@@ -73,6 +74,16 @@ uint32 FilePath::getFileSize(const UString &p) {
 	return size;
 }
 
+uint32 FilePath::getModificationTime(const UString &p) {
+	boost::system::error_code error;
+
+	std::time_t time = last_write_time(p.c_str(), error);
+	if (error)
+		return kFileInvalid;
+
+	return time;
+}
+
 UString FilePath::getStem(const UString &p) {
 	path file(p.c_str());
 
@@ -63,6 +63,13 @@ public:
 	 */
 	static uint32 getFileSize(const UString &p);
 
+	/** Return a file's last modification time.
+	 *
+	 *  @param  p The file or directory to look up.
+	 *  @return The modification time as a UNIX timestamp or kFileInvalid if not valid.
+	 */
+	static uint32 getModificationTime(const UString &p);
+
 	/** Return a file name's stem.
 	 *
 	 *  Example: "/path/to/file.ext" -> "file"
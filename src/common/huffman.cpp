@@ -28,6 +28,7 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include "common/huffman.h"
 #include "common/util.h"
@@ -36,7 +37,21 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+/** The maximal number of bits looked up in one table. */
+static const uint8 kMaxTableBits = 9;
+
+static inline uint32 lengthMask(uint8 length) {
+	return (length >= 32) ? 0xFFFFFFFF : ((1 << length) - 1);
+}
+
+Huffman::Code::Code(uint32 c, uint8 l, uint32 i) : code(c), length(l), index(i) {
+}
+
+bool Huffman::Code::operator<(const Code &c) const {
+	return length < c.length;
+}
+
+Huffman::Entry::Entry() : value(0), length(0) {
 }
 
 
@@ -64,18 +79,89 @@ void Huffman::init(uint8 maxLength, uint32 codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
+	setSymbols(symbols);
+
+	CodeList codeList;
+	codeList.reserve(codeCount);
+
+	for (uint32 i = 0; i < codeCount; i++)
+		if (lengths[i] > 0)
+			codeList.push_back(Code(codes[i] & lengthMask(lengths[i]), lengths[i], i));
+
+	// Shorter codes take precedence over longer ones with the same prefix
+	std::stable_sort(codeList.begin(), codeList.end());
+
+	_tableBits = MAX<uint8>(MIN(maxLength, kMaxTableBits), 1);
+
+	for (int i = 0; i < 2; i++) {
+		_tables[i].resize(1 << _tableBits);
+
+		buildTable(_tables[i], 0, _tableBits, codeList, i == 1);
+	}
+}
+
+void Huffman::buildTable(Table &table, uint32 offset, uint8 tableBits,
+                         const CodeList &codes, bool msbFirst) {
+
+	std::vector<uint8> subTableBits(1 << tableBits, 0);
+
+	for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		if (c->length <= tableBits) {
+			// The code fits into this table: fill all entries starting with it
 
-	for (uint32 i = 0; i < codeCount; i++) {
-		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+			const uint8 fill = tableBits - c->length;
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+			for (uint32 i = 0; i < (1U << fill); i++) {
+				const uint32 n = msbFirst ? ((c->code << fill) | i) : (c->code | (i << c->length));
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+				Entry &entry = table[offset + n];
+				if (entry.length != 0)
+					continue;
+
+				entry.value  = c->index;
+				entry.length = c->length;
+			}
+
+		} else {
+			// The code needs a sub-table
+
+			const uint32 n = msbFirst ? (c->code >> (c->length - tableBits)) : (c->code & lengthMask(tableBits));
+
+			subTableBits[n] = MAX<uint8>(subTableBits[n], MIN<uint8>(c->length - tableBits, kMaxTableBits));
+		}
+	}
+
+	for (uint32 n = 0; n < subTableBits.size(); n++) {
+		if ((subTableBits[n] == 0) || (table[offset + n].length != 0))
+			continue;
+
+		// Collect the rest of all codes escaping into this sub-table
+
+		CodeList subCodes;
+		for (CodeList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+			if (c->length <= tableBits)
+				continue;
+
+			const uint8 length = c->length - tableBits;
+
+			if (msbFirst) {
+				if ((c->code >> length) == n)
+					subCodes.push_back(Code(c->code & lengthMask(length), length, c->index));
+			} else {
+				if ((c->code & lengthMask(tableBits)) == n)
+					subCodes.push_back(Code(c->code >> tableBits, length, c->index));
+			}
+		}
+
+		const uint32 subOffset = table.size();
+
+		table.resize(subOffset + (1 << subTableBits[n]));
+
+		table[offset + n].value  = subOffset;
+		table[offset + n].length = -((int8) subTableBits[n]);
+
+		buildTable(table, subOffset, subTableBits[n], subCodes, msbFirst);
 	}
 }
 
@@ -84,18 +170,32 @@ Huffman::~Huffman() {
 
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (uint32 i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
 uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+	const Table &table = _tables[bits.isMSBFirst() ? 1 : 0];
+
+	uint32 offset    = 0;
+	uint8  tableBits = _tableBits;
+
+	while (true) {
+		const Entry &entry = table[offset + bits.peekBits(tableBits)];
+
+		if (entry.length > 0) {
+			// Found the code
+			bits.skip(entry.length);
+			return _symbols[entry.value];
+		}
+
+		if (entry.length == 0)
+			break;
 
-	for (uint32 i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+		// Escape into the sub-table
+		bits.skip(tableBits);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		offset    = entry.value;
+		tableBits = -entry.length;
 	}
 
 	throw Exception("Unknown Huffman code");
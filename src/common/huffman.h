@@ -31,7 +31,6 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "common/types.h"
 
@@ -48,7 +47,12 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  The codes are decoded with multi-level lookup tables: a symbol is found by
+ *  peeking at a fixed number of bits and looking them up in the root table,
+ *  with longer codes escaping into sub-tables.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -71,25 +75,48 @@ public:
 	uint32 getSymbol(BitStream &bits) const;
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	/** A code as seen from within one lookup table. */
+	struct Code {
+		uint32 code;   ///< The bits of the code not yet consumed.
+		uint8  length; ///< The number of bits not yet consumed.
+		uint32 index;  ///< The index of the code.
+
+		Code(uint32 c, uint8 l, uint32 i);
+
+		/** Order codes by their length. */
+		bool operator<(const Code &c) const;
+	};
 
-		Symbol(uint32 c, uint32 s);
+	/** An entry in a lookup table. */
+	struct Entry {
+		/** The index of the code if length > 0, the offset of the sub-table if length < 0. */
+		uint32 value;
+		/** The code length left if > 0, the negated sub-table size in bits if < 0, 0 if invalid. */
+		int8 length;
+
+		Entry();
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	typedef std::vector<Code>   CodeList;
+	typedef std::vector<Entry>  Table;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** The number of bits looked up at once. */
+	uint8 _tableBits;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** The lookup tables for bit streams reading LSB first (0) and MSB first (1).
+	 *
+	 *  Each starts with the root table, followed by the sub-tables for longer codes.
+	 */
+	Table _tables[2];
+
+	/** The symbols of all codes, by code index. */
+	std::vector<uint32> _symbols;
 
 	void init(uint8 maxLength, uint32 codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	void buildTable(Table &table, uint32 offset, uint8 tableBits,
+	                const CodeList &codes, bool msbFirst);
 };
 
 } // End of namespace Common
@@ -0,0 +1,130 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file common/memreader.cpp
+ *  A fast, non-virtual reader over a block of memory.
+ */
+
+#include "common/memreader.h"
+#include "common/util.h"
+#include "common/stream.h"
+#include "common/ustring.h"
+#include "common/error.h"
+
+namespace Common {
+
+MemoryReader::MemoryReader() : _data(0), _size(0), _pos(0) {
+}
+
+MemoryReader::MemoryReader(const byte *data, uint32 size) : _data(data), _size(size), _pos(0) {
+}
+
+MemoryReader::MemoryReader(SeekableReadStream &stream) : _data(0), _size(0), _pos(0) {
+	load(stream, 0, stream.size());
+}
+
+MemoryReader::MemoryReader(SeekableReadStream &stream, uint32 offset, uint32 size) :
+	_data(0), _size(0), _pos(0) {
+
+	load(stream, offset, size);
+}
+
+void MemoryReader::load(SeekableReadStream &stream, uint32 offset, uint32 size) {
+	if ((offset > (uint32) stream.size()) || (size > ((uint32) stream.size() - offset)))
+		throw Exception(kReadError);
+
+	// If the data is in memory already, just look at it
+	MemoryReadStream *memory = dynamic_cast<MemoryReadStream *>(&stream);
+	if (memory && memory->getData()) {
+		_data = memory->getData() + offset;
+		_size = size;
+		return;
+	}
+
+	_buffer.reset(new byte[size]);
+
+	if (!stream.seek(offset))
+		throw Exception(kSeekError);
+	if (stream.read(_buffer.get(), size) != size)
+		throw Exception(kReadError);
+
+	_data = _buffer.get();
+	_size = size;
+}
+
+MemoryReader MemoryReader::getSubReader(uint32 offset, uint32 size) const {
+	if ((offset > _size) || (size > (_size - offset)))
+		throwReadError();
+
+	MemoryReader reader(*this);
+
+	reader._data = _data + offset;
+	reader._size = size;
+	reader._pos  = 0;
+
+	return reader;
+}
+
+UString MemoryReader::readFixedASCII(uint32 length) {
+	const char *str = (const char *) take(length);
+
+	uint32 n = 0;
+	while ((n < length) && (str[n] != '\0'))
+		n++;
+
+	return UString(str, n);
+}
+
+UString MemoryReader::readStringASCII() {
+	const char *str = (const char *) _data + _pos;
+
+	uint32 n = 0;
+	while (((_pos + n) < _size) && (str[n] != '\0'))
+		n++;
+
+	// Skip the terminating 0, if there is one
+	_pos += MIN<uint32>(n + 1, _size - _pos);
+
+	return UString(str, n);
+}
+
+MemoryReadStream *MemoryReader::readStream(uint32 size) {
+	const byte *data = take(size);
+
+	byte *copy = new byte[size];
+	std::memcpy(copy, data, size);
+
+	return new MemoryReadStream(copy, size, true);
+}
+
+void MemoryReader::throwReadError() {
+	throw Exception(kReadError);
+}
+
+void MemoryReader::throwSeekError() {
+	throw Exception(kSeekError);
+}
+
+} // End of namespace Common
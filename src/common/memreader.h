@@ -0,0 +1,298 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file common/memreader.h
+ *  A fast, non-virtual reader over a block of memory.
+ */
+
+#ifndef COMMON_MEMREADER_H
+#define COMMON_MEMREADER_H
+
+#include <cstring>
+
+#include "boost/shared_array.hpp"
+
+#include "common/types.h"
+#include "common/endianness.h"
+
+namespace Common {
+
+class UString;
+class SeekableReadStream;
+class MemoryReadStream;
+
+/** A fast reader over a block of memory.
+ *
+ *  Unlike a ReadStream, nothing here is virtual: all the endian reads are
+ *  inlined and read directly out of the memory block. Every read is
+ *  bounds-checked and throws a kReadError exception when it would run
+ *  past the end of the data.
+ *
+ *  A reader created out of a memory stream (or a mapped file's stream)
+ *  views the stream's memory directly and is only valid as long as the
+ *  stream is. Other streams are read into a buffer owned by the reader.
+ *  Copies of a reader share the data, but each has its own position.
+ */
+class MemoryReader {
+public:
+	/** Create an empty reader. */
+	MemoryReader();
+	/** View this block of memory, which has to stay valid. */
+	MemoryReader(const byte *data, uint32 size);
+	/** Read the complete stream. */
+	MemoryReader(SeekableReadStream &stream);
+	/** Read size bytes of the stream, starting at offset. */
+	MemoryReader(SeekableReadStream &stream, uint32 offset, uint32 size);
+
+	/** Return the size of the data. */
+	uint32 size() const {
+		return _size;
+	}
+
+	/** Return the current position within the data. */
+	uint32 pos() const {
+		return _pos;
+	}
+
+	/** Has the end of the data been reached? */
+	bool eos() const {
+		return _pos >= _size;
+	}
+
+	/** Return the data itself. */
+	const byte *getData() const {
+		return _data;
+	}
+
+	/** Does the reader hold its own copy of the data, independent of any stream? */
+	bool ownsData() const {
+		return _buffer.get() != 0;
+	}
+
+	/** Seek to this offset from the start of the data. */
+	void seek(uint32 offset) {
+		if (offset > _size)
+			throwSeekError();
+
+		_pos = offset;
+	}
+
+	/** Skip this many bytes. */
+	void skip(uint32 n) {
+		if (n > (_size - _pos))
+			throwSeekError();
+
+		_pos += n;
+	}
+
+	/** Return a reader viewing a part of this reader's data. */
+	MemoryReader getSubReader(uint32 offset, uint32 size) const;
+
+	/** Read dataSize bytes into dataPtr. */
+	void read(void *dataPtr, uint32 dataSize) {
+		std::memcpy(dataPtr, take(dataSize), dataSize);
+	}
+
+	byte readByte() {
+		return *take(1);
+	}
+
+	int8 readSByte() {
+		return (int8) *take(1);
+	}
+
+	uint16 readUint16LE() {
+		return READ_LE_UINT16(take(2));
+	}
+
+	uint32 readUint32LE() {
+		return READ_LE_UINT32(take(4));
+	}
+
+	uint64 readUint64LE() {
+		return READ_LE_UINT64(take(8));
+	}
+
+	uint16 readUint16BE() {
+		return FROM_BE_16(READ_UINT16(take(2)));
+	}
+
+	uint32 readUint32BE() {
+		return FROM_BE_32(READ_UINT32(take(4)));
+	}
+
+	uint64 readUint64BE() {
+		return FROM_BE_64(READ_UINT64(take(8)));
+	}
+
+	int16 readSint16LE() {
+		return (int16) readUint16LE();
+	}
+
+	int32 readSint32LE() {
+		return (int32) readUint32LE();
+	}
+
+	int64 readSint64LE() {
+		return (int64) readUint64LE();
+	}
+
+	int16 readSint16BE() {
+		return (int16) readUint16BE();
+	}
+
+	int32 readSint32BE() {
+		return (int32) readUint32BE();
+	}
+
+	int64 readSint64BE() {
+		return (int64) readUint64BE();
+	}
+
+	float readIEEEFloatLE() {
+		return toFloat(readUint32LE());
+	}
+
+	float readIEEEFloatBE() {
+		return toFloat(readUint32BE());
+	}
+
+	double readIEEEDoubleLE() {
+		return toDouble(readUint64LE());
+	}
+
+	double readIEEEDoubleBE() {
+		return toDouble(readUint64BE());
+	}
+
+	/** Read an array of count little endian 16-bit values. */
+	void readArrayUint16LE(uint16 *values, uint32 count) {
+		readArray(values, count);
+#ifdef EOS_BIG_ENDIAN
+		swapArray(values, count);
+#endif
+	}
+
+	/** Read an array of count little endian 32-bit values. */
+	void readArrayUint32LE(uint32 *values, uint32 count) {
+		readArray(values, count);
+#ifdef EOS_BIG_ENDIAN
+		swapArray(values, count);
+#endif
+	}
+
+	/** Read an array of count big endian 16-bit values. */
+	void readArrayUint16BE(uint16 *values, uint32 count) {
+		readArray(values, count);
+#ifdef EOS_LITTLE_ENDIAN
+		swapArray(values, count);
+#endif
+	}
+
+	/** Read an array of count big endian 32-bit values. */
+	void readArrayUint32BE(uint32 *values, uint32 count) {
+		readArray(values, count);
+#ifdef EOS_LITTLE_ENDIAN
+		swapArray(values, count);
+#endif
+	}
+
+	/** Read an array of count little endian IEEE floats. */
+	void readArrayIEEEFloatLE(float *values, uint32 count) {
+		readArray(values, count);
+#ifdef EOS_BIG_ENDIAN
+		swapArray(reinterpret_cast<uint32 *>(values), count);
+#endif
+	}
+
+	/** Read a fixed-size ASCII string field, which ends at the first 0. */
+	UString readFixedASCII(uint32 length);
+	/** Read a 0-terminated ASCII string. */
+	UString readStringASCII();
+
+	/** Copy size bytes into a new stream. */
+	MemoryReadStream *readStream(uint32 size);
+
+private:
+	boost::shared_array<byte> _buffer; ///< The data, if we own it.
+
+	const byte *_data;
+	uint32 _size;
+	uint32 _pos;
+
+	void load(SeekableReadStream &stream, uint32 offset, uint32 size);
+
+	/** Return the next n bytes and move past them. */
+	const byte *take(uint32 n) {
+		if (n > (_size - _pos))
+			throwReadError();
+
+		const byte *data = _data + _pos;
+		_pos += n;
+
+		return data;
+	}
+
+	template<typename T>
+	void readArray(T *values, uint32 count) {
+		if (count > ((_size - _pos) / sizeof(T)))
+			throwReadError();
+
+		std::memcpy(values, take(count * sizeof(T)), count * sizeof(T));
+	}
+
+	static void swapArray(uint16 *values, uint32 count) {
+		while (count-- > 0) {
+			*values = SWAP_BYTES_16(*values);
+			values++;
+		}
+	}
+
+	static void swapArray(uint32 *values, uint32 count) {
+		while (count-- > 0) {
+			*values = SWAP_BYTES_32(*values);
+			values++;
+		}
+	}
+
+	static float toFloat(uint32 data) {
+		float value;
+		std::memcpy(&value, &data, 4);
+		return value;
+	}
+
+	static double toDouble(uint64 data) {
+		double value;
+		std::memcpy(&value, &data, 8);
+		return value;
+	}
+
+	static void throwReadError();
+	static void throwSeekError();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MEMREADER_H
@@ -684,6 +684,9 @@ public:
 
 	void setEnc(byte value) { _encbyte = value; }
 
+	/** Return the stream's memory, or 0 if it's encrypted and can't be used directly. */
+	const byte *getData() const { return _encbyte ? 0 : _ptrOrig; }
+
 	uint32 read(void *dataPtr, uint32 dataSize);
 
 	bool eos() const { return _eos; }
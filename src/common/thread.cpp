@@ -49,9 +49,15 @@ bool Thread::createThread() {
 		// Already running, nothing to do
 		return true;
 
+	// Mark the thread as running right away, so that a destroyThread() that
+	// comes before the thread was even scheduled still waits for it
+	_threadRunning = true;
+
 	// Try to create the thread
-	if (!(_thread = SDL_CreateThread(threadHelper, (void *) this)))
+	if (!(_thread = SDL_CreateThread(threadHelper, (void *) this))) {
+		_threadRunning = false;
 		return false;
+	}
 
 	return true;
 }
@@ -0,0 +1,189 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file common/threadpool.cpp
+ *  A pool of worker threads.
+ */
+
+#include "common/threadpool.h"
+#include "common/util.h"
+#include "common/error.h"
+
+/** How long an idle worker waits before checking whether it should end (in ms). */
+static const uint32 kWorkerTimeout = 100;
+
+namespace Common {
+
+ThreadPool::Job::Job() : _owned(false) {
+}
+
+ThreadPool::Job::~Job() {
+}
+
+
+ThreadPool::Worker::Worker(ThreadPool &pool) : _pool(&pool) {
+}
+
+ThreadPool::Worker::~Worker() {
+	destroyThread();
+}
+
+void ThreadPool::Worker::stop() {
+	_killThread = true;
+}
+
+void ThreadPool::Worker::threadMethod() {
+	while (!_killThread) {
+		if (!_pool->_queued.lock(kWorkerTimeout))
+			continue;
+
+		Job *job = _pool->takeJob();
+		if (!job)
+			continue;
+
+		// Jobs are supposed to handle their errors themselves
+		try {
+			job->run();
+		} catch (Exception &e) {
+			printException(e, "WARNING: ");
+		} catch (...) {
+			warning("ThreadPool: Job threw an unknown exception");
+		}
+
+		_pool->finishJob(job);
+	}
+}
+
+
+ThreadPool::ThreadPool(uint threadCount) : _pending(0), _queued(0), _finished(0) {
+	_workers.reserve(threadCount);
+
+	for (uint i = 0; i < threadCount; i++) {
+		Worker *worker = new Worker(*this);
+
+		if (!worker->createThread()) {
+			delete worker;
+			break;
+		}
+
+		_workers.push_back(worker);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	wait();
+
+	// Tell all workers to end and wake them all up at once, so that they
+	// don't each have to wait for their timeout one after the other
+	for (std::vector<Worker *>::iterator w = _workers.begin(); w != _workers.end(); ++w)
+		(*w)->stop();
+
+	for (uint i = 0; i < _workers.size(); i++)
+		_queued.unlock();
+
+	for (std::vector<Worker *>::iterator w = _workers.begin(); w != _workers.end(); ++w)
+		delete *w;
+}
+
+uint ThreadPool::getThreadCount() const {
+	return _workers.size();
+}
+
+void ThreadPool::add(Job &job) {
+	// Without any worker threads, just run the job directly
+	if (_workers.empty()) {
+		job.run();
+		return;
+	}
+
+	_mutex.lock();
+
+	_jobs.push_back(&job);
+	_pending++;
+
+	_mutex.unlock();
+
+	_queued.unlock();
+}
+
+void ThreadPool::add(Job *job) {
+	if (!job)
+		return;
+
+	job->_owned = true;
+
+	if (_workers.empty()) {
+		try {
+			job->run();
+		} catch (...) {
+			delete job;
+			throw;
+		}
+
+		delete job;
+		return;
+	}
+
+	add(*job);
+}
+
+void ThreadPool::wait() {
+	for (;;) {
+		_mutex.lock();
+		bool done = _pending == 0;
+		_mutex.unlock();
+
+		if (done)
+			break;
+
+		_finished.lock(kWorkerTimeout);
+	}
+}
+
+ThreadPool::Job *ThreadPool::takeJob() {
+	StackLock lock(_mutex);
+
+	if (_jobs.empty())
+		return 0;
+
+	Job *job = _jobs.front();
+	_jobs.pop_front();
+
+	return job;
+}
+
+void ThreadPool::finishJob(Job *job) {
+	if (job->_owned)
+		delete job;
+
+	_mutex.lock();
+	bool done = --_pending == 0;
+	_mutex.unlock();
+
+	if (done)
+		_finished.unlock();
+}
+
+} // End of namespace Common
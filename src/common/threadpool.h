@@ -0,0 +1,116 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file common/threadpool.h
+ *  A pool of worker threads.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include <list>
+#include <vector>
+
+#include "common/types.h"
+#include "common/noncopyable.h"
+#include "common/thread.h"
+#include "common/mutex.h"
+
+namespace Common {
+
+/** A pool of worker threads running queued jobs. */
+class ThreadPool : NonCopyable {
+public:
+	/** A job to be run by a thread pool. */
+	class Job {
+	public:
+		Job();
+		virtual ~Job();
+
+		/** Do the actual work. Called from within one of the worker threads. */
+		virtual void run() = 0;
+
+	private:
+		bool _owned; ///< Does the pool delete the job once it was run?
+
+		friend class ThreadPool;
+	};
+
+	ThreadPool(uint threadCount);
+	~ThreadPool();
+
+	/** Return the number of worker threads. */
+	uint getThreadCount() const;
+
+	/** Queue a job.
+	 *
+	 *  The pool does not take over the job. It has to stay valid until
+	 *  wait() returned.
+	 */
+	void add(Job &job);
+
+	/** Queue a job, taking over its ownership.
+	 *
+	 *  The pool deletes the job after it has been run. This allows queueing
+	 *  jobs that nobody is waiting for.
+	 */
+	void add(Job *job);
+
+	/** Wait until all queued jobs have been run. */
+	void wait();
+
+private:
+	/** A worker thread, taking jobs out of the queue. */
+	class Worker : public Thread {
+	public:
+		Worker(ThreadPool &pool);
+		~Worker();
+
+		/** Tell the worker to end once it wakes up, without waiting for it. */
+		void stop();
+
+	private:
+		ThreadPool *_pool;
+
+		void threadMethod();
+	};
+
+	std::vector<Worker *> _workers;
+
+	std::list<Job *> _jobs; ///< Jobs waiting to be run.
+	uint32 _pending;        ///< Jobs that are waiting or currently running.
+
+	Mutex _mutex;
+
+	Semaphore _queued;   ///< Posted for every queued job.
+	Semaphore _finished; ///< Posted whenever the last pending job finished.
+
+	Job *takeJob();
+	void finishJob(Job *job);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_THREADPOOL_H
@@ -63,6 +63,14 @@ public:
 		}
 	};
 
+	// Case insensitive equality
+	struct iequal : std::binary_function<UString, UString, bool>
+	{
+		bool operator() (const UString &str1, const UString &str2) const {
+			return str1.equalsIgnoreCase(str2);
+		}
+	};
+
 	UString(const UString &str);
 	UString(const std::string &str);
 	UString(const char *str = "");
@@ -686,6 +686,8 @@ Console::Console(const Common::UString &font, int fontHeight) : _neverShown(true
 			"Usage: playsound <sound>\nPlay the specified sound");
 	registerCommand("silence"    , boost::bind(&Console::cmdSilence    , this, _1),
 			"Usage: silence\nStop all playing sounds and music");
+	registerCommand("soundcache" , boost::bind(&Console::cmdSoundCache , this, _1),
+			"Usage: soundcache [clear]\nShow the decoded sound cache's statistics, or clear it");
 
 	_console->setPrompt(kPrompt);
 
@@ -1152,6 +1154,27 @@ void Console::cmdSilence(const CommandLine &cl) {
 	SoundMan.stopAll();
 }
 
+void Console::cmdSoundCache(const CommandLine &cl) {
+	if (cl.args == "clear") {
+		SoundMan.getSampleCache().clear();
+		return;
+	}
+
+	if (!cl.args.empty()) {
+		printCommandHelp(cl.cmd);
+		return;
+	}
+
+	Sound::SampleCache::Stats stats;
+	SoundMan.getSampleCache().getStats(stats);
+
+	const uint32 lookups = stats.hits + stats.misses;
+	const double hitRate = (lookups > 0) ? ((100.0 * stats.hits) / lookups) : 0.0;
+
+	printf("%u sounds cached, using %u of %u KB", stats.sounds, stats.size / 1024, stats.maxSize / 1024);
+	printf("%u hits, %u misses (%.1f%% hit rate)", stats.hits, stats.misses, hitRate);
+}
+
 void Console::printCommandHelp(const Common::UString &cmd) {
 	CommandMap::const_iterator c = _commands.find(cmd);
 	if (c == _commands.end()) {
@@ -278,6 +278,7 @@ private:
 	void cmdListSounds (const CommandLine &cl);
 	void cmdPlaySound  (const CommandLine &cl);
 	void cmdSilence    (const CommandLine &cl);
+	void cmdSoundCache (const CommandLine &cl);
 
 	void updateHelpArguments();
 
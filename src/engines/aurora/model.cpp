@@ -50,6 +50,11 @@ void unregisterModelLoader() {
 	kModelLoader = 0;
 }
 
+void clearModelCache() {
+	if (kModelLoader)
+		kModelLoader->clearCache();
+}
+
 Graphics::Aurora::Model *loadModelObject(const Common::UString &resref,
                                          const Common::UString &texture) {
 	assert(kModelLoader);
@@ -58,7 +63,7 @@ Graphics::Aurora::Model *loadModelObject(const Common::UString &resref,
 
 	try {
 
-		model = kModelLoader->load(resref, Graphics::Aurora::kModelTypeObject, texture);
+		model = kModelLoader->get(resref, Graphics::Aurora::kModelTypeObject, texture);
 
 	} catch (Common::Exception &e) {
 
@@ -77,7 +82,7 @@ Graphics::Aurora::Model *loadModelGUI(const Common::UString &resref) {
 
 	try {
 
-		model = kModelLoader->load(resref, Graphics::Aurora::kModelTypeGUIFront, "");
+		model = kModelLoader->get(resref, Graphics::Aurora::kModelTypeGUIFront, "");
 
 	} catch (Common::Exception &e) {
 
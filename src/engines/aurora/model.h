@@ -43,6 +43,9 @@ class ModelLoader;
 void registerModelLoader(ModelLoader *loader);
 void unregisterModelLoader();
 
+/** Free all models kept around for sharing their data with later loads. */
+void clearModelCache();
+
 Graphics::Aurora::Model *loadModelObject(const Common::UString &resref,
                                          const Common::UString &texture = "");
 Graphics::Aurora::Model *loadModelGUI   (const Common::UString &resref);
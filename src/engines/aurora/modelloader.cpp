@@ -28,12 +28,69 @@
  */
 
 #include "graphics/aurora/model.h"
+#include "graphics/aurora/textureman.h"
 
 #include "engines/aurora/modelloader.h"
 
 namespace Engines {
 
+ModelLoader::ModelID::ModelID(const Common::UString &r, Graphics::Aurora::ModelType y,
+		const Common::UString &t) : resref(r), texture(t), type(y) {
+
+	resref.tolower();
+	texture.tolower();
+}
+
+bool ModelLoader::ModelID::operator<(const ModelID &right) const {
+	if (type != right.type)
+		return type < right.type;
+	if (resref != right.resref)
+		return resref < right.resref;
+
+	return texture < right.texture;
+}
+
+
+ModelLoader::ModelLoader() {
+}
+
 ModelLoader::~ModelLoader() {
+	clearCache();
+}
+
+Graphics::Aurora::Model *ModelLoader::get(const Common::UString &resref,
+		Graphics::Aurora::ModelType type, const Common::UString &texture) {
+
+	ModelID id(resref, type, texture);
+
+	ModelCache::const_iterator cached = _cache.find(id);
+	if (cached != _cache.end()) {
+		if (!cached->second)
+			return load(resref, type, texture);
+
+		return cached->second->createInstance();
+	}
+
+	const uint32 pltCount = TextureMan.getNewPLTCount();
+
+	Graphics::Aurora::Model *model = load(resref, type, texture);
+
+	// A model that created PLTs needs its own textures, so just hand it out directly
+	if (TextureMan.getNewPLTCount() != pltCount) {
+		_cache.insert(std::make_pair(id, (Graphics::Aurora::Model *) 0));
+		return model;
+	}
+
+	_cache.insert(std::make_pair(id, model));
+
+	return model->createInstance();
+}
+
+void ModelLoader::clearCache() {
+	for (ModelCache::iterator m = _cache.begin(); m != _cache.end(); ++m)
+		delete m->second;
+
+	_cache.clear();
 }
 
 void ModelLoader::free(Graphics::Aurora::Model *&model) {
@@ -30,21 +30,52 @@
 #ifndef ENGINES_AURORA_MODELLOADER_H
 #define ENGINES_AURORA_MODELLOADER_H
 
-#include "graphics/aurora/types.h"
+#include <map>
+
+#include "common/ustring.h"
 
-namespace Common {
-	class UString;
-}
+#include "graphics/aurora/types.h"
 
 namespace Engines {
 
 class ModelLoader {
 public:
+	ModelLoader();
 	virtual ~ModelLoader();
 
+	/** Return an instance of a model, parsing the model file only once.
+	 *
+	 *  All instances of a model share their geometry and textures. Models
+	 *  with PLT textures are never shared, since those are colored per
+	 *  instance.
+	 */
+	Graphics::Aurora::Model *get(const Common::UString &resref,
+			Graphics::Aurora::ModelType type, const Common::UString &texture);
+
+	/** Forget all cached models. Instances already handed out stay valid. */
+	void clearCache();
+
 	virtual Graphics::Aurora::Model *load(const Common::UString &resref,
 			Graphics::Aurora::ModelType type, const Common::UString &texture) = 0;
 	virtual void free(Graphics::Aurora::Model *&model);
+
+private:
+	/** The identity of a cached model. */
+	struct ModelID {
+		Common::UString resref;
+		Common::UString texture;
+
+		Graphics::Aurora::ModelType type;
+
+		ModelID(const Common::UString &r, Graphics::Aurora::ModelType y, const Common::UString &t);
+
+		bool operator<(const ModelID &right) const;
+	};
+
+	/** Loaded models to create instances from. 0 for models that can't be shared. */
+	typedef std::map<ModelID, Graphics::Aurora::Model *> ModelCache;
+
+	ModelCache _cache;
 };
 
 } // End of namespace Engines
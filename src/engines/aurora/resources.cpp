@@ -27,6 +27,8 @@
  *  Generic Aurora engines resource utility functions.
  */
 
+#include <vector>
+
 #include "common/error.h"
 #include "common/ustring.h"
 
@@ -49,6 +51,17 @@ void indexMandatoryArchive(Aurora::ArchiveType archive, const Common::UString &f
 		*change = c;
 }
 
+void indexMandatoryArchives(Aurora::ArchiveType archive, const char * const *files, uint count,
+		uint32 priority) {
+
+	if (EventMan.quitRequested())
+		return;
+
+	std::vector<Common::UString> fileList(files, files + count);
+
+	ResMan.addArchives(archive, fileList, priority);
+}
+
 bool indexOptionalArchive(Aurora::ArchiveType archive, const Common::UString &file,
 		uint32 priority, Aurora::ResourceManager::ChangeID *change) {
 
@@ -42,6 +42,14 @@ namespace Engines {
 void indexMandatoryArchive(Aurora::ArchiveType archive, const Common::UString &file,
 		uint32 priority = 10, Aurora::ResourceManager::ChangeID *change = 0);
 
+/** Add several archive files to the resource manager, erroring out if one does not exist.
+ *
+ *  The archive files are loaded in parallel. The first file gets the given
+ *  priority, every following file a priority one higher than the one before.
+ */
+void indexMandatoryArchives(Aurora::ArchiveType archive, const char * const *files, uint count,
+		uint32 priority = 10);
+
 /** Add an archive file to the resource manager, if it exists. */
 bool indexOptionalArchive(Aurora::ArchiveType archive, const Common::UString &file,
 		uint32 priority = 10, Aurora::ResourceManager::ChangeID *change = 0);
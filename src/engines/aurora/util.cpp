@@ -78,14 +78,24 @@ Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType so
 	Aurora::ResourceType resType =
 		(soundType == Sound::kSoundTypeMusic) ? Aurora::kResourceMusic : Aurora::kResourceSound;
 
+	// Sound effects are usually short and replayed often, so keep them decoded
+	Common::UString cacheName;
+	if (soundType == Sound::kSoundTypeSFX)
+		cacheName = Common::UString::sprintf("%s/%d", sound.c_str(), (int) resType);
+
 	Sound::ChannelHandle channel;
 
 	try {
-		Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
-		if (!soundStream)
-			return channel;
+		if (!cacheName.empty())
+			channel = SoundMan.playCachedSound(cacheName, soundType, loop);
+
+		if (!SoundMan.isValidChannel(channel)) {
+			Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
+			if (!soundStream)
+				return channel;
 
-		channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+			channel = SoundMan.playSoundFile(soundStream, soundType, loop, cacheName);
+		}
 
 		SoundMan.setChannelGain(channel, volume);
 
@@ -139,6 +139,58 @@ void DragonAgeEngine::run(const Common::UString &target) {
 	delete fps;
 }
 
+/** The core resource files, in order of increasing priority. */
+static const char *kCoreArchives[] = {
+	"2da.erf",
+	"anims.erf",
+	"chargen.gpu.rim",
+	"chargen.rim",
+	"consolescripts.erf",
+	"designerareas.erf",
+	"designercreatures.erf",
+	"designercutscenes.erf",
+	"designerdialogs.erf",
+	"designeritems.erf",
+	"designerplaceables.erf",
+	"designerplots.erf",
+	"designerscripts.rim",
+	"designertriggers.erf",
+	"face.erf",
+	"global.rim",
+	"globalvfx.rim",
+	"gui.erf",
+	"guiexport.erf",
+	"iterationtests.erf",
+	"lightprobedata.erf",
+	"materialobjects.erf",
+	"materials.erf",
+	"misc.erf",
+	"modelhierarchies.erf",
+	"modelmeshdata.erf",
+	"pathfindingpatches.erf",
+	"postprocesseffects.erf",
+	"resmetrics.erf",
+	"scripts.erf",
+	"shaders.erf",
+	"states.erf",
+	"subqueuefiles.erf",
+	"textures.erf",
+	"tints.erf"
+};
+
+/** The core ability resource files, in order of increasing priority. */
+static const char *kAbilityArchives[] = {
+	"bearform.rim",
+	"burningform.rim",
+	"golemform.rim",
+	"mouseform.rim",
+	"spiderform.rim",
+	"spiritform.rim",
+	"summonbear.rim",
+	"summonspider.rim",
+	"summonwolf.rim"
+};
+
 void DragonAgeEngine::init() {
 	ResMan.setRIMsAreERFs(true);
 
@@ -153,52 +205,10 @@ void DragonAgeEngine::init() {
 	ResMan.addArchiveDir(Aurora::kArchiveERF, "modules/single player/data");
 
 	status("Loading core resource files");
-	indexMandatoryArchive(Aurora::kArchiveERF, "2da.erf"               ,  0);
-	indexMandatoryArchive(Aurora::kArchiveERF, "anims.erf"             ,  1);
-	indexMandatoryArchive(Aurora::kArchiveERF, "chargen.gpu.rim"       ,  2);
-	indexMandatoryArchive(Aurora::kArchiveERF, "chargen.rim"           ,  3);
-	indexMandatoryArchive(Aurora::kArchiveERF, "consolescripts.erf"    ,  4);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designerareas.erf"     ,  5);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designercreatures.erf" ,  6);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designercutscenes.erf" ,  7);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designerdialogs.erf"   ,  8);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designeritems.erf"     ,  9);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designerplaceables.erf", 10);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designerplots.erf"     , 11);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designerscripts.rim"   , 12);
-	indexMandatoryArchive(Aurora::kArchiveERF, "designertriggers.erf"  , 13);
-	indexMandatoryArchive(Aurora::kArchiveERF, "face.erf"              , 14);
-	indexMandatoryArchive(Aurora::kArchiveERF, "global.rim"            , 15);
-	indexMandatoryArchive(Aurora::kArchiveERF, "globalvfx.rim"         , 16);
-	indexMandatoryArchive(Aurora::kArchiveERF, "gui.erf"               , 17);
-	indexMandatoryArchive(Aurora::kArchiveERF, "guiexport.erf"         , 18);
-	indexMandatoryArchive(Aurora::kArchiveERF, "iterationtests.erf"    , 19);
-	indexMandatoryArchive(Aurora::kArchiveERF, "lightprobedata.erf"    , 20);
-	indexMandatoryArchive(Aurora::kArchiveERF, "materialobjects.erf"   , 21);
-	indexMandatoryArchive(Aurora::kArchiveERF, "materials.erf"         , 22);
-	indexMandatoryArchive(Aurora::kArchiveERF, "misc.erf"              , 23);
-	indexMandatoryArchive(Aurora::kArchiveERF, "modelhierarchies.erf"  , 24);
-	indexMandatoryArchive(Aurora::kArchiveERF, "modelmeshdata.erf"     , 25);
-	indexMandatoryArchive(Aurora::kArchiveERF, "pathfindingpatches.erf", 26);
-	indexMandatoryArchive(Aurora::kArchiveERF, "postprocesseffects.erf", 27);
-	indexMandatoryArchive(Aurora::kArchiveERF, "resmetrics.erf"        , 28);
-	indexMandatoryArchive(Aurora::kArchiveERF, "scripts.erf"           , 29);
-	indexMandatoryArchive(Aurora::kArchiveERF, "shaders.erf"           , 30);
-	indexMandatoryArchive(Aurora::kArchiveERF, "states.erf"            , 31);
-	indexMandatoryArchive(Aurora::kArchiveERF, "subqueuefiles.erf"     , 32);
-	indexMandatoryArchive(Aurora::kArchiveERF, "textures.erf"          , 33);
-	indexMandatoryArchive(Aurora::kArchiveERF, "tints.erf"             , 34);
+	indexMandatoryArchives(Aurora::kArchiveERF, kCoreArchives, ARRAYSIZE(kCoreArchives), 0);
 
 	status("Loading core ability resource files");
-	indexMandatoryArchive(Aurora::kArchiveERF, "bearform.rim"    , 40);
-	indexMandatoryArchive(Aurora::kArchiveERF, "burningform.rim" , 41);
-	indexMandatoryArchive(Aurora::kArchiveERF, "golemform.rim"   , 42);
-	indexMandatoryArchive(Aurora::kArchiveERF, "mouseform.rim"   , 43);
-	indexMandatoryArchive(Aurora::kArchiveERF, "spiderform.rim"  , 44);
-	indexMandatoryArchive(Aurora::kArchiveERF, "spiritform.rim"  , 45);
-	indexMandatoryArchive(Aurora::kArchiveERF, "summonbear.rim"  , 46);
-	indexMandatoryArchive(Aurora::kArchiveERF, "summonspider.rim", 47);
-	indexMandatoryArchive(Aurora::kArchiveERF, "summonwolf.rim"  , 48);
+	indexMandatoryArchives(Aurora::kArchiveERF, kAbilityArchives, ARRAYSIZE(kAbilityArchives), 40);
 
 	status("Indexing extra core sound resources");
 	indexMandatoryDirectory("packages/core/audio"          , 0, -1, 100);
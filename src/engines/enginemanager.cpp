@@ -39,6 +39,8 @@
 #include "aurora/resman.h"
 #include "aurora/talkman.h"
 #include "aurora/2dareg.h"
+#include "aurora/blueprintreg.h"
+#include "aurora/nwscript/ncsfile.h"
 #include "../aurora/util.h"
 
 #include "graphics/aurora/cursorman.h"
@@ -48,6 +50,8 @@
 #include "events/events.h"
 #include "events/requests.h"
 
+#include "sound/sound.h"
+
 #include "engines/enginemanager.h"
 #include "engines/engineprobe.h"
 
@@ -223,6 +227,7 @@ void EngineManager::cleanup(GameInstance &game) const {
 
 		DebugMan.clearEngineChannels();
 
+		clearModelCache();
 		unregisterModelLoader();
 
 		RequestMan.sync();
@@ -235,6 +240,13 @@ void EngineManager::cleanup(GameInstance &game) const {
 
 		TalkMan.clear();
 		TwoDAReg.clear();
+		BlueprintReg.clear();
+
+		Aurora::NWScript::NCSFile::clearCache();
+
+		SoundMan.getSampleCache().clear();
+
+		ResMan.saveIndexCache();
 		ResMan.clear();
 
 		ConfigMan.setGame();
@@ -27,6 +27,8 @@
  *  An area.
  */
 
+#include <algorithm>
+
 #include "common/util.h"
 #include "common/error.h"
 #include "common/stream.h"
@@ -38,6 +40,7 @@
 #include "aurora/2dareg.h"
 
 #include "graphics/graphics.h"
+#include "graphics/camera.h"
 
 #include "graphics/aurora/cursorman.h"
 
@@ -56,7 +59,7 @@ namespace Engines {
 namespace KotOR {
 
 Area::Room::Room(const Aurora::LYTFile::Room &lRoom) :
-	lytRoom(&lRoom), model(0), visible(false) {
+	lytRoom(&lRoom), model(0), minX(0.0), minY(0.0), maxX(0.0), maxY(0.0), visible(false) {
 }
 
 Area::Room::~Room() {
@@ -64,7 +67,8 @@ Area::Room::~Room() {
 }
 
 
-Area::Area() : _loaded(false), _visible(false), _activeObject(0), _highlightAll(false) {
+Area::Area() : _loaded(false), _visible(false), _currentRoom(0), _activeObject(0),
+	_highlightAll(false) {
 }
 
 Area::~Area() {
@@ -133,14 +137,13 @@ void Area::show() {
 
 	GfxMan.lockFrame();
 
-	// Show rooms
-	for (std::vector<Room *>::iterator r = _rooms.begin(); r != _rooms.end(); ++r)
-		(*r)->model->show();
-
-	// Show objects
-	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
+	// Show objects outside of any room
+	for (std::vector<Object *>::iterator o = _roomlessObjects.begin(); o != _roomlessObjects.end(); ++o)
 		(*o)->show();
 
+	// Show the rooms visible from the camera's room, together with their objects
+	updateRoomVisibility(true);
+
 	GfxMan.unlockFrame();
 
 	_visible = true;
@@ -163,11 +166,15 @@ void Area::hide() {
 		(*o)->hide();
 
 	// Hide rooms
-	for (std::vector<Room *>::iterator room = _rooms.begin(); room != _rooms.end(); ++room)
+	for (std::vector<Room *>::iterator room = _rooms.begin(); room != _rooms.end(); ++room) {
 		(*room)->model->hide();
+		(*room)->visible = false;
+	}
 
 	GfxMan.unlockFrame();
 
+	_currentRoom = 0;
+
 	_visible = false;
 }
 
@@ -186,6 +193,8 @@ void Area::load(const Common::UString &resRef) {
 	Aurora::GFFFile git(_resRef, Aurora::kFileTypeGIT, MKID_BE('GIT '));
 	loadGIT(git.getTopLevel());
 
+	assignObjects();
+
 	_loaded = true;
 }
 
@@ -369,6 +378,16 @@ void Area::loadModels() {
 
 		room->model->setPosition(lytRoom.x, lytRoom.y, lytRoom.z);
 
+		// The model's world y axis is the area's z axis, and its world z axis the negated area y axis
+		float minX, minY, minZ, maxX, maxY, maxZ;
+		room->model->getAbsoluteBound().getMin(minX, minY, minZ);
+		room->model->getAbsoluteBound().getMax(maxX, maxY, maxZ);
+
+		room->minX =  minX;
+		room->maxX =  maxX;
+		room->minY = -maxZ;
+		room->maxY = -minZ;
+
 		_rooms.push_back(room);
 	}
 
@@ -386,11 +405,16 @@ void Area::loadVisibles() {
 			for (std::vector<Room *>::iterator iRoom = _rooms.begin(); iRoom != _rooms.end(); ++iRoom)
 				(*room)->visibles.push_back(*iRoom);
 
-			return;
+			continue;
 		}
 
+		// A room is always visible from itself
+		(*room)->visibles.push_back(*room);
+
 		// Otherwise, go through all rooms again, look for a match with the visibilities
 		for (std::vector<Room *>::iterator iRoom = _rooms.begin(); iRoom != _rooms.end(); ++iRoom) {
+			if (*iRoom == *room)
+				continue;
 
 			for (std::vector<Common::UString>::const_iterator vRoom = rooms.begin(); vRoom != rooms.end(); ++vRoom) {
 				if (vRoom->equalsIgnoreCase((*iRoom)->lytRoom->model)) {
@@ -406,6 +430,125 @@ void Area::loadVisibles() {
 
 }
 
+void Area::assignObjects() {
+	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o) {
+		float x, y, z;
+		(*o)->getPosition(x, y, z);
+
+		Room *room = findRoom(x, y);
+
+		getRoomObjects(room).push_back(*o);
+		_objectRooms[*o] = room;
+
+		// From now on, the object tells us when it moves
+		(*o)->setArea(this);
+	}
+}
+
+void Area::updateObject(Object &object) {
+	ObjectRoomMap::iterator o = _objectRooms.find(&object);
+	if (o == _objectRooms.end())
+		return;
+
+	float x, y, z;
+	object.getPosition(x, y, z);
+
+	Room *room = findRoom(x, y);
+	if (room == o->second)
+		return;
+
+	GfxMan.lockFrame();
+
+	std::vector<Object *> &oldObjects = getRoomObjects(o->second);
+	oldObjects.erase(std::find(oldObjects.begin(), oldObjects.end(), &object));
+
+	getRoomObjects(room).push_back(&object);
+	o->second = room;
+
+	// Follow the visibility of the new room
+	if (_visible) {
+		if (!room || room->visible)
+			object.show();
+		else
+			object.hide();
+	}
+
+	GfxMan.unlockFrame();
+}
+
+std::vector<Object *> &Area::getRoomObjects(Room *room) {
+	return room ? room->objects : _roomlessObjects;
+}
+
+Area::Room *Area::findRoom(float x, float y) const {
+	// Room bounds overlap a bit, so prefer the smallest, most specific room
+	Room *found     = 0;
+	float foundSize = 0.0;
+
+	for (std::vector<Room *>::const_iterator r = _rooms.begin(); r != _rooms.end(); ++r) {
+		const Room &room = **r;
+
+		if ((x < room.minX) || (x > room.maxX) || (y < room.minY) || (y > room.maxY))
+			continue;
+
+		const float size = (room.maxX - room.minX) * (room.maxY - room.minY);
+		if (!found || (size < foundSize)) {
+			found     = *r;
+			foundSize = size;
+		}
+	}
+
+	return found;
+}
+
+void Area::setRoomVisible(Room &room, bool visible) {
+	room.visible = visible;
+
+	if (visible) {
+		room.model->show();
+
+		for (std::vector<Object *>::iterator o = room.objects.begin(); o != room.objects.end(); ++o)
+			(*o)->show();
+
+	} else {
+		for (std::vector<Object *>::iterator o = room.objects.begin(); o != room.objects.end(); ++o)
+			(*o)->hide();
+
+		room.model->hide();
+	}
+}
+
+void Area::updateRoomVisibility(bool force) {
+	// The camera's y and z axes are swapped against the area's
+	CameraMan.lock();
+	Room *room = findRoom(CameraMan.getPosition()[0], CameraMan.getPosition()[2]);
+	CameraMan.unlock();
+
+	// When the camera leaves all rooms, keep the last room's view
+	if (!room)
+		room = _currentRoom;
+
+	if ((room == _currentRoom) && !force)
+		return;
+
+	_currentRoom = room;
+
+	// Swap the visible set in one go, touching only the rooms that changed
+	GfxMan.lockFrame();
+
+	for (std::vector<Room *>::iterator r = _rooms.begin(); r != _rooms.end(); ++r) {
+		// Without a known room, show everything
+		bool visible = !_currentRoom ||
+			(std::find(_currentRoom->visibles.begin(), _currentRoom->visibles.end(), *r) !=
+			 _currentRoom->visibles.end());
+
+		if (visible != (*r)->visible)
+			setRoomVisible(**r, visible);
+	}
+
+	GfxMan.unlockFrame();
+}
+
 void Area::addEvent(const Events::Event &event) {
 	_eventQueue.push_back(event);
 }
@@ -488,6 +631,12 @@ void Area::removeFocus() {
 }
 
 void Area::notifyCameraMoved() {
+	if (_visible) {
+		Common::StackLock lock(_mutex);
+
+		updateRoomVisibility();
+	}
+
 	checkActive();
 }
 
@@ -74,6 +74,9 @@ public:
 
 	void removeFocus();
 
+	/** Move the object into the room it's now standing in. */
+	void updateObject(Object &object);
+
 
 protected:
 	void notifyCameraMoved();
@@ -86,9 +89,15 @@ private:
 
 		Graphics::Aurora::Model *model;
 
+		/** The room's horizontal extent in area coordinates. */
+		float minX, minY, maxX, maxY;
+
 		bool visible;
 		std::vector<Room *> visibles;
 
+		/** All objects standing within this room. */
+		std::vector<Object *> objects;
+
 		Room(const Aurora::LYTFile::Room &lRoom);
 		~Room();
 	};
@@ -97,6 +106,9 @@ private:
 
 	typedef std::map<uint32, Object *> ObjectMap;
 
+	/** The room each object stands in, or 0 if none. */
+	typedef std::map<Object *, Room *> ObjectRoomMap;
+
 
 	bool _loaded;
 
@@ -125,7 +137,14 @@ private:
 
 	std::vector<Room *> _rooms;
 
+	/** The room the camera is currently in. */
+	Room *_currentRoom;
+
 	ObjectList _objects;
+	/** All objects not standing within any room. */
+	std::vector<Object *> _roomlessObjects;
+
+	ObjectRoomMap _objectRooms;
 
 	ObjectMap _objectMap;
 
@@ -153,6 +172,11 @@ private:
 	void loadDoors     (const Aurora::GFFList &list);
 	void loadCreatures (const Aurora::GFFList &list);
 
+	void assignObjects();
+
+	/** Return the list of objects in that room, or of those outside of all rooms. */
+	std::vector<Object *> &getRoomObjects(Room *room);
+
 	void stopSound();
 	void stopAmbientMusic();
 	void stopAmbientSound();
@@ -160,6 +184,13 @@ private:
 	void playAmbientMusic(Common::UString music = "");
 	void playAmbientSound(Common::UString sound = "");
 
+	/** Find the smallest room containing that point. */
+	Room *findRoom(float x, float y) const;
+
+	/** Show only the rooms (and their objects) visible from the camera's room. */
+	void updateRoomVisibility(bool force = false);
+	void setRoomVisible(Room &room, bool visible);
+
 	void checkActive();
 	void setActive(Object *object);
 	Object *getObjectAt(int x, int y);
@@ -32,10 +32,13 @@
 #include "common/ustring.h"
 #include "common/util.h"
 
+#include "graphics/graphics.h"
+
 #include "graphics/aurora/fontman.h"
 
 #include "engines/kotor/console.h"
 #include "engines/kotor/module.h"
+#include "engines/kotor/area.h"
 
 namespace Engines {
 
@@ -46,6 +49,8 @@ Console::Console() : ::Engines::Console(Graphics::Aurora::kSystemFontMono, 13),
 
 	registerCommand("loadmodule", boost::bind(&Console::cmdLoadModule, this, _1),
 			"Usage: loadmodule <module>\nLoad and enter the specified module");
+	registerCommand("listrooms" , boost::bind(&Console::cmdListRooms , this, _1),
+			"Usage: listrooms\nList the rooms currently shown and count what the last frame drew");
 }
 
 Console::~Console() {
@@ -67,6 +72,25 @@ void Console::cmdLoadModule(const CommandLine &cl) {
 	_module->replaceModule(cl.args);
 }
 
+void Console::cmdListRooms(const CommandLine &cl) {
+	if (!_module || !_module->_area)
+		return;
+
+	const Area &area = *_module->_area;
+
+	uint32 shown = 0;
+	for (std::vector<Area::Room *>::const_iterator r = area._rooms.begin(); r != area._rooms.end(); ++r) {
+		if (!(*r)->visible)
+			continue;
+
+		printf("%s%s", (*r)->lytRoom->model.c_str(), (*r == area._currentRoom) ? " (camera)" : "");
+		shown++;
+	}
+
+	printf("%u of %u rooms shown. Last frame: %u objects drawn, %u culled",
+	       shown, (uint) area._rooms.size(), GfxMan.getObjectsDrawn(), GfxMan.getObjectsCulled());
+}
+
 } // End of namespace KOTOR
 
 } // End of namespace Engines
@@ -49,6 +49,7 @@ private:
 	Module *_module;
 
 	void cmdLoadModule(const CommandLine &cl);
+	void cmdListRooms (const CommandLine &cl);
 };
 
 } // End of namespace KOTOR
@@ -37,6 +37,7 @@
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/locstring.h"
 
 #include "graphics/aurora/modelnode.h"
@@ -83,21 +84,12 @@ void Creature::setOrientation(float x, float y, float z) {
 void Creature::load(const Aurora::GFFStruct &creature) {
 	Common::UString temp = creature.getString("TemplateResRef");
 
-	Aurora::GFFFile *utc = 0;
-	if (!temp.empty()) {
-		try {
-			utc = new Aurora::GFFFile(temp, Aurora::kFileTypeUTC, MKID_BE('UTC '));
-		} catch (...) {
-			delete utc;
-		}
-	}
+	const Aurora::GFFStruct *utc = BlueprintReg.get(temp, Aurora::kFileTypeUTC, MKID_BE('UTC '));
 
-	load(creature, utc ? &utc->getTopLevel() : 0);
+	load(creature, utc);
 
 	if (!utc)
 		warning("Creature \"%s\" has no blueprint", _tag.c_str());
-
-	delete utc;
 }
 
 void Creature::load(const Aurora::GFFStruct &instance, const Aurora::GFFStruct *blueprint) {
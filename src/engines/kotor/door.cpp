@@ -31,6 +31,7 @@
 #include "common/error.h"
 
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 
@@ -53,21 +54,12 @@ Door::~Door() {
 void Door::load(const Aurora::GFFStruct &door) {
 	Common::UString temp = door.getString("TemplateResRef");
 
-	Aurora::GFFFile *utd = 0;
-	if (!temp.empty()) {
-		try {
-			utd = new Aurora::GFFFile(temp, Aurora::kFileTypeUTD, MKID_BE('UTD '));
-		} catch (...) {
-			delete utd;
-		}
-	}
+	const Aurora::GFFStruct *utd = BlueprintReg.get(temp, Aurora::kFileTypeUTD, MKID_BE('UTD '));
 
-	Situated::load(door, utd ? &utd->getTopLevel() : 0);
+	Situated::load(door, utd);
 
 	if (!utd)
 		warning("Door \"%s\" has no blueprint", _tag.c_str());
-
-	delete utd;
 }
 
 void Door::loadObject(const Aurora::GFFStruct &gff) {
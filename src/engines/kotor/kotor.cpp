@@ -178,6 +178,8 @@ void KotOREngine::init() {
 }
 
 void KotOREngine::initResources() {
+	uint32 startTime = EventMan.getTimestamp();
+
 	status("Setting base directory");
 	ResMan.registerDataBaseDir(_baseDirectory);
 
@@ -260,6 +262,9 @@ void KotOREngine::initResources() {
 	status("Indexing override files");
 	indexOptionalDirectory("override", 0, 0, 40);
 
+	status("Indexing resources took %dms", EventMan.getTimestamp() - startTime);
+	ResMan.saveIndexCache();
+
 	if (EventMan.quitRequested())
 		return;
 
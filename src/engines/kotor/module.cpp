@@ -31,13 +31,19 @@
 #include "common/error.h"
 #include "common/ustring.h"
 
+#include "aurora/blueprintreg.h"
+#include "aurora/nwscript/ncsfile.h"
+
 #include "graphics/camera.h"
 
 #include "graphics/aurora/textureman.h"
 
 #include "events/events.h"
 
+#include "sound/sound.h"
+
 #include "engines/aurora/util.h"
+#include "engines/aurora/model.h"
 #include "engines/aurora/resources.h"
 #include "engines/aurora/console.h"
 
@@ -218,6 +224,11 @@ void Module::unloadResources() {
 		ResMan.undo(*r);
 
 	_resources.clear();
+
+	// The blueprints, scripts and sounds came out of the module's resources
+	BlueprintReg.clear();
+	Aurora::NWScript::NCSFile::clearCache();
+	SoundMan.getSampleCache().clear();
 }
 
 void Module::unloadIFO() {
@@ -227,6 +238,9 @@ void Module::unloadIFO() {
 void Module::unloadArea() {
 	delete _area;
 	_area = 0;
+
+	// The models of the next area will most likely be different ones
+	clearModelCache();
 }
 
 void Module::unloadTexturePack() {
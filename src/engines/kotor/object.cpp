@@ -28,12 +28,13 @@
  */
 
 #include "engines/kotor/object.h"
+#include "engines/kotor/area.h"
 
 namespace Engines {
 
 namespace KotOR {
 
-Object::Object() : _loaded(false), _static(false), _usable(true) {
+Object::Object() : _loaded(false), _static(false), _usable(true), _area(0) {
 	_position   [0] = 0.0;
 	_position   [1] = 0.0;
 	_position   [2] = 0.0;
@@ -77,6 +78,14 @@ const std::list<uint32> &Object::getIDs() const {
 	return _ids;
 }
 
+Area *Object::getArea() const {
+	return _area;
+}
+
+void Object::setArea(Area *area) {
+	_area = area;
+}
+
 void Object::getPosition(float &x, float &y, float &z) const {
 	x = _position[0];
 	y = _position[1];
@@ -93,6 +102,9 @@ void Object::setPosition(float x, float y, float z) {
 	_position[0] = x;
 	_position[1] = y;
 	_position[2] = z;
+
+	if (_area)
+		_area->updateObject(*this);
 }
 
 void Object::setOrientation(float x, float y, float z) {
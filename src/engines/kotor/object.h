@@ -39,6 +39,8 @@ namespace Engines {
 
 namespace KotOR {
 
+class Area;
+
 /** An object within a KotOR area. */
 class Object {
 public:
@@ -61,6 +63,11 @@ public:
 
 	const std::list<uint32> &getIDs() const;
 
+	/** Return the area the object is in. */
+	Area *getArea() const;
+	/** Set the area the object is in. */
+	void setArea(Area *area);
+
 	virtual void getPosition(float &x, float &y, float &z) const;
 	virtual void getOrientation(float &x, float &y, float &z) const;
 
@@ -86,6 +93,8 @@ protected:
 
 	std::list<uint32> _ids;
 
+	Area *_area;
+
 	float _position[3];
 	float _orientation[3];
 };
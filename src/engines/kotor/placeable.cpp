@@ -30,6 +30,7 @@
 #include "common/util.h"
 
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 
@@ -52,21 +53,12 @@ Placeable::~Placeable() {
 void Placeable::load(const Aurora::GFFStruct &placeable) {
 	Common::UString temp = placeable.getString("TemplateResRef");
 
-	Aurora::GFFFile *utp = 0;
-	if (!temp.empty()) {
-		try {
-			utp = new Aurora::GFFFile(temp, Aurora::kFileTypeUTP, MKID_BE('UTP '));
-		} catch (...) {
-			delete utp;
-		}
-	}
+	const Aurora::GFFStruct *utp = BlueprintReg.get(temp, Aurora::kFileTypeUTP, MKID_BE('UTP '));
 
-	Situated::load(placeable, utp ? &utp->getTopLevel() : 0);
+	Situated::load(placeable, utp);
 
 	if (!utp)
 		warning("Placeable \"%s\" has no blueprint", _tag.c_str());
-
-	delete utp;
 }
 
 void Placeable::hide() {
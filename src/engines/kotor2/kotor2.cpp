@@ -164,6 +164,8 @@ void KotOR2Engine::init() {
 }
 
 void KotOR2Engine::initResources() {
+	uint32 startTime = EventMan.getTimestamp();
+
 	status("Setting base directory");
 	ResMan.registerDataBaseDir(_baseDirectory);
 
@@ -214,6 +216,9 @@ void KotOR2Engine::initResources() {
 	status("Indexing override files");
 	indexOptionalDirectory("override", 0, 0, 30);
 
+	status("Indexing resources took %dms", EventMan.getTimestamp() - startTime);
+	ResMan.saveIndexCache();
+
 	if (EventMan.quitRequested())
 		return;
 
@@ -27,8 +27,11 @@
  *  NWN area.
  */
 
+#include "boost/bind.hpp"
+
 #include "common/util.h"
 #include "common/error.h"
+#include "common/maths.h"
 
 #include "aurora/locstring.h"
 #include "aurora/gfffile.h"
@@ -86,6 +89,13 @@ Area::~Area() {
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		delete *o;
 
+	// Objects that came here from elsewhere don't have an area anymore
+	std::vector<Engines::NWN::Object *> objects;
+	_objectGrid.getObjects(objects);
+
+	for (std::vector<Engines::NWN::Object *>::iterator o = objects.begin(); o != objects.end(); ++o)
+		(*o)->setArea(0);
+
 	// Delete tiles and tileset
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t)
 		delete t->model;
@@ -280,6 +290,9 @@ void Area::loadARE(const Aurora::GFFStruct &are) {
 
 	_tiles.resize(_width * _height);
 
+	// Index the objects in tile-sized cells
+	_objectGrid.init(_width * 10.0, _height * 10.0, 10.0);
+
 	loadTiles(are.getList("Tile_List"));
 
 	// Scripts
@@ -385,6 +398,10 @@ void Area::loadModels() {
 
 		object.loadModel();
 
+		// Now that we know the object's size, update its extent
+		if (object.getArea() == this)
+			updateObject(object);
+
 		if (!object.isStatic()) {
 			const std::list<uint32> &ids = object.getIDs();
 
@@ -401,6 +418,9 @@ void Area::unloadModels() {
 		(*o)->unloadModel();
 
 	unloadTileModels();
+
+	// Tiles and objects of the next area will most likely be different ones
+	clearModelCache();
 }
 
 void Area::loadTileModels() {
@@ -546,15 +566,73 @@ void Area::processEventQueue() {
 }
 
 Engines::NWN::Object *Area::getObjectAt(int x, int y) {
-	const Graphics::Renderable *obj = GfxMan.getObjectAt(x, y);
-	if (!obj)
+	// GUI elements in front of the area catch the cursor first
+	if (GfxMan.getGUIObjectAt(x, y))
 		return 0;
 
-	ObjectMap::iterator o = _objectMap.find(obj->getID());
-	if (o == _objectMap.end())
+	float x1, y1, z1, x2, y2, z2;
+	if (!GfxMan.unproject(x, GfxMan.getScreenHeight() - y, x1, y1, z1, x2, y2, z2))
 		return 0;
 
-	return o->second;
+	// The world's z axis is the negated y axis of the area's ground plane
+	return _objectGrid.findAlongLine(x1, -z1, x2, -z2,
+			boost::bind(&Area::isObjectAt, _1, x1, y1, z1, x2, y2, z2));
+}
+
+bool Area::isObjectAt(const Engines::NWN::Object &object,
+                      float x1, float y1, float z1, float x2, float y2, float z2) {
+
+	if (object.isStatic() || !object.isClickable())
+		return false;
+
+	const Graphics::Aurora::Model *model = object.getModel();
+	if (!model)
+		return false;
+
+	return model->isIn(x1, y1, z1, x2, y2, z2);
+}
+
+float Area::getObjectRadius(const Engines::NWN::Object &object) {
+	const Graphics::Aurora::Model *model = object.getModel();
+	if (!model || model->getAbsoluteBound().isEmpty())
+		return 0.0;
+
+	float x, y, z;
+	model->getPosition(x, y, z);
+
+	float minX, minY, minZ, maxX, maxY, maxZ;
+	model->getAbsoluteBound().getMin(minX, minY, minZ);
+	model->getAbsoluteBound().getMax(maxX, maxY, maxZ);
+
+	// The bounding box is in world coordinates, with the area's y axis as the negated z axis
+	const float dX = MAX(ABS(minX - x), ABS(maxX - x));
+	const float dY = MAX(ABS(maxZ + y), ABS(minZ + y));
+
+	// Circumscribe the box, so the radius holds whatever way the object is turned
+	return sqrtf(dX * dX + dY * dY);
+}
+
+void Area::updateObject(Engines::NWN::Object &object) {
+	_objectGrid.update(object, getObjectRadius(object));
+}
+
+void Area::removeObject(Engines::NWN::Object &object) {
+	if (_activeObject == &object)
+		_activeObject = 0;
+
+	_objectGrid.remove(object);
+}
+
+Engines::NWN::Object *Area::findNearestObject(float x, float y, float z,
+		const ObjectGrid::Filter &filter, uint32 nth) const {
+
+	return _objectGrid.findNearest(x, y, z, filter, nth);
+}
+
+void Area::findObjectsWithin(float x, float y, float z, float distance,
+		const ObjectGrid::Filter &filter, std::vector<Engines::NWN::Object *> &objects) const {
+
+	_objectGrid.findWithin(x, y, z, distance, filter, objects);
 }
 
 void Area::setActive(Engines::NWN::Object *object) {
@@ -50,6 +50,7 @@
 #include "events/notifyable.h"
 
 #include "engines/nwn/tileset.h"
+#include "engines/nwn/objectgrid.h"
 
 #include "engines/nwn/script/container.h"
 
@@ -110,6 +111,22 @@ public:
 	/** Forcibly remove the focus from the currently highlighted object. */
 	void removeFocus();
 
+	// Spatial queries
+
+	/** Add an object to the area's spatial index, or update its position there. */
+	void updateObject(Engines::NWN::Object &object);
+	/** Remove an object from the area's spatial index. */
+	void removeObject(Engines::NWN::Object &object);
+
+	/** Find the nth (starting at 0) nearest object to that position matching the filter. */
+	Engines::NWN::Object *findNearestObject(float x, float y, float z,
+	                                        const ObjectGrid::Filter &filter, uint32 nth = 0) const;
+
+	/** Find all objects within that distance of a position matching the filter, nearest first. */
+	void findObjectsWithin(float x, float y, float z, float distance,
+	                       const ObjectGrid::Filter &filter,
+	                       std::vector<Engines::NWN::Object *> &objects) const;
+
 
 	/** Return the localized name of an area. */
 	static Common::UString getName(const Common::UString &resRef);
@@ -192,6 +209,9 @@ private:
 	ObjectList _objects;   ///< List of all objects in the area.
 	ObjectMap  _objectMap; ///< Map of all non-static objects in the area.
 
+	/** Spatial index of all objects currently in the area. */
+	ObjectGrid _objectGrid;
+
 	/** The currently active (highlighted) object. */
 	Engines::NWN::Object *_activeObject;
 
@@ -238,6 +258,10 @@ private:
 	void setActive(Engines::NWN::Object *object);
 	Engines::NWN::Object *getObjectAt(int x, int y);
 
+	static bool isObjectAt(const Engines::NWN::Object &object,
+	                       float x1, float y1, float z1, float x2, float y2, float z2);
+	static float getObjectRadius(const Engines::NWN::Object &object);
+
 	void highlightAll(bool enabled);
 
 	void click(int x, int y);
@@ -36,6 +36,7 @@
 #include "aurora/talkman.h"
 #include "aurora/resman.h"
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 
@@ -149,6 +150,10 @@ void Creature::hide() {
 		_model->hide();
 }
 
+Graphics::Aurora::Model *Creature::getModel() const {
+	return _model;
+}
+
 void Creature::setPosition(float x, float y, float z) {
 	Object::setPosition(x, y, z);
 	Object::getPosition(x, y, z);
@@ -431,18 +436,9 @@ void Creature::loadCharacter(const Common::UString &bic, bool local) {
 void Creature::load(const Aurora::GFFStruct &creature) {
 	Common::UString temp = creature.getString("TemplateResRef");
 
-	Aurora::GFFFile *utc = 0;
-	if (!temp.empty()) {
-		try {
-			utc = new Aurora::GFFFile(temp, Aurora::kFileTypeUTC, MKID_BE('UTC '));
-		} catch (...) {
-			delete utc;
-		}
-	}
-
-	load(creature, utc ? &utc->getTopLevel() : 0);
+	const Aurora::GFFStruct *utc = BlueprintReg.get(temp, Aurora::kFileTypeUTC, MKID_BE('UTC '));
 
-	delete utc;
+	load(creature, utc);
 
 	_lastChangedGUIDisplay = EventMan.getTimestamp();
 }
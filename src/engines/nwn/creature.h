@@ -67,6 +67,9 @@ public:
 	void show(); ///< Show the creature's model.
 	void hide(); ///< Hide the creature's model.
 
+	/** Return the creature's model. */
+	Graphics::Aurora::Model *getModel() const;
+
 	// Basic properties
 
 	/** Return the creature's first name. */
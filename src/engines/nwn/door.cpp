@@ -31,6 +31,7 @@
 #include "common/error.h"
 
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 
@@ -61,18 +62,9 @@ Door::~Door() {
 void Door::load(const Aurora::GFFStruct &door) {
 	Common::UString temp = door.getString("TemplateResRef");
 
-	Aurora::GFFFile *utd = 0;
-	if (!temp.empty()) {
-		try {
-			utd = new Aurora::GFFFile(temp, Aurora::kFileTypeUTD, MKID_BE('UTD '));
-		} catch (...) {
-			delete utd;
-		}
-	}
-
-	Situated::load(door, utd ? &utd->getTopLevel() : 0);
+	const Aurora::GFFStruct *utd = BlueprintReg.get(temp, Aurora::kFileTypeUTD, MKID_BE('UTD '));
 
-	delete utd;
+	Situated::load(door, utd);
 
 	setModelState();
 }
@@ -33,9 +33,13 @@
 
 #include "events/events.h"
 
+#include "sound/sound.h"
+
 #include "aurora/2dareg.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/talkman.h"
 #include "aurora/erffile.h"
+#include "aurora/nwscript/ncsfile.h"
 
 #include "graphics/camera.h"
 
@@ -524,6 +528,10 @@ void Module::unloadModule() {
 	_delayedActions.clear();
 
 	TwoDAReg.clear();
+	BlueprintReg.clear();
+
+	// The module might override sounds
+	SoundMan.getSampleCache().clear();
 
 	clearVariables();
 	clearScripts();
@@ -534,6 +542,9 @@ void Module::unloadModule() {
 
 	ResMan.undo(_resModule);
 
+	// The next module might come with its own versions of scripts
+	Aurora::NWScript::NCSFile::clearCache();
+
 	_newModule.clear();
 	_hasModule = false;
 }
@@ -565,6 +576,12 @@ void Module::unloadHAKs() {
 		ResMan.undo(*hak);
 
 	_resHAKs.clear();
+
+	Aurora::NWScript::NCSFile::clearCache();
+
+	// The blueprints and sounds might have come out of the HAKs
+	BlueprintReg.clear();
+	SoundMan.getSampleCache().clear();
 }
 
 static const char *texturePacks[4][4] = {
@@ -172,6 +172,8 @@ void NWNEngine::init() {
 }
 
 void NWNEngine::initResources() {
+	uint32 startTime = EventMan.getTimestamp();
+
 	status("Setting base directory");
 	ResMan.registerDataBaseDir(_baseDirectory);
 	indexMandatoryDirectory("", 0, 0, 0);
@@ -224,6 +226,9 @@ void NWNEngine::initResources() {
 	status("Indexing override files");
 	indexOptionalDirectory("override", 0, 0, 1000);
 
+	status("Indexing resources took %dms", EventMan.getTimestamp() - startTime);
+	ResMan.saveIndexCache();
+
 	if (EventMan.quitRequested())
 		return;
 
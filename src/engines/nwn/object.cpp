@@ -47,6 +47,7 @@
 
 #include "engines/nwn/types.h"
 #include "engines/nwn/object.h"
+#include "engines/nwn/area.h"
 
 namespace Engines {
 
@@ -65,6 +66,9 @@ Object::Object(ObjectType type) : _type(type),
 }
 
 Object::~Object() {
+	if (_area)
+		_area->removeObject(*this);
+
 	delete _ssf;
 }
 
@@ -122,6 +126,10 @@ const std::list<uint32> &Object::getIDs() const {
 	return _ids;
 }
 
+Graphics::Aurora::Model *Object::getModel() const {
+	return 0;
+}
+
 Aurora::NWScript::Object *Object::getPCSpeaker() const {
 	return _pcSpeaker;
 }
@@ -135,7 +143,16 @@ Area *Object::getArea() const {
 }
 
 void Object::setArea(Area *area) {
+	if (area == _area)
+		return;
+
+	if (_area)
+		_area->removeObject(*this);
+
 	_area = area;
+
+	if (_area)
+		_area->updateObject(*this);
 }
 
 Location Object::getLocation() const {
@@ -166,6 +183,9 @@ void Object::setPosition(float x, float y, float z) {
 	_position[0] = x;
 	_position[1] = y;
 	_position[2] = z;
+
+	if (_area)
+		_area->updateObject(*this);
 }
 
 void Object::setOrientation(float x, float y, float z) {
@@ -51,6 +51,12 @@ namespace Aurora {
 	}
 }
 
+namespace Graphics {
+	namespace Aurora {
+		class Model;
+	}
+}
+
 namespace Engines {
 
 namespace NWN {
@@ -76,6 +82,9 @@ public:
 	/** Return the object's model IDs. */
 	const std::list<uint32> &getIDs() const;
 
+	/** Return the object's model, if it has one loaded. */
+	virtual Graphics::Aurora::Model *getModel() const;
+
 	// Basic properties
 
 	/** Return the object's name. */
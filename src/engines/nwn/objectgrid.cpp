@@ -0,0 +1,389 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file engines/nwn/objectgrid.cpp
+ *  A spatial index over the objects within a NWN area.
+ */
+
+#include <cfloat>
+#include <cmath>
+
+#include <algorithm>
+
+#include "common/util.h"
+
+#include "engines/nwn/objectgrid.h"
+#include "engines/nwn/object.h"
+
+namespace Engines {
+
+namespace NWN {
+
+ObjectGrid::ObjectGrid() : _cellSize(1.0), _width(1), _height(1), _maxRadius(0.0), _cells(1) {
+}
+
+ObjectGrid::~ObjectGrid() {
+}
+
+void ObjectGrid::init(float width, float height, float cellSize) {
+	_cellSize = MAX<float>(cellSize, 1.0);
+
+	_width  = MAX<int>((int) ceilf(width  / _cellSize), 1);
+	_height = MAX<int>((int) ceilf(height / _cellSize), 1);
+
+	_cells.clear();
+	_cells.resize(_width * _height);
+
+	// Refile all objects we already know about
+	for (EntryMap::iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		place(e->second);
+		addToCells(e->second);
+	}
+}
+
+void ObjectGrid::clear() {
+	_entries.clear();
+
+	_maxRadius = 0.0;
+
+	_cells.clear();
+	_cells.resize(_width * _height);
+}
+
+void ObjectGrid::update(Object &object, float radius) {
+	std::pair<EntryMap::iterator, bool> result =
+		_entries.insert(std::make_pair(&object, Entry()));
+
+	Entry &entry = result.first->second;
+
+	const bool isNew = result.second;
+
+	const int oldMinX = entry.minX, oldMinY = entry.minY;
+	const int oldMaxX = entry.maxX, oldMaxY = entry.maxY;
+
+	entry.object = &object;
+	entry.radius = radius;
+
+	_maxRadius = MAX(_maxRadius, radius);
+
+	object.getPosition(entry.position[0], entry.position[1], entry.position[2]);
+
+	place(entry);
+
+	if (isNew) {
+		addToCells(entry);
+		return;
+	}
+
+	// Only touch the cells if the object actually touches different ones now
+	if ((oldMinX == entry.minX) && (oldMinY == entry.minY) &&
+	    (oldMaxX == entry.maxX) && (oldMaxY == entry.maxY))
+		return;
+
+	Entry oldEntry = entry;
+	oldEntry.minX = oldMinX;
+	oldEntry.minY = oldMinY;
+	oldEntry.maxX = oldMaxX;
+	oldEntry.maxY = oldMaxY;
+
+	removeFromCells(oldEntry);
+	addToCells(entry);
+}
+
+void ObjectGrid::remove(Object &object) {
+	EntryMap::iterator e = _entries.find(&object);
+	if (e == _entries.end())
+		return;
+
+	removeFromCells(e->second);
+
+	_entries.erase(e);
+}
+
+void ObjectGrid::getObjects(std::vector<Object *> &objects) const {
+	objects.reserve(objects.size() + _entries.size());
+
+	for (EntryMap::const_iterator e = _entries.begin(); e != _entries.end(); ++e)
+		objects.push_back(e->second.object);
+}
+
+Object *ObjectGrid::findNearest(float x, float y, float z,
+                                const Filter &filter, uint32 nth) const {
+
+	const int cellX = getCellX(x);
+	const int cellY = getCellY(y);
+
+	// How far outside of the grid the position lies
+	const float outX = MAX<float>(MAX<float>(-x, x - _width  * _cellSize), 0.0);
+	const float outY = MAX<float>(MAX<float>(-y, y - _height * _cellSize), 0.0);
+	const float out  = sqrtf(outX * outX + outY * outY);
+
+	const int maxRing = MAX(MAX(cellX, _width  - 1 - cellX),
+	                        MAX(cellY, _height - 1 - cellY));
+
+	std::vector<Candidate> candidates;
+
+	// Search in rings of cells around the position, until we're sure we've seen the nth nearest
+	for (int ring = 0; ring <= maxRing; ring++) {
+		for (int cY = cellY - ring; cY <= cellY + ring; cY++) {
+			if ((cY < 0) || (cY >= _height))
+				continue;
+
+			const bool edge = (cY == cellY - ring) || (cY == cellY + ring);
+			const int step = edge ? 1 : (2 * ring);
+
+			for (int cX = cellX - ring; cX <= cellX + ring; cX += step)
+				if ((cX >= 0) && (cX < _width))
+					collect(cX, cY, x, y, z, filter, candidates);
+		}
+
+		if (candidates.size() <= nth)
+			continue;
+
+		std::sort(candidates.begin(), candidates.end());
+
+		// Every object outside the rings searched so far is at least that far away
+		const float safeDistance = ring * _cellSize - out;
+		if (candidates[nth].first <= safeDistance)
+			return candidates[nth].second;
+	}
+
+	if (candidates.size() <= nth)
+		return 0;
+
+	return candidates[nth].second;
+}
+
+void ObjectGrid::findWithin(float x, float y, float z, float distance,
+                            const Filter &filter, std::vector<Object *> &objects) const {
+
+	const int minX = getCellX(x - distance), maxX = getCellX(x + distance);
+	const int minY = getCellY(y - distance), maxY = getCellY(y + distance);
+
+	std::vector<Candidate> candidates;
+	for (int cY = minY; cY <= maxY; cY++)
+		for (int cX = minX; cX <= maxX; cX++)
+			collect(cX, cY, x, y, z, filter, candidates);
+
+	std::sort(candidates.begin(), candidates.end());
+
+	for (std::vector<Candidate>::const_iterator c = candidates.begin(); c != candidates.end(); ++c) {
+		if (c->first > distance)
+			break;
+
+		objects.push_back(c->second);
+	}
+}
+
+Object *ObjectGrid::findAlongLine(float x1, float y1, float x2, float y2,
+                                  const Filter &filter) const {
+
+	// Clip the line to the grid, including the parts of objects sticking out of it
+
+	const float dX = x2 - x1;
+	const float dY = y2 - y1;
+
+	float tMin = 0.0, tMax = 1.0;
+
+	const float minX = -_maxRadius, maxX = _width  * _cellSize + _maxRadius;
+	const float minY = -_maxRadius, maxY = _height * _cellSize + _maxRadius;
+
+	const float p[4] = { -dX, dX, -dY, dY };
+	const float q[4] = { x1 - minX, maxX - x1, y1 - minY, maxY - y1 };
+
+	for (int i = 0; i < 4; i++) {
+		if (p[i] == 0.0) {
+			if (q[i] < 0.0)
+				return 0;
+
+			continue;
+		}
+
+		const float t = q[i] / p[i];
+		if (p[i] < 0.0)
+			tMin = MAX(tMin, t);
+		else
+			tMax = MIN(tMax, t);
+	}
+
+	if (tMin > tMax)
+		return 0;
+
+	// Walk all cells along the line, starting at x1.y1. Outside the grid, use its edge cells
+
+	const float startX = (x1 + tMin * dX) / _cellSize;
+	const float startY = (y1 + tMin * dY) / _cellSize;
+
+	int cellX = (int) floorf(startX);
+	int cellY = (int) floorf(startY);
+
+	const int stepX = (dX > 0.0) ? 1 : -1;
+	const int stepY = (dY > 0.0) ? 1 : -1;
+
+	const float lengthX = ABS(dX) / _cellSize;
+	const float lengthY = ABS(dY) / _cellSize;
+
+	const float tDeltaX = (lengthX > 0.0) ? (1.0 / lengthX) : FLT_MAX;
+	const float tDeltaY = (lengthY > 0.0) ? (1.0 / lengthY) : FLT_MAX;
+
+	float tNextX = (lengthX > 0.0) ?
+		(((stepX > 0) ? (cellX + 1 - startX) : (startX - cellX)) * tDeltaX) : FLT_MAX;
+	float tNextY = (lengthY > 0.0) ?
+		(((stepY > 0) ? (cellY + 1 - startY) : (startY - cellY)) * tDeltaY) : FLT_MAX;
+
+	// Rank the objects by where along the line they come closest to their position
+	const float length2 = dX * dX + dY * dY;
+
+	// How far along the line the largest object extends
+	const float radiusT = (length2 > 0.0) ? (_maxRadius / sqrtf(length2)) : 0.0;
+
+	Object *best  = 0;
+	float   bestT = FLT_MAX;
+
+	while (true) {
+		const Cell &cell = getCell(CLIP(cellX, 0, _width - 1), CLIP(cellY, 0, _height - 1));
+
+		for (Cell::const_iterator c = cell.begin(); c != cell.end(); ++c) {
+			const Entry &entry = **c;
+
+			const float distX = entry.position[0] - x1;
+			const float distY = entry.position[1] - y1;
+
+			const float t = (length2 > 0.0) ? ((distX * dX + distY * dY) / length2) : 0.0;
+
+			// Also skips objects we've already seen in a previous cell
+			if (t >= bestT)
+				continue;
+
+			// Does the object's extent cross the line at all?
+			const float missX = distX - t * dX;
+			const float missY = distY - t * dY;
+			if ((missX * missX + missY * missY) > (entry.radius * entry.radius))
+				continue;
+
+			if (!filter(*entry.object))
+				continue;
+
+			best  = entry.object;
+			bestT = t;
+		}
+
+		const float tNext = MIN(tNextX, tNextY);
+		if (tNext > (tMax - tMin))
+			break;
+
+		// An object crossing the line before the best hit is filed into a cell we've already walked
+		if (best && ((tMin + tNext) > (bestT + radiusT)))
+			break;
+
+		if (tNextX < tNextY) {
+			tNextX += tDeltaX;
+			cellX  += stepX;
+		} else {
+			tNextY += tDeltaY;
+			cellY  += stepY;
+		}
+	}
+
+	return best;
+}
+
+int ObjectGrid::getCellX(float x) const {
+	return CLIP<int>((int) floorf(x / _cellSize), 0, _width - 1);
+}
+
+int ObjectGrid::getCellY(float y) const {
+	return CLIP<int>((int) floorf(y / _cellSize), 0, _height - 1);
+}
+
+ObjectGrid::Cell &ObjectGrid::getCell(int x, int y) {
+	return _cells[y * _width + x];
+}
+
+const ObjectGrid::Cell &ObjectGrid::getCell(int x, int y) const {
+	return _cells[y * _width + x];
+}
+
+void ObjectGrid::place(Entry &entry) {
+	const float x = entry.position[0];
+	const float y = entry.position[1];
+
+	entry.cellX = getCellX(x);
+	entry.cellY = getCellY(y);
+
+	entry.minX = getCellX(x - entry.radius);
+	entry.minY = getCellY(y - entry.radius);
+	entry.maxX = getCellX(x + entry.radius);
+	entry.maxY = getCellY(y + entry.radius);
+}
+
+void ObjectGrid::addToCells(const Entry &entry) {
+	for (int y = entry.minY; y <= entry.maxY; y++)
+		for (int x = entry.minX; x <= entry.maxX; x++)
+			getCell(x, y).push_back(&entry);
+}
+
+void ObjectGrid::removeFromCells(const Entry &entry) {
+	for (int y = entry.minY; y <= entry.maxY; y++) {
+		for (int x = entry.minX; x <= entry.maxX; x++) {
+			Cell &cell = getCell(x, y);
+
+			for (Cell::iterator c = cell.begin(); c != cell.end(); ++c) {
+				if ((*c)->object == entry.object) {
+					*c = cell.back();
+					cell.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+void ObjectGrid::collect(int cellX, int cellY, float x, float y, float z,
+                         const Filter &filter, std::vector<Candidate> &candidates) const {
+
+	const Cell &cell = getCell(cellX, cellY);
+
+	for (Cell::const_iterator c = cell.begin(); c != cell.end(); ++c) {
+		const Entry &entry = **c;
+
+		// Only count objects in the cell of their position, so that each is found once
+		if ((entry.cellX != cellX) || (entry.cellY != cellY))
+			continue;
+
+		if (!filter(*entry.object))
+			continue;
+
+		const float dX = entry.position[0] - x;
+		const float dY = entry.position[1] - y;
+		const float dZ = entry.position[2] - z;
+
+		candidates.push_back(std::make_pair(sqrtf(dX * dX + dY * dY + dZ * dZ), entry.object));
+	}
+}
+
+} // End of namespace NWN
+
+} // End of namespace Engines
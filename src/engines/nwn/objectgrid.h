@@ -0,0 +1,135 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file engines/nwn/objectgrid.h
+ *  A spatial index over the objects within a NWN area.
+ */
+
+#ifndef ENGINES_NWN_OBJECTGRID_H
+#define ENGINES_NWN_OBJECTGRID_H
+
+#include <vector>
+#include <map>
+
+#include "boost/function.hpp"
+
+#include "common/types.h"
+
+namespace Engines {
+
+namespace NWN {
+
+class Object;
+
+/** A uniform grid over the ground plane of an area.
+ *
+ *  Each object is filed into every cell touched by the circle of its
+ *  horizontal extent around its position. Updating an object only touches
+ *  the cells it enters and leaves.
+ */
+class ObjectGrid {
+public:
+	/** Does the object match a query? */
+	typedef boost::function<bool (const Object &)> Filter;
+
+	ObjectGrid();
+	~ObjectGrid();
+
+	/** Cover an area of that width and height with cells of that size. */
+	void init(float width, float height, float cellSize);
+
+	/** Remove all objects. */
+	void clear();
+
+	/** Add the object, or update its position and extent radius. */
+	void update(Object &object, float radius = 0.0);
+	/** Remove the object. */
+	void remove(Object &object);
+
+	/** Return all objects within the grid. */
+	void getObjects(std::vector<Object *> &objects) const;
+
+	/** Find the nth (starting at 0) nearest object to that position matching the filter. */
+	Object *findNearest(float x, float y, float z, const Filter &filter, uint32 nth = 0) const;
+
+	/** Find all objects within that distance of a position matching the filter, nearest first. */
+	void findWithin(float x, float y, float z, float distance, const Filter &filter,
+	                std::vector<Object *> &objects) const;
+
+	/** Find the first object along the line from x1.y1 to x2.y2 whose extent crosses it and that matches the filter. */
+	Object *findAlongLine(float x1, float y1, float x2, float y2, const Filter &filter) const;
+
+private:
+	/** An object filed into the grid. */
+	struct Entry {
+		Object *object;
+
+		float position[3];
+		float radius;
+
+		int cellX; ///< X coordinate of the cell containing the object's position.
+		int cellY; ///< Y coordinate of the cell containing the object's position.
+
+		int minX, minY; ///< The first cell touched by the object's extent.
+		int maxX, maxY; ///< The last cell touched by the object's extent.
+	};
+
+	typedef std::map<Object *, Entry> EntryMap;
+	typedef std::vector<const Entry *> Cell;
+
+	/** An object found by a query, together with its distance. */
+	typedef std::pair<float, Object *> Candidate;
+
+	float _cellSize;
+
+	int _width;  ///< Width of the grid in cells.
+	int _height; ///< Height of the grid in cells.
+
+	float _maxRadius; ///< The largest extent radius of any object.
+
+	EntryMap _entries;
+	std::vector<Cell> _cells;
+
+	int getCellX(float x) const;
+	int getCellY(float y) const;
+
+	Cell &getCell(int x, int y);
+	const Cell &getCell(int x, int y) const;
+
+	void place(Entry &entry);
+
+	void addToCells(const Entry &entry);
+	void removeFromCells(const Entry &entry);
+
+	/** Collect all objects matching the filter whose position lies in that cell. */
+	void collect(int cellX, int cellY, float x, float y, float z,
+	             const Filter &filter, std::vector<Candidate> &candidates) const;
+};
+
+} // End of namespace NWN
+
+} // End of namespace Engines
+
+#endif // ENGINES_NWN_OBJECTGRID_H
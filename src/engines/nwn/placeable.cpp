@@ -30,6 +30,7 @@
 #include "common/util.h"
 
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/2dafile.h"
 #include "aurora/2dareg.h"
 
@@ -58,18 +59,9 @@ Placeable::~Placeable() {
 void Placeable::load(const Aurora::GFFStruct &placeable) {
 	Common::UString temp = placeable.getString("TemplateResRef");
 
-	Aurora::GFFFile *utp = 0;
-	if (!temp.empty()) {
-		try {
-			utp = new Aurora::GFFFile(temp, Aurora::kFileTypeUTP, MKID_BE('UTP '));
-		} catch (...) {
-			delete utp;
-		}
-	}
-
-	Situated::load(placeable, utp ? &utp->getTopLevel() : 0);
+	const Aurora::GFFStruct *utp = BlueprintReg.get(temp, Aurora::kFileTypeUTP, MKID_BE('UTP '));
 
-	delete utp;
+	Situated::load(placeable, utp);
 }
 
 void Placeable::setModelState() {
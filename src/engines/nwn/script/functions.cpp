@@ -51,22 +51,6 @@ namespace Engines {
 
 namespace NWN {
 
-ObjectDistanceSort::ObjectDistanceSort(const Object &target) {
-	target.getPosition(xt, yt, zt);
-}
-
-bool ObjectDistanceSort::operator()(Object *a, Object *b) {
-	return getDistance(*a) < getDistance(*b);
-}
-
-float ObjectDistanceSort::getDistance(Object &a) {
-	float x, y, z;
-	a.getPosition(x, y, z);
-
-	return ABS(x - xt) + ABS(y - yt) + ABS(z - zt);
-}
-
-
 ScriptFunctions::Defaults::Defaults() {
 	int0             = new Aurora::NWScript::Variable(0);
 	int1             = new Aurora::NWScript::Variable(1);
@@ -168,7 +152,7 @@ ScriptFunctions::Defaults::~Defaults() {
 }
 
 
-ScriptFunctions::ScriptFunctions() {
+ScriptFunctions::ScriptFunctions() : _objectInShape(0) {
 	registerFunctions();
 }
 
@@ -333,6 +317,16 @@ void ScriptFunctions::jumpTo(Object *object, Area *area, float x, float y, float
 		_module->movedPC();
 }
 
+bool ScriptFunctions::matchObjectType(const Object &object, int type, const Object *exclude) {
+	return (&object != exclude) && !object.isStatic() && ((object.getType() & type) != 0);
+}
+
+bool ScriptFunctions::matchObjectTag(const Object &object, const Common::UString &tag,
+                                     const Object *exclude) {
+
+	return (&object != exclude) && !object.isStatic() && (object.getTag() == tag);
+}
+
 } // End of namespace NWN
 
 } // End of namespace Engines
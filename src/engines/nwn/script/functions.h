@@ -30,6 +30,8 @@
 #ifndef ENGINES_NWN_SCRIPT_FUNCTIONS_H
 #define ENGINES_NWN_SCRIPT_FUNCTIONS_H
 
+#include <vector>
+
 #include "aurora/nwscript/objectcontainer.h"
 
 namespace Aurora {
@@ -55,18 +57,6 @@ class Creature;
 
 class Location;
 
-class ObjectDistanceSort {
-public:
-	ObjectDistanceSort(const Object &target);
-
-	bool operator()(Object *a, Object *b);
-
-private:
-	float xt, yt, zt;
-
-	float getDistance(Object &a);
-};
-
 class ScriptFunctions {
 public:
 	ScriptFunctions();
@@ -132,6 +122,9 @@ private:
 
 	Aurora::NWScript::ObjectContainer::SearchContext _objSearchContext;
 
+	std::vector<Object *> _objectsInShape; ///< The objects found by GetFirstObjectInShape().
+	size_t _objectInShape; ///< The next object in shape to return.
+
 
 	void registerFunctions();
 	void registerFunctions000(const Defaults &d);
@@ -164,6 +157,12 @@ private:
 
 	void jumpTo(Object *object, Area *area, float x, float y, float z);
 
+	/** Is the object of one of these types, not static, and not the excluded object? */
+	static bool matchObjectType(const Object &object, int type, const Object *exclude);
+	/** Does the object have that tag, and is it neither static nor the excluded object? */
+	static bool matchObjectTag(const Object &object, const Common::UString &tag,
+	                           const Object *exclude);
+
 	void random(Aurora::NWScript::FunctionContext &ctx);
 	void printString(Aurora::NWScript::FunctionContext &ctx);
 	void printFloat(Aurora::NWScript::FunctionContext &ctx);
@@ -41,6 +41,7 @@
 
 #include "engines/nwn/types.h"
 #include "engines/nwn/module.h"
+#include "engines/nwn/area.h"
 #include "engines/nwn/object.h"
 #include "engines/nwn/door.h"
 #include "engines/nwn/creature.h"
@@ -685,10 +686,10 @@ void ScriptFunctions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx)
 	if (ctx.getParamsSpecified() < 3)
 		target = convertObject(ctx.getCaller());
 
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
-	int nth = ctx.getParams()[3].getInt() - 1;
+	int nth = MAX<int>(ctx.getParams()[3].getInt() - 1, 0);
 
 	// TODO: ScriptFunctions::getNearestCreature(): Critia
 	/*
@@ -700,25 +701,11 @@ void ScriptFunctions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx)
 	int crit3Value = ctx.getParams()[7].getInt();
 	*/
 
-	if (!_module->findObjectInit(_objSearchContext))
-		return;
-
-	std::list<Object *> creatures;
-	while (_module->findNextObject(_objSearchContext)) {
-		Creature *creature = convertCreature(_objSearchContext.getObject());
-
-		if (creature && (creature != target) && (creature->getArea() == target->getArea()))
-			creatures.push_back(creature);
-	}
-
-	creatures.sort(ObjectDistanceSort(*target));
-
-	std::list<Object *>::iterator it = creatures.begin();
-	for (int n = 0; (n < nth) && (it != creatures.end()); ++n)
-		++it;
+	float x, y, z;
+	target->getPosition(x, y, z);
 
-	if (it != creatures.end())
-		ctx.getReturn() = *it;
+	ctx.getReturn() = target->getArea()->findNearestObject(x, y, z,
+			boost::bind(&matchObjectType, _1, (int) kObjectTypeCreature, target), nth);
 }
 
 void ScriptFunctions::actionSpeakString(Aurora::NWScript::FunctionContext &ctx) {
@@ -39,9 +39,11 @@
 
 #include "engines/nwn/types.h"
 #include "engines/nwn/module.h"
+#include "engines/nwn/area.h"
 #include "engines/nwn/object.h"
 #include "engines/nwn/waypoint.h"
 #include "engines/nwn/creature.h"
+#include "engines/nwn/location.h"
 
 #include "engines/nwn/script/functions.h"
 
@@ -542,11 +544,38 @@ void ScriptFunctions::getAlignmentGoodEvil(Aurora::NWScript::FunctionContext &ct
 }
 
 void ScriptFunctions::getFirstObjectInShape(Aurora::NWScript::FunctionContext &ctx) {
-	warning("TODO: GetFirstObjectInShape");
+	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
+
+	_objectsInShape.clear();
+	_objectInShape = 0;
+
+	Location *loc = convertLocation(ctx.getParams()[2].getEngineType());
+	if (!loc || !loc->getArea())
+		return;
+
+	int   shape = ctx.getParams()[0].getInt();
+	float size  = ctx.getParams()[1].getFloat();
+	int   type  = ctx.getParams()[4].getInt();
+
+	// TODO: ScriptFunctions::getFirstObjectInShape(): Line of sight
+	if (shape != kShapeSphere)
+		warning("TODO: GetFirstObjectInShape(): Shape %d, using a sphere", shape);
+
+	float x, y, z;
+	loc->getPosition(x, y, z);
+
+	loc->getArea()->findObjectsWithin(x, y, z, size,
+			boost::bind(&matchObjectType, _1, type, (Object *) 0), _objectsInShape);
+
+	if (_objectInShape < _objectsInShape.size())
+		ctx.getReturn() = _objectsInShape[_objectInShape++];
 }
 
 void ScriptFunctions::getNextObjectInShape(Aurora::NWScript::FunctionContext &ctx) {
-	warning("TODO: GetNextObjectInShape");
+	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
+
+	if (_objectInShape < _objectsInShape.size())
+		ctx.getReturn() = _objectsInShape[_objectInShape++];
 }
 
 void ScriptFunctions::effectEntangle(Aurora::NWScript::FunctionContext &ctx) {
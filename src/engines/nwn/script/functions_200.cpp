@@ -610,7 +610,21 @@ void ScriptFunctions::getFacingFromLocation(Aurora::NWScript::FunctionContext &c
 }
 
 void ScriptFunctions::getNearestCreatureToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	warning("TODO: GetNearestCreatureToLocation");
+	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
+
+	Location *loc = convertLocation(ctx.getParams()[2].getEngineType());
+	if (!loc || !loc->getArea())
+		return;
+
+	int nth = MAX<int>(ctx.getParams()[3].getInt() - 1, 0);
+
+	// TODO: ScriptFunctions::getNearestCreatureToLocation(): Critia
+
+	float x, y, z;
+	loc->getPosition(x, y, z);
+
+	ctx.getReturn() = loc->getArea()->findNearestObject(x, y, z,
+			boost::bind(&matchObjectType, _1, (int) kObjectTypeCreature, (Object *) 0), nth);
 }
 
 void ScriptFunctions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
@@ -620,42 +634,38 @@ void ScriptFunctions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
 	if (ctx.getParamsSpecified() < 2)
 		target = convertObject(ctx.getCaller());
 
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
-	ObjectType type = (ObjectType) ctx.getParams()[0].getInt();
-	int nth = ctx.getParams()[2].getInt() - 1;
+	int type = ctx.getParams()[0].getInt();
+	int nth  = MAX<int>(ctx.getParams()[2].getInt() - 1, 0);
 
-	if (!_module->findObjectInit(_objSearchContext))
-		return;
+	float x, y, z;
+	target->getPosition(x, y, z);
 
-	std::list<Object *> objects;
-	while (_module->findNextObject(_objSearchContext)) {
-		Object *object = convertObject(_objSearchContext.getObject());
+	ctx.getReturn() = target->getArea()->findNearestObject(x, y, z,
+			boost::bind(&matchObjectType, _1, type, target), nth);
+}
 
-		if (object && (object != target) && (object->getType() == type) &&
-		    (object->getArea() == target->getArea()))
-			objects.push_back(object);
-	}
+void ScriptFunctions::getNearestObjectToLocation(Aurora::NWScript::FunctionContext &ctx) {
+	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
 
-	objects.sort(ObjectDistanceSort(*target));
+	Location *loc = convertLocation(ctx.getParams()[1].getEngineType());
+	if (!loc || !loc->getArea())
+		return;
 
-	std::list<Object *>::iterator it = objects.begin();
-	for (int n = 0; (n < nth) && (it != objects.end()); ++n)
-		++it;
+	int type = ctx.getParams()[0].getInt();
+	int nth  = MAX<int>(ctx.getParams()[2].getInt() - 1, 0);
 
-	if (it != objects.end())
-		ctx.getReturn() = *it;
-}
+	float x, y, z;
+	loc->getPosition(x, y, z);
 
-void ScriptFunctions::getNearestObjectToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	warning("TODO: GetNearestObjectToLocation");
+	ctx.getReturn() = loc->getArea()->findNearestObject(x, y, z,
+			boost::bind(&matchObjectType, _1, type, (Object *) 0), nth);
 }
 
 void ScriptFunctions::getNearestObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn() = (Object *) 0;
-	if (!_module)
-		return;
+	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
 
 	const Common::UString &tag = ctx.getParams()[0].getString();
 	if (tag.empty())
@@ -664,30 +674,16 @@ void ScriptFunctions::getNearestObjectByTag(Aurora::NWScript::FunctionContext &c
 	Object *target = convertObject(ctx.getParams()[1].getObject());
 	if (ctx.getParamsSpecified() < 2)
 		target = convertObject(ctx.getCaller());
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
-	int nth = ctx.getParams()[2].getInt() - 1;
+	int nth = MAX<int>(ctx.getParams()[2].getInt() - 1, 0);
 
-	if (!_module->findObjectInit(_objSearchContext, tag))
-		return;
-
-	std::list<Object *> objects;
-	while (_module->findNextObject(_objSearchContext)) {
-		Object *object = convertObject(_objSearchContext.getObject());
-
-		if (object && (object != target) && (object->getArea() == target->getArea()))
-			objects.push_back(object);
-	}
-
-	objects.sort(ObjectDistanceSort(*target));
-
-	std::list<Object *>::iterator it = objects.begin();
-	for (int n = 0; (n < nth) && (it != objects.end()); ++n)
-		++it;
+	float x, y, z;
+	target->getPosition(x, y, z);
 
-	if (it != objects.end())
-		ctx.getReturn() = *it;
+	ctx.getReturn() = target->getArea()->findNearestObject(x, y, z,
+			boost::bind(&matchObjectTag, _1, boost::cref(tag), target), nth);
 }
 
 void ScriptFunctions::intToFloat(Aurora::NWScript::FunctionContext &ctx) {
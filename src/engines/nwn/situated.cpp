@@ -105,6 +105,10 @@ void Situated::hide() {
 		_model->hide();
 }
 
+Graphics::Aurora::Model *Situated::getModel() const {
+	return _model;
+}
+
 void Situated::setPosition(float x, float y, float z) {
 	Object::setPosition(x, y, z);
 	Object::getPosition(x, y, z);
@@ -51,6 +51,9 @@ public:
 	void show(); ///< Show the situated object's model.
 	void hide(); ///< Hide the situated object's model.
 
+	/** Return the situated object's model. */
+	Graphics::Aurora::Model *getModel() const;
+
 	/** Set the situated object's position. */
 	void setPosition(float x, float y, float z);
 	/** Set the situated object's orientation. */
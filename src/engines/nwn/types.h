@@ -239,6 +239,14 @@ enum Alignment {
 	kAlignmentEvil    = 5
 };
 
+enum Shape {
+	kShapeSpellCylinder = 0,
+	kShapeCone          = 1,
+	kShapeCube          = 2,
+	kShapeSpellCone     = 3,
+	kShapeSphere        = 4
+};
+
 static const uint32 kActionInvalid     = 0xFFFF;
 static const uint32 kObjectTypeInvalid = 0x7FFF;
 
@@ -33,6 +33,7 @@
 #include "aurora/locstring.h"
 #include "aurora/resman.h"
 #include "aurora/gfffile.h"
+#include "aurora/blueprintreg.h"
 
 #include "engines/aurora/util.h"
 
@@ -55,18 +56,9 @@ Waypoint::~Waypoint() {
 void Waypoint::load(const Aurora::GFFStruct &waypoint) {
 	Common::UString temp = waypoint.getString("TemplateResRef");
 
-	Aurora::GFFFile *utw = 0;
-	if (!temp.empty()) {
-		try {
-			utw = new Aurora::GFFFile(temp, Aurora::kFileTypeUTW, MKID_BE('UTW '));
-		} catch (...) {
-			delete utw;
-		}
-	}
-
-	load(waypoint, utw ? &utw->getTopLevel() : 0);
+	const Aurora::GFFStruct *utw = BlueprintReg.get(temp, Aurora::kFileTypeUTW, MKID_BE('UTW '));
 
-	delete utw;
+	load(waypoint, utw);
 }
 
 bool Waypoint::hasMapNote() const {
@@ -197,9 +197,13 @@ void TheWitcherEngine::run(const Common::UString &target) {
 
 	delete model;
 	delete fps;
+
+	clearModelCache();
 }
 
 void TheWitcherEngine::init() {
+	uint32 startTime = EventMan.getTimestamp();
+
 	status("Setting base directory");
 	ResMan.registerDataBaseDir(_baseDirectory);
 
@@ -242,6 +246,9 @@ void TheWitcherEngine::init() {
 	status("Indexing override files");
 	indexOptionalDirectory("data/override", 0, 0, 50);
 
+	status("Indexing resources took %dms", EventMan.getTimestamp() - startTime);
+	ResMan.saveIndexCache();
+
 	registerModelLoader(new TheWitcherModelLoader);
 
 	FontMan.setFormat(Graphics::Aurora::kFontFormatTTF);
@@ -41,7 +41,9 @@
 
 #include "aurora/resman.h"
 #include "aurora/2dareg.h"
+#include "aurora/blueprintreg.h"
 #include "aurora/talkman.h"
+#include "aurora/nwscript/ncsfile.h"
 
 #include "graphics/queueman.h"
 #include "graphics/graphics.h"
@@ -130,6 +132,11 @@ int main(int argc, char **argv) {
 	if (!Common::FilePath::isDirectory(baseDir) && !Common::FilePath::isRegularFile(baseDir))
 		error("No such file or directory \"%s\"", baseDir.c_str());
 
+	// Cache the resource indices, for a faster startup
+	Common::UString indexCache = ConfigMan.getString("indexcache");
+	if (!indexCache.empty())
+		ResMan.setIndexCache(indexCache);
+
 	Engines::GameThread *gameThread = new Engines::GameThread;
 	try {
 		// Initialize all necessary subsystems
@@ -260,6 +267,8 @@ void deinit() {
 
 	Aurora::TalkManager::destroy();
 	Aurora::TwoDARegistry::destroy();
+	Aurora::BlueprintRegistry::destroy();
+	Aurora::NWScript::NCSFile::clearCache();
 	Aurora::ResourceManager::destroy();
 
 	Engines::EngineManager::destroy();
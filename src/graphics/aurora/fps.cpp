@@ -38,12 +38,14 @@ namespace Graphics {
 
 namespace Aurora {
 
-FPS::FPS(const FontHandle &font) : Text(font, "0 fps"), _fps(0) {
+FPS::FPS(const FontHandle &font) : Text(font, "0 fps"), _fps(0),
+	_objectsDrawn(0), _objectsCulled(0) {
+
 	init();
 }
 
 FPS::FPS(const FontHandle &font, float r, float g, float b, float a) :
-	Text(font, "0 fps", r, g, b, a), _fps(0) {
+	Text(font, "0 fps", r, g, b, a), _fps(0), _objectsDrawn(0), _objectsCulled(0) {
 
 	init();
 }
@@ -64,10 +66,20 @@ void FPS::render(RenderPass pass) {
 
 	uint32 fps = GfxMan.getFPS();
 
-	if (fps != _fps) {
+	uint32 objectsDrawn  = GfxMan.getObjectsDrawn();
+	uint32 objectsCulled = GfxMan.getObjectsCulled();
+
+	if ((fps != _fps) || (objectsDrawn != _objectsDrawn) || (objectsCulled != _objectsCulled)) {
 		_fps = fps;
 
-		set(Common::UString::sprintf("%d fps", _fps));
+		_objectsDrawn  = objectsDrawn;
+		_objectsCulled = objectsCulled;
+
+		if ((_objectsDrawn == 0) && (_objectsCulled == 0))
+			set(Common::UString::sprintf("%d fps", _fps));
+		else
+			set(Common::UString::sprintf("%d fps, %d drawn, %d culled",
+			                             _fps, _objectsDrawn, _objectsCulled));
 	}
 
 	Text::render(pass);
@@ -39,7 +39,7 @@ namespace Graphics {
 
 namespace Aurora {
 
-/** An autonomous FPS display. */
+/** An autonomous FPS display, together with the number of drawn and culled world objects. */
 class FPS : public Text, public Events::Notifyable {
 public:
 	FPS(const FontHandle &font);
@@ -52,6 +52,9 @@ public:
 private:
 	uint32 _fps;
 
+	uint32 _objectsDrawn;
+	uint32 _objectsCulled;
+
 	void init();
 
 	void notifyResized(int oldWidth, int oldHeight, int newWidth, int newHeight);
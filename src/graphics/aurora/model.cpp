@@ -31,6 +31,7 @@
 
 #include "graphics/graphics.h"
 #include "graphics/camera.h"
+#include "graphics/frustum.h"
 
 #include "graphics/aurora/model.h"
 #include "graphics/aurora/modelnode.h"
@@ -40,10 +41,7 @@ namespace Graphics {
 namespace Aurora {
 
 Model::Model(ModelType type) : Renderable((RenderableType) type),
-	_type(type), _currentState(0), _drawBound(false), _lists(0) {
-
-	for (int i = 0; i < kRenderPassAll; i++)
-		_needBuild[i] = true;
+	_type(type), _currentState(0), _drawBound(false) {
 
 	_position[0] = 0.0; _position[1] = 0.0; _position[2] = 0.0;
 	_rotation[0] = 0.0; _rotation[1] = 0.0; _rotation[2] = 0.0;
@@ -54,9 +52,6 @@ Model::Model(ModelType type) : Renderable((RenderableType) type),
 Model::~Model() {
 	hide();
 
-	if (_lists != 0)
-		GfxMan.abandon(_lists, kRenderPassAll);
-
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
 			delete *n;
@@ -73,6 +68,72 @@ const Common::UString &Model::getName() const {
 	return _name;
 }
 
+Model *Model::createInstance() const {
+	Model *instance = new Model(_type);
+
+	instance->_fileName = _fileName;
+	instance->_name     = _name;
+
+	for (int i = 0; i < 3; i++) {
+		instance->_modelScale[i] = _modelScale[i];
+		instance->_position  [i] = _position  [i];
+		instance->_rotation  [i] = _rotation  [i];
+		instance->_center    [i] = _center    [i];
+	}
+
+	instance->_absolutePosition = _absolutePosition;
+	instance->_boundBox         = _boundBox;
+	instance->_absoluteBoundBox = _absoluteBoundBox;
+	instance->_drawBound        = _drawBound;
+
+	// Copy all nodes, remembering which copy belongs to which original
+	std::map<const ModelNode *, ModelNode *> nodes;
+	for (StateList::const_iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
+		for (NodeList::const_iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n) {
+			ModelNode *node = new ModelNode(**n);
+
+			node->_model = instance;
+
+			nodes.insert(std::make_pair(*n, node));
+		}
+	}
+
+	// Point the node hierarchy to the copies
+	for (std::map<const ModelNode *, ModelNode *>::iterator n = nodes.begin(); n != nodes.end(); ++n) {
+		ModelNode &node = *n->second;
+
+		if (node._parent)
+			node._parent = nodes[node._parent];
+
+		for (std::list<ModelNode *>::iterator c = node._children.begin(); c != node._children.end(); ++c)
+			*c = nodes[*c];
+	}
+
+	// Recreate the states
+	for (StateList::const_iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
+		State *state = new State;
+
+		state->name = (*s)->name;
+
+		for (NodeList::const_iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
+			state->nodeList.push_back(nodes[*n]);
+		for (NodeList::const_iterator n = (*s)->rootNodes.begin(); n != (*s)->rootNodes.end(); ++n)
+			state->rootNodes.push_back(nodes[*n]);
+		for (NodeMap::const_iterator n = (*s)->nodeMap.begin(); n != (*s)->nodeMap.end(); ++n)
+			state->nodeMap.insert(std::make_pair(n->first, nodes[n->second]));
+
+		instance->_stateList.push_back(state);
+		instance->_stateMap.insert(std::make_pair(state->name, state));
+
+		if (*s == _currentState)
+			instance->_currentState = state;
+	}
+
+	instance->_stateNames = _stateNames;
+
+	return instance;
+}
+
 bool Model::isIn(float x, float y) const {
 	if (_type == kModelTypeGUIFront) {
 		x /= _modelScale[0];
@@ -109,6 +170,17 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+bool Model::isInFrustum(const Frustum &frustum) const {
+	if (_type != kModelTypeObject)
+		return true;
+
+	return frustum.isIn(_absoluteBoundBox);
+}
+
+const Common::BoundingBox &Model::getAbsoluteBound() const {
+	return _absoluteBoundBox;
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _modelScale[0];
 }
@@ -123,7 +195,6 @@ float Model::getDepth() const {
 
 void Model::drawBound(bool enabled) {
 	_drawBound = enabled;
-	needRebuild();
 }
 
 void Model::getPosition(float &x, float &y, float &z) const {
@@ -153,9 +224,9 @@ void Model::setPosition(float x, float y, float z) {
 
 	createAbsolutePosition();
 	calculateDistance();
-	needRebuild();
 
-	resort();
+	if (isVisible())
+		resort();
 
 	GfxMan.unlockFrame();
 }
@@ -169,9 +240,9 @@ void Model::setRotation(float x, float y, float z) {
 
 	createAbsolutePosition();
 	calculateDistance();
-	needRebuild();
 
-	resort();
+	if (isVisible())
+		resort();
 
 	GfxMan.unlockFrame();
 }
@@ -253,8 +324,6 @@ void Model::setState(const Common::UString &name) {
 	if (visible)
 		show();
 
-	needRebuild();
-
 	GfxMan.unlockFrame();
 }
 
@@ -323,29 +392,20 @@ void Model::calculateDistance() {
 	_distance = x + y + z;
 }
 
-bool Model::buildList(RenderPass pass) {
-	if (!_needBuild[pass])
-		return false;
-
-	if (_lists == 0)
-		_lists = glGenLists(kRenderPassAll);
+void Model::render(RenderPass pass) {
+	if (!_currentState || (pass > kRenderPassAll))
+		return;
 
-	glNewList(_lists + pass, GL_COMPILE);
+	if (pass == kRenderPassAll) {
+		Model::render(kRenderPassOpaque);
+		Model::render(kRenderPassTransparent);
+		return;
+	}
 
+	glPushMatrix();
 
 	// Apply our global model transformation
-
-	glScalef(_modelScale[0], _modelScale[1], _modelScale[2]);
-
-	if (_type == kModelTypeObject)
-		// Aurora world objects have a rotated axis
-		glRotatef(90.0, -1.0, 0.0, 0.0);
-
-	glTranslatef(_position[0], _position[1], _position[2]);
-
-	glRotatef( _rotation[0], 1.0, 0.0, 0.0);
-	glRotatef( _rotation[1], 0.0, 1.0, 0.0);
-	glRotatef(-_rotation[2], 0.0, 0.0, 1.0);
+	glMultMatrixf(_absolutePosition.get());
 
 
 	// Draw the bounding box, if requested
@@ -360,27 +420,7 @@ bool Model::buildList(RenderPass pass) {
 		glPopMatrix();
 	}
 
-
-	glEndList();
-
-
-	_needBuild[pass] = false;
-	return true;
-}
-
-void Model::render(RenderPass pass) {
-	if (!_currentState || (pass > kRenderPassAll))
-		return;
-
-	if (pass == kRenderPassAll) {
-		Model::render(kRenderPassOpaque);
-		Model::render(kRenderPassTransparent);
-		return;
-	}
-
-	// Render
-	buildList(pass);
-	glCallList(_lists + pass);
+	glPopMatrix();
 
 	// Reset the first texture units
 	TextureMan.reset();
@@ -442,18 +482,6 @@ void Model::doDrawBound() {
 	glEnd();
 }
 
-void Model::doRebuild() {
-	needRebuild();
-}
-
-void Model::doDestroy() {
-	if (_lists == 0)
-		return;
-
-	glDeleteLists(_lists, kRenderPassAll);
-	_lists = 0;
-}
-
 void Model::finalize() {
 	_currentState = 0;
 
@@ -461,18 +489,17 @@ void Model::finalize() {
 	setState();
 
 	createBound();
+	createAbsolutePosition();
 
 	// Order all node children lists
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s)
 		for (NodeList::iterator n = (*s)->rootNodes.begin(); n != (*s)->rootNodes.end(); ++n)
 			(*n)->orderChildren();
 
-	needRebuild();
-}
-
-void Model::needRebuild() {
-	for (int i = 0; i < kRenderPassAll; i++)
-		_needBuild[i] = true;
+	// Pack the geometry of all nodes into mesh buffers
+	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s)
+		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
+			(*n)->createMesh();
 }
 
 void Model::createStateNamesList() {
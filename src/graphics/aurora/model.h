@@ -39,7 +39,6 @@
 #include "common/boundingbox.h"
 
 #include "graphics/types.h"
-#include "graphics/glcontainer.h"
 #include "graphics/renderable.h"
 
 #include "graphics/aurora/types.h"
@@ -54,7 +53,7 @@ namespace Aurora {
 
 class ModelNode;
 
-class Model : public GLContainer, public Renderable {
+class Model : public Renderable {
 public:
 	Model(ModelType type = kModelTypeObject);
 	~Model();
@@ -64,10 +63,20 @@ public:
 	/** Get the model's name. */
 	const Common::UString &getName() const;
 
+	/** Create a new instance of this model.
+	 *
+	 *  The instance shares the geometry and textures of all nodes with this
+	 *  model, but has its own position, rotation, state and node visibility.
+	 */
+	Model *createInstance() const;
+
 	float getWidth () const; ///< Get the width of the model's bounding box.
 	float getHeight() const; ///< Get the height of the model's bounding box.
 	float getDepth () const; ///< Get the depth of the model's bounding box.
 
+	/** Get the model's bounding box, in world coordinates. */
+	const Common::BoundingBox &getAbsoluteBound() const;
+
 	/** Should a bounding box be drawn around this model? */
 	void drawBound(bool enabled);
 
@@ -79,6 +88,9 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with model's bounding box? */
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Is the model's bounding box at least partially within the view frustum? */
+	bool isInFrustum(const Frustum &frustum) const;
+
 
 	// Positioning
 
@@ -165,6 +177,7 @@ protected:
 	float _rotation[3]; ///< Model's rotation.
 	float _center  [3]; ///< Model's center.
 
+	/** The model's world transformation, applied when drawing. */
 	Common::TransformationMatrix _absolutePosition;
 
 	/** The model's bounding box. */
@@ -175,23 +188,11 @@ protected:
 
 	/** Finalize the loading procedure. */
 	void finalize();
-	/** Signal that the nodes changed and the OpenGL list needs to be rebuild. */
-	void needRebuild();
-
-
-	// GLContainer
-	void doRebuild();
-	void doDestroy();
 
 
 private:
-	bool _needBuild[kRenderPassAll];
 	bool _drawBound;
 
-	ListID _lists; ///< OpenGL display lists for the model
-
-
-	bool buildList(RenderPass pass);
 
 	void createStateNamesList(); ///< Create the list of all state names.
 	void createBound();          ///< Create the model's bounding box.
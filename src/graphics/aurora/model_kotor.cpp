@@ -115,6 +115,11 @@ Model_KotOR::ParserContext::ParserContext(const Common::UString &name,
 		if (!(mdx = ResMan.getResource(name, ::Aurora::kFileTypeMDX)))
 			throw Common::Exception("No such MDX \"%s\"", name.c_str());
 
+		mdlData = Common::MemoryReader(*mdl);
+		mdxData = Common::MemoryReader(*mdx);
+
+		mdl->seek(0);
+
 	} catch (...) {
 		delete mdl;
 		delete mdx;
@@ -542,19 +547,22 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 		tY[t].resize(vertexCount);
 	}
 
+	// The geometry is read directly out of memory
+	Common::MemoryReader mdx(ctx.mdxData);
+
 	for (int i = 0; i < vertexCount; i++) {
-		ctx.mdx->seekTo(offNodeData + i * mdxStructSize);
+		mdx.seek(offNodeData + i * mdxStructSize);
 
-		vX[i] = ctx.mdx->readIEEEFloatLE();
-		vY[i] = ctx.mdx->readIEEEFloatLE();
-		vZ[i] = ctx.mdx->readIEEEFloatLE();
+		vX[i] = mdx.readIEEEFloatLE();
+		vY[i] = mdx.readIEEEFloatLE();
+		vZ[i] = mdx.readIEEEFloatLE();
 
 		for (uint16 t = 0; t < textureCount; t++) {
 			if (offUV[t] != 0xFFFFFFFF) {
-				ctx.mdx->seekTo(offNodeData + i * mdxStructSize + offUV[t]);
+				mdx.seek(offNodeData + i * mdxStructSize + offUV[t]);
 
-				tX[t][i] = ctx.mdx->readIEEEFloatLE();
-				tY[t][i] = ctx.mdx->readIEEEFloatLE();
+				tX[t][i] = mdx.readIEEEFloatLE();
+				tY[t][i] = mdx.readIEEEFloatLE();
 			} else {
 				tX[t][i] = 0.0;
 				tY[t][i] = 0.0;
@@ -570,17 +578,19 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 		return;
 	}
 
-	ctx.mdl->seekTo(ctx.offModelData + offOffVerts);
-	uint32 offVerts = ctx.mdl->readUint32LE();
+	Common::MemoryReader mdl(ctx.mdlData);
+
+	mdl.seek(ctx.offModelData + offOffVerts);
+	uint32 offVerts = mdl.readUint32LE();
 
-	ctx.mdl->seekTo(ctx.offModelData + offVerts);
+	mdl.seek(ctx.offModelData + offVerts);
 
 
 	for (uint32 i = 0; i < facesCount; i++) {
 		// Vertex indices
-		const uint16 v1 = ctx.mdl->readUint16LE();
-		const uint16 v2 = ctx.mdl->readUint16LE();
-		const uint16 v3 = ctx.mdl->readUint16LE();
+		const uint16 v1 = mdl.readUint16LE();
+		const uint16 v2 = mdl.readUint16LE();
+		const uint16 v3 = mdl.readUint16LE();
 
 		// Vertex coordinates
 		_vX[3 * i + 0] = v1 < vX.size() ? vX[v1] : 0.0;
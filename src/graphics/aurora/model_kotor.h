@@ -30,6 +30,8 @@
 #ifndef GRAPHICS_AURORA_NEWMODEL_KOTOR_H
 #define GRAPHICS_AURORA_NEWMODEL_KOTOR_H
 
+#include "common/memreader.h"
+
 #include "graphics/aurora/model.h"
 #include "graphics/aurora/modelnode.h"
 
@@ -56,6 +58,10 @@ private:
 		Common::SeekableReadStream *mdl;
 		Common::SeekableReadStream *mdx;
 
+		/** The MDL's and MDX' data, for fast reading of the bulk geometry. */
+		Common::MemoryReader mdlData;
+		Common::MemoryReader mdxData;
+
 		State *state;
 
 		std::list<ModelNode_KotOR *> nodes;
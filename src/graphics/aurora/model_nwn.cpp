@@ -125,8 +125,11 @@ Model_NWN::ParserContext::ParserContext(const Common::UString &name,
 		tokenize->addSeparator(' ');
 		tokenize->addChunkEnd('\n');
 		tokenize->addIgnore('\r');
-	} else
+	} else {
 		tokenize = 0;
+
+		mdlData = Common::MemoryReader(*mdl);
+	}
 }
 
 Model_NWN::ParserContext::~ParserContext() {
@@ -659,19 +662,22 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 
 	uint32 endPos = ctx.mdl->pos();
 
+	// The geometry is read directly out of memory
+	Common::MemoryReader mdl(ctx.mdlData);
+
 	// Read vertex coordinates
 	std::vector<float> vX, vY, vZ;
 	if (vertexOffset != 0xFFFFFFFF) {
-		ctx.mdl->seekTo(ctx.offRawData + vertexOffset);
+		mdl.seek(ctx.offRawData + vertexOffset);
 
 		vX.resize(vertexCount);
 		vY.resize(vertexCount);
 		vZ.resize(vertexCount);
 
 		for (uint32 i = 0; i < vertexCount; i++) {
-			vX[i] = ctx.mdl->readIEEEFloatLE();
-			vY[i] = ctx.mdl->readIEEEFloatLE();
-			vZ[i] = ctx.mdl->readIEEEFloatLE();
+			vX[i] = mdl.readIEEEFloatLE();
+			vY[i] = mdl.readIEEEFloatLE();
+			vZ[i] = mdl.readIEEEFloatLE();
 		}
 	}
 
@@ -685,11 +691,11 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 
 		bool hasTexture = textureVertexOffset[t] != 0xFFFFFFFF;
 		if (hasTexture)
-			ctx.mdl->seekTo(ctx.offRawData + textureVertexOffset[t]);
+			mdl.seek(ctx.offRawData + textureVertexOffset[t]);
 
 		for (uint32 i = 0; i < vertexCount; i++) {
-			tX[t][i] = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0;
-			tY[t][i] = hasTexture ? ctx.mdl->readIEEEFloatLE() : 0.0;
+			tX[t][i] = hasTexture ? mdl.readIEEEFloatLE() : 0.0;
+			tY[t][i] = hasTexture ? mdl.readIEEEFloatLE() : 0.0;
 		}
 	}
 
@@ -700,17 +706,17 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 		return;
 	}
 
-	ctx.mdl->seekTo(ctx.offModelData + facesOffset);
+	mdl.seek(ctx.offModelData + facesOffset);
 	for (uint32 i = 0; i < facesCount; i++) {
-		ctx.mdl->skip(3 * 4); // Normal
-		ctx.mdl->skip(    4); // Distance
-		ctx.mdl->skip(    4); // ID
-		ctx.mdl->skip(3 * 2); // Adjacent face number
+		mdl.skip(3 * 4); // Normal
+		mdl.skip(    4); // Distance
+		mdl.skip(    4); // ID
+		mdl.skip(3 * 2); // Adjacent face number
 
 		// Vertex indices
-		const uint16 v1 = ctx.mdl->readUint16LE();
-		const uint16 v2 = ctx.mdl->readUint16LE();
-		const uint16 v3 = ctx.mdl->readUint16LE();
+		const uint16 v1 = mdl.readUint16LE();
+		const uint16 v2 = mdl.readUint16LE();
+		const uint16 v3 = mdl.readUint16LE();
 
 		// Vertex coordinates
 		_vX[3 * i + 0] = v1 < vX.size() ? vX[v1] : 0.0;
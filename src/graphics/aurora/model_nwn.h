@@ -30,6 +30,8 @@
 #ifndef GRAPHICS_AURORA_NEWMODEL_NWN_H
 #define GRAPHICS_AURORA_NEWMODEL_NWN_H
 
+#include "common/memreader.h"
+
 #include "graphics/aurora/model.h"
 #include "graphics/aurora/modelnode.h"
 
@@ -56,6 +58,9 @@ private:
 	struct ParserContext {
 		Common::SeekableReadStream *mdl;
 
+		/** The binary MDL's data, for fast reading of the bulk geometry. */
+		Common::MemoryReader mdlData;
+
 		State *state;
 
 		bool isASCII;
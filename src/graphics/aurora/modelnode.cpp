@@ -27,11 +27,15 @@
  *  A node within a 3D model.
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/util.h"
 #include "common/maths.h"
 
 #include "graphics/graphics.h"
 #include "graphics/camera.h"
+#include "graphics/meshbuffer.h"
 
 #include "graphics/images/txi.h"
 
@@ -47,10 +51,23 @@ static bool nodeComp(ModelNode *a, ModelNode *b) {
 	return a->isInFrontOf(*b);
 }
 
+/** Orders vertices within an interleaved vertex array by their contents. */
+struct VertexLess {
+	const float *vertices;
+	uint32 size;
+
+	VertexLess(const float *v, uint32 s) : vertices(v), size(s) {
+	}
+
+	bool operator()(uint32 a, uint32 b) const {
+		return std::memcmp(vertices + a * size, vertices + b * size, size * sizeof(float)) < 0;
+	}
+};
+
 
 ModelNode::ModelNode(Model &model) :
 	_model(&model), _parent(0), _level(0),
-	_faceCount(0), _coords(0), _smoothGroups(0), _material(0), _isTransparent(false),
+	_faceCount(0), _isTransparent(false), _texturesLoading(false),
 	_render(false), _hasTransparencyHint(false) {
 
 	_position[0] = 0.0; _position[1] = 0.0; _position[2] = 0.0;
@@ -63,9 +80,6 @@ ModelNode::ModelNode(Model &model) :
 }
 
 ModelNode::~ModelNode() {
-	delete[] _material;
-	delete[] _smoothGroups;
-	delete[] _coords;
 }
 
 ModelNode *ModelNode::getParent() {
@@ -145,8 +159,6 @@ void ModelNode::setPosition(float x, float y, float z) {
 	if (_parent)
 		_parent->orderChildren();
 
-	_model->needRebuild();
-
 	GfxMan.unlockFrame();
 }
 
@@ -157,8 +169,6 @@ void ModelNode::setRotation(float x, float y, float z) {
 	_rotation[1] = y;
 	_rotation[2] = z;
 
-	_model->needRebuild();
-
 	GfxMan.unlockFrame();
 }
 
@@ -192,14 +202,18 @@ void ModelNode::inheritGeometry(ModelNode &node) const {
 	node._render        = _render;
 	node._isTransparent = _isTransparent;
 
+	node._texturesLoading     = _texturesLoading;
+	node._hasTransparencyHint = _hasTransparencyHint;
+	node._transparencyHint    = _transparencyHint;
+
 	if (!node.createFaces(_faceCount))
 		return;
 
-	memcpy(node._coords, _coords,
+	memcpy(node._coords.get(), _coords.get(),
 			(3 * 3 * _faceCount + 2 * 3 * _faceCount * _textures.size()) * sizeof(float));
 
-	memcpy(node._smoothGroups, _smoothGroups, _faceCount * sizeof(uint32));
-	memcpy(node._material    , _material    , _faceCount * sizeof(uint32));
+	memcpy(node._smoothGroups.get(), _smoothGroups.get(), _faceCount * sizeof(uint32));
+	memcpy(node._material.get()    , _material.get()    , _faceCount * sizeof(uint32));
 
 	node.createBound();
 }
@@ -270,7 +284,6 @@ void ModelNode::addChild(Model *model) {
 
 void ModelNode::setInvisible(bool invisible) {
 	_render = !invisible;
-	_model->needRebuild();
 }
 
 void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
@@ -278,24 +291,14 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 
 	_textures.resize(textures.size());
 
-	bool hasAlpha = true;
-	bool isDecal  = true;
-
 	for (uint t = 0; t != textures.size(); t++) {
 
 		try {
 
 			if (!textures[t].empty() && (textures[t] != "NULL")) {
-				_textures[t] = TextureMan.get(textures[t]);
+				// Stream the textures in, we don't need to wait for them
+				_textures[t] = TextureMan.get(textures[t], true);
 				hasTexture = true;
-
-				if (!_textures[t].getTexture().hasAlpha())
-					hasAlpha = false;
-				if (_textures[t].getTexture().getTXI().getFeatures().alphaMean == 1.0)
-					hasAlpha = false;
-
-				if (!_textures[t].getTexture().getTXI().getFeatures().decal)
-					isDecal = false;
 			}
 
 		} catch (...) {
@@ -304,6 +307,40 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 
 	}
 
+	_texturesLoading = true;
+	updateTransparency();
+
+	// If the node has no actual texture, we just assume
+	// that the geometry shouldn't be rendered.
+	if (!hasTexture)
+		_render = false;
+}
+
+void ModelNode::updateTransparency() {
+	bool hasAlpha = true;
+	bool isDecal  = true;
+
+	_texturesLoading = false;
+
+	for (std::vector<TextureHandle>::const_iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		if (t->empty())
+			continue;
+
+		const Texture &texture = t->getTexture();
+
+		// Only the image tells us about alpha. Until then, assume there's none
+		if (texture.isLoading())
+			_texturesLoading = true;
+
+		if (!texture.hasAlpha())
+			hasAlpha = false;
+		if (texture.getTXI().getFeatures().alphaMean == 1.0)
+			hasAlpha = false;
+
+		if (!texture.getTXI().getFeatures().decal)
+			isDecal = false;
+	}
+
 	if (_hasTransparencyHint) {
 		_isTransparent = _transparencyHint;
 		if (isDecal)
@@ -311,11 +348,6 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 	} else {
 		_isTransparent = hasAlpha;
 	}
-
-	// If the node has no actual texture, we just assume
-	// that the geometry shouldn't be rendered.
-	if (!hasTexture)
-		_render = false;
 }
 
 bool ModelNode::createFaces(uint32 count) {
@@ -328,17 +360,17 @@ bool ModelNode::createFaces(uint32 count) {
 
 	_faceCount = count;
 
-	_coords = new float[3 * 3 * _faceCount + 2 * 3 * _faceCount * textureCount];
+	_coords.reset(new float[3 * 3 * _faceCount + 2 * 3 * _faceCount * textureCount]);
 
-	_vX = _coords + 0 * 3 * _faceCount;
-	_vY = _coords + 1 * 3 * _faceCount;
-	_vZ = _coords + 2 * 3 * _faceCount;
+	_vX = _coords.get() + 0 * 3 * _faceCount;
+	_vY = _coords.get() + 1 * 3 * _faceCount;
+	_vZ = _coords.get() + 2 * 3 * _faceCount;
 
-	_tX = _coords + 3 * 3 * _faceCount + 0 * 3 * _faceCount * textureCount;
-	_tY = _coords + 3 * 3 * _faceCount + 1 * 3 * _faceCount * textureCount;
+	_tX = _coords.get() + 3 * 3 * _faceCount + 0 * 3 * _faceCount * textureCount;
+	_tY = _coords.get() + 3 * 3 * _faceCount + 1 * 3 * _faceCount * textureCount;
 
-	_smoothGroups = new uint32[_faceCount];
-	_material     = new uint32[_faceCount];
+	_smoothGroups.reset(new uint32[_faceCount]);
+	_material.reset(new uint32[_faceCount]);
 
 	return true;
 }
@@ -362,6 +394,71 @@ void ModelNode::createCenter() {
 	_center[2] = minZ + ((maxZ - minZ) / 2.0);
 }
 
+void ModelNode::createMesh() {
+	if (_mesh || (_faceCount == 0))
+		return;
+
+	const uint32 textureCount = _textures.size();
+	const uint32 vertexSize   = 3 + 2 * textureCount;
+	const uint32 vertexCount  = 3 * _faceCount;
+
+	// Interleave the per-face vertex data
+
+	std::vector<float> vertices(vertexCount * vertexSize);
+
+	float *v = &vertices[0];
+	for (uint32 f = 0; f < _faceCount; f++) {
+		const float *tX = _tX + 3 * textureCount * f;
+		const float *tY = _tY + 3 * textureCount * f;
+
+		for (uint32 i = 0; i < 3; i++) {
+			*v++ = _vX[3 * f + i];
+			*v++ = _vY[3 * f + i];
+			*v++ = _vZ[3 * f + i];
+
+			for (uint32 t = 0; t < textureCount; t++) {
+				*v++ = tX[3 * t + i];
+				*v++ = tY[3 * t + i];
+			}
+		}
+	}
+
+	// Merge identical vertices, indexing them from the faces
+
+	std::vector<uint32> order(vertexCount);
+	for (uint32 i = 0; i < vertexCount; i++)
+		order[i] = i;
+
+	std::sort(order.begin(), order.end(), VertexLess(&vertices[0], vertexSize));
+
+	std::vector<float>  unique;
+	std::vector<uint32> indices(vertexCount);
+
+	unique.reserve(vertices.size());
+
+	const float *last = 0;
+	for (std::vector<uint32>::const_iterator i = order.begin(); i != order.end(); ++i) {
+		const float *vertex = &vertices[*i * vertexSize];
+
+		if (!last || std::memcmp(last, vertex, vertexSize * sizeof(float)))
+			unique.insert(unique.end(), vertex, vertex + vertexSize);
+
+		last = vertex;
+
+		indices[*i] = (unique.size() / vertexSize) - 1;
+	}
+
+	_mesh.reset(new MeshBuffer);
+	_mesh->set(unique, indices, textureCount);
+
+	// The bounding boxes are built already, so the faces aren't needed anymore
+	_coords.reset();
+	_smoothGroups.reset();
+	_material.reset();
+
+	_vX = _vY = _vZ = _tX = _tY = 0;
+}
+
 const Common::BoundingBox &ModelNode::getAbsoluteBound() const {
 	return _absoluteBoundBox;
 }
@@ -403,59 +500,14 @@ void ModelNode::orderChildren() {
 }
 
 void ModelNode::renderGeometry() {
-	// Enable all needed texture units
-	for (uint32 t = 0; t < _textures.size(); t++) {
-		TextureMan.activeTexture(t);
-		glEnable(GL_TEXTURE_2D);
-
-		TextureMan.set(_textures[t]);
-	}
-
-
-	// Render the node's faces
-
-	const uint32 textureCount = _textures.size();
-	const float *vX = _vX;
-	const float *vY = _vY;
-	const float *vZ = _vZ;
-	const float *tX = _tX;
-	const float *tY = _tY;
-
-	glBegin(GL_TRIANGLES);
-	for (uint32 f = 0; f < _faceCount; f++, vX += 3, vY += 3, vZ += 3,
-	                                   tX += 3 * textureCount, tY += 3 * textureCount) {
-
-		// Texture vertex A
-		for (uint32 t = 0; t < textureCount; t++)
-			TextureMan.textureCoord2f(t, tX[3 * t + 0], tY[3 * t + 0]);
-
-		// Geometry vertex A
-		glVertex3f(vX[0], vY[0], vZ[0]);
-
-
-		// Texture vertex B
-		for (uint32 t = 0; t < textureCount; t++)
-			TextureMan.textureCoord2f(t, tX[3 * t + 1], tY[3 * t + 1]);
-
-		// Geometry vertex B
-		glVertex3f(vX[1], vY[1], vZ[1]);
-
-
-		// Texture vertex C
-		for (uint32 t = 0; t < textureCount; t++)
-			TextureMan.textureCoord2f(t, tX[3 * t + 2], tY[3 * t + 2]);
-
-		// Geometry vertex C
-		glVertex3f(vX[2], vY[2], vZ[2]);
-	}
-	glEnd();
+	if (!_mesh)
+		return;
 
+	_textureIDs.resize(_textures.size());
+	for (uint32 t = 0; t < _textures.size(); t++)
+		_textureIDs[t] = TextureMan.getID(_textures[t]);
 
-	// Disable the texture units again
-	for (uint32 i = 0; i < _textures.size(); i++) {
-		TextureMan.activeTexture(i);
-		glDisable(GL_TEXTURE_2D);
-	}
+	_mesh->draw(_textureIDs);
 }
 
 void ModelNode::render(RenderPass pass) {
@@ -471,6 +523,10 @@ void ModelNode::render(RenderPass pass) {
 
 	// Render the node's geometry
 
+	// Our textures are now there, so we know whether they're transparent
+	if (_texturesLoading)
+		updateTransparency();
+
 	bool shouldRender = _render && (_faceCount > 0);
 	if (((pass == kRenderPassOpaque)      &&  _isTransparent) ||
 			((pass == kRenderPassTransparent) && !_isTransparent))
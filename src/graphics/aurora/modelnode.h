@@ -33,6 +33,9 @@
 #include <list>
 #include <vector>
 
+#include "boost/shared_array.hpp"
+#include "boost/shared_ptr.hpp"
+
 #include "common/ustring.h"
 #include "common/transmatrix.h"
 #include "common/boundingbox.h"
@@ -44,6 +47,8 @@
 
 namespace Graphics {
 
+class MeshBuffer;
+
 namespace Aurora {
 
 class Model;
@@ -101,7 +106,8 @@ protected:
 
 	uint32 _faceCount; ///< Number of faces
 
-	float *_coords; ///< Coordinates pool.
+	/** Coordinates pool, until packed into the mesh. Shared between all instances of the model. */
+	boost::shared_array<float> _coords;
 
 	// Vertex coordinates
 	float *_vX; ///< Vertex coordinates, X.
@@ -112,8 +118,11 @@ protected:
 	float *_tX; ///< Texture cordinates, X.
 	float *_tY; ///< Texture cordinates, Y.
 
-	uint32 *_smoothGroups; ///< Face smooth groups.
-	uint32 *_material;     ///< Face materials.
+	boost::shared_array<uint32> _smoothGroups; ///< Face smooth groups.
+	boost::shared_array<uint32> _material;     ///< Face materials.
+
+	/** The faces packed into vertex and index buffers, ready for drawing. */
+	boost::shared_ptr<MeshBuffer> _mesh;
 
 	float _center     [3]; ///< The node's center.
 	float _position   [3]; ///< Position of the node.
@@ -131,8 +140,10 @@ protected:
 	float _shininess;    ///< Shiny?
 
 	std::vector<TextureHandle> _textures; ///< Textures.
+	std::vector<TextureID>   _textureIDs; ///< The IDs the textures are drawn with.
 
 	bool _isTransparent;
+	bool _texturesLoading; ///< Are any of the textures still being streamed in?
 
 	bool _dangly; ///< Is the node mesh's dangly?
 
@@ -170,6 +181,7 @@ protected:
 	bool createFaces(uint32 count);
 	void createBound();
 	void createCenter();
+	void createMesh();
 
 	void render(RenderPass pass);
 
@@ -180,6 +192,9 @@ private:
 
 	void orderChildren();
 
+	/** Figure out whether the node is transparent, from its textures. */
+	void updateTransparency();
+
 	void renderGeometry();
 
 
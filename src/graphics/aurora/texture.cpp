@@ -31,10 +31,13 @@
 #include "common/util.h"
 #include "common/error.h"
 #include "common/stream.h"
+#include "common/threadpool.h"
 
 #include "graphics/aurora/texture.h"
+#include "graphics/aurora/textureman.h"
 
 #include "graphics/graphics.h"
+#include "graphics/queueman.h"
 #include "graphics/images/txi.h"
 #include "graphics/images/decoder.h"
 #include "graphics/images/tga.h"
@@ -42,6 +45,7 @@
 #include "graphics/images/tpc.h"
 #include "graphics/images/txb.h"
 #include "graphics/images/sbm.h"
+#include "graphics/images/surface.h"
 
 #include "events/requests.h"
 
@@ -53,11 +57,123 @@ namespace Graphics {
 
 namespace Aurora {
 
-Texture::Texture(const Common::UString &name) : _textureID(0),
+/** Decode an image resource of this type. */
+static ImageDecoder *createImage(::Aurora::FileType type, Common::SeekableReadStream &img) {
+	if (type == ::Aurora::kFileTypeTGA)
+		return new TGA(img);
+	if (type == ::Aurora::kFileTypeDDS)
+		return new DDS(img);
+	if (type == ::Aurora::kFileTypeTPC)
+		return new TPC(img);
+	if (type == ::Aurora::kFileTypeTXB)
+		return new TXB(img);
+	if (type == ::Aurora::kFileTypeSBM)
+		return new SBM(img);
+
+	throw Common::Exception("Unsupported image resource type %d", (int) type);
+}
+
+
+/** The shared state between a streamed texture and its decoding job. */
+struct Texture::StreamState {
+	Common::UString name;
+	::Aurora::FileType type;
+
+	Common::SeekableReadStream *data; ///< The still encoded image.
+	ImageDecoder *image;              ///< The decoded image, not yet taken over.
+
+	bool decoded; ///< Has the decoding finished?
+
+	/** The texture waiting for the image, or 0 if it's not interested anymore. */
+	Texture *texture;
+
+	Common::Mutex mutex;
+	Common::Semaphore done; ///< Posted once the decoding finished.
+
+	StreamState(const Common::UString &n, ::Aurora::FileType t,
+	            Common::SeekableReadStream *d, Texture *tex) :
+		name(n), type(t), data(d), image(0), decoded(false), texture(tex), done(0) {
+	}
+
+	~StreamState() {
+		delete data;
+		delete image;
+	}
+};
+
+/** Decoding a streamed texture's image in one of the texture manager's threads. */
+class Texture::DecodeJob : public Common::ThreadPool::Job {
+public:
+	DecodeJob(const boost::shared_ptr<StreamState> &state) : _state(state) {
+	}
+
+	void run() {
+		ImageDecoder *image = 0;
+
+		try {
+			image = createImage(_state->type, *_state->data);
+
+			if (image->getMipMapCount() < 1)
+				throw Common::Exception("Texture has no images");
+
+			if (GfxMan.needManualDeS3TC())
+				image->decompress();
+
+		} catch (Common::Exception &e) {
+			delete image;
+			image = 0;
+
+			e.add("Failed decoding texture \"%s\"", _state->name.c_str());
+			Common::printException(e, "WARNING: ");
+		} catch (...) {
+			delete image;
+			image = 0;
+		}
+
+		if (!image) {
+			// Nobody's there to catch the error anymore, so stay plain white instead
+			Surface *surface = new Surface(1, 1);
+			surface->fill(0xFF, 0xFF, 0xFF, 0xFF);
+
+			image = surface;
+		}
+
+		// Lock the queue first, to keep the same locking order as the upload
+		QueueMan.lockQueue(kQueueStreamedTexture);
+		_state->mutex.lock();
+
+		delete _state->data;
+		_state->data = 0;
+
+		_state->image   = image;
+		_state->decoded = true;
+
+		if (_state->texture)
+			_state->texture->addToQueue(kQueueStreamedTexture);
+
+		_state->mutex.unlock();
+		QueueMan.unlockQueue(kQueueStreamedTexture);
+
+		_state->done.unlock();
+	}
+
+private:
+	boost::shared_ptr<StreamState> _state;
+};
+
+
+Texture::Texture(const Common::UString &name, bool streamed) : _textureID(0),
 	_type(::Aurora::kFileTypeNone), _image(0), _txi(0), _width(0), _height(0) {
 
 	_txi = new TXI();
 
+	if (streamed) {
+		loadStreamed(name);
+
+		addToQueue(kQueueTexture);
+		return;
+	}
+
 	load(name);
 
 	addToQueue(kQueueTexture);
@@ -79,6 +195,8 @@ Texture::Texture(ImageDecoder *image, const TXI *txi) : _textureID(0),
 }
 
 Texture::~Texture() {
+	cancelStream();
+
 	removeFromQueue(kQueueNewTexture);
 	removeFromQueue(kQueueTexture);
 
@@ -94,18 +212,61 @@ TextureID Texture::getID() const {
 }
 
 const uint32 Texture::getWidth() const {
+	Common::StackLock lock(_mutex);
+
+	const ImageDecoder *image = getImage();
+	if (image && !_image)
+		return image->getMipMap(0).width;
+
 	return _width;
 }
 
 const uint32 Texture::getHeight() const {
+	Common::StackLock lock(_mutex);
+
+	const ImageDecoder *image = getImage();
+	if (image && !_image)
+		return image->getMipMap(0).height;
+
 	return _height;
 }
 
 bool Texture::hasAlpha() const {
-	if (!_image)
+	Common::StackLock lock(_mutex);
+
+	const ImageDecoder *image = getImage();
+	if (!image)
 		return false;
 
-	return _image->hasAlpha();
+	return image->hasAlpha();
+}
+
+bool Texture::isLoading() const {
+	Common::StackLock lock(_mutex);
+
+	return _stream.get() != 0;
+}
+
+void Texture::waitDecoded() const {
+	_mutex.lock();
+	boost::shared_ptr<StreamState> stream = _stream;
+	_mutex.unlock();
+
+	if (!stream)
+		return;
+
+	// Pass the signal on, for whoever else might be waiting
+	stream->done.lock();
+	stream->done.unlock();
+}
+
+const ImageDecoder *Texture::getImage() const {
+	if (_image || !_stream)
+		return _image;
+
+	Common::StackLock lock(_stream->mutex);
+
+	return _stream->image;
 }
 
 void Texture::load(const Common::UString &name) {
@@ -116,19 +277,11 @@ void Texture::load(const Common::UString &name) {
 	_name = name;
 
 	// Loading the different image formats
-	if      (_type == ::Aurora::kFileTypeTGA)
-		_image = new TGA(*img);
-	else if (_type == ::Aurora::kFileTypeDDS)
-		_image = new DDS(*img);
-	else if (_type == ::Aurora::kFileTypeTPC)
-		_image = new TPC(*img);
-	else if (_type == ::Aurora::kFileTypeTXB)
-		_image = new TXB(*img);
-	else if (_type == ::Aurora::kFileTypeSBM)
-		_image = new SBM(*img);
-	else {
+	try {
+		_image = createImage(_type, *img);
+	} catch (...) {
 		delete img;
-		throw Common::Exception("Unsupported image resource type %d", (int) _type);
+		throw;
 	}
 
 	delete img;
@@ -143,6 +296,81 @@ void Texture::load(ImageDecoder *image) {
 	loadImage();
 }
 
+void Texture::loadStreamed(const Common::UString &name) {
+	// Find the resource right here, only the decoding happens in the background
+	Common::SeekableReadStream *img = ResMan.getResource(::Aurora::kResourceImage, name, &_type);
+	if (!img)
+		throw Common::Exception("No such image resource \"%s\"", name.c_str());
+
+	_name = name;
+
+	loadTXI(ResMan.getResource(name, ::Aurora::kFileTypeTXI));
+
+	_stream.reset(new StreamState(name, _type, img, this));
+
+	TextureMan.decode(new DecodeJob(_stream));
+}
+
+bool Texture::finishStream() {
+	if (!_stream)
+		return true;
+
+	ImageDecoder *image = 0;
+
+	_stream->mutex.lock();
+
+	if (_stream->decoded) {
+		image = _stream->image;
+		_stream->image = 0;
+	}
+
+	_stream->mutex.unlock();
+
+	if (!image)
+		return false;
+
+	cancelStream();
+
+	delete _image;
+	_image = image;
+
+	// Already checked and decompressed in the background
+	_width  = _image->getMipMap(0).width;
+	_height = _image->getMipMap(0).height;
+
+	// If we've still got no TXI, look if the image provides TXI data
+	Common::SeekableReadStream *txi = _image->getTXI();
+	if (txi) {
+		try {
+			// Keep the TXI object itself, references to it might still be around
+			*_txi = TXI(*txi);
+		} catch (Common::Exception &e) {
+			e.add("Failed loading TXI");
+			Common::printException(e);
+		}
+
+		delete txi;
+	}
+
+	return true;
+}
+
+void Texture::cancelStream() {
+	_mutex.lock();
+	boost::shared_ptr<StreamState> stream = _stream;
+	_stream.reset();
+	_mutex.unlock();
+
+	if (!stream)
+		return;
+
+	stream->mutex.lock();
+	stream->texture = 0;
+	stream->mutex.unlock();
+
+	removeFromQueue(kQueueStreamedTexture);
+}
+
 void Texture::loadTXI(Common::SeekableReadStream *stream) {
 	if (!stream)
 		return;
@@ -193,6 +421,12 @@ void Texture::doDestroy() {
 }
 
 void Texture::doRebuild() {
+	Common::StackLock lock(_mutex);
+
+	if (!finishStream())
+		// Still decoding, keep the placeholder for now
+		return;
+
 	if (!_image)
 		// No image
 		return;
@@ -264,17 +498,23 @@ const TXI &Texture::getTXI() const {
 }
 
 bool Texture::reload(ImageDecoder *image, const TXI *txi) {
+	cancelStream();
+
 	removeFromQueue(kQueueNewTexture);
 	removeFromQueue(kQueueTexture);
 
-	if (txi) {
-		delete _txi;
-		_txi = new TXI(*txi);
-	}
+	{
+		Common::StackLock lock(_mutex);
 
-	delete _image;
+		if (txi) {
+			delete _txi;
+			_txi = new TXI(*txi);
+		}
 
-	load(image);
+		delete _image;
+
+		load(image);
+	}
 
 	addToQueue(kQueueTexture);
 	addToQueue(kQueueNewTexture);
@@ -290,15 +530,22 @@ bool Texture::reload(const Common::UString &name) {
 		// Yeah, we don't know the resource name, so we can't reload the texture
 		return false;
 
+	cancelStream();
+
 	removeFromQueue(kQueueNewTexture);
 	removeFromQueue(kQueueTexture);
 
-	delete _txi;
-	delete _image;
+	{
+		Common::StackLock lock(_mutex);
 
-	_txi = new TXI();
+		delete _txi;
+		delete _image;
 
-	load(_name);
+		_image = 0;
+		_txi   = new TXI();
+
+		load(_name);
+	}
 
 	addToQueue(kQueueTexture);
 	addToQueue(kQueueNewTexture);
@@ -307,10 +554,13 @@ bool Texture::reload(const Common::UString &name) {
 }
 
 bool Texture::dumpTGA(const Common::UString &fileName) const {
-	if (!_image)
+	Common::StackLock lock(_mutex);
+
+	const ImageDecoder *image = getImage();
+	if (!image)
 		return false;
 
-	return _image->dumpTGA(fileName);
+	return image->dumpTGA(fileName);
 }
 
 } // End of namespace Aurora
@@ -30,7 +30,10 @@
 #ifndef GRAPHICS_AURORA_TEXTURE_H
 #define GRAPHICS_AURORA_TEXTURE_H
 
+#include "boost/shared_ptr.hpp"
+
 #include "common/ustring.h"
+#include "common/mutex.h"
 
 #include "graphics/types.h"
 #include "graphics/texture.h"
@@ -51,8 +54,13 @@ namespace Aurora {
 /** A texture. */
 class Texture : public Graphics::Texture {
 public:
-	/** Create a texture from this image resource. */
-	Texture(const Common::UString &name);
+	/** Create a texture from this image resource.
+	 *
+	 *  A streamed texture decodes its image in the background. Until it has
+	 *  been uploaded, it has no size and no alpha, and only the TXI found
+	 *  next to the image.
+	 */
+	Texture(const Common::UString &name, bool streamed = false);
 	/** Take over the image and create a texture from it. */
 	Texture(ImageDecoder *image, const TXI *txi = 0);
 	~Texture();
@@ -62,6 +70,11 @@ public:
 
 	bool hasAlpha() const;
 
+	/** Is the texture still waiting for its image to be decoded and uploaded? */
+	bool isLoading() const;
+	/** Wait until the background decoding of a streamed texture has finished. */
+	void waitDecoded() const;
+
 	/** Return the TXI. */
 	const TXI &getTXI() const;
 
@@ -79,6 +92,9 @@ protected:
 	void doDestroy();
 
 private:
+	struct StreamState;
+	class DecodeJob;
+
 	Common::UString _name;
 
 	TextureID _textureID; ///< OpenGL texture ID.
@@ -91,8 +107,23 @@ private:
 	uint32 _width;
 	uint32 _height;
 
+	/** The background decoding of a streamed texture, until it has been uploaded. */
+	boost::shared_ptr<StreamState> _stream;
+
+	/** Protects the image against being swapped in while it's looked at. */
+	mutable Common::Mutex _mutex;
+
 	void load(const Common::UString &name);
 	void load(ImageDecoder *image);
+	void loadStreamed(const Common::UString &name);
+
+	/** Take over the decoded image of a streamed texture, if it's ready. */
+	bool finishStream();
+	/** Forget about the background decoding. */
+	void cancelStream();
+
+	/** Return the image, or the streamed image that's not yet taken over. */
+	const ImageDecoder *getImage() const;
 
 	void loadTXI(Common::SeekableReadStream *stream);
 	void loadImage();
@@ -37,19 +37,24 @@
 #include "graphics/aurora/texture.h"
 #include "graphics/aurora/pltfile.h"
 
+#include "graphics/images/surface.h"
+
 #include "graphics/graphics.h"
 
 #include "events/requests.h"
 
 DECLARE_SINGLETON(Graphics::Aurora::TextureManager)
 
+/** Number of threads decoding streamed textures. */
+static const uint kDecodeThreadCount = 2;
+
 namespace Graphics {
 
 namespace Aurora {
 
-ManagedTexture::ManagedTexture(const Common::UString &name) : reloadable(false) {
+ManagedTexture::ManagedTexture(const Common::UString &name, bool streamed) : reloadable(false) {
 	referenceCount = 0;
-	texture = new Texture(name);
+	texture = new Texture(name, streamed);
 }
 
 ManagedTexture::ManagedTexture(const Common::UString &name, Texture *t) : reloadable(false) {
@@ -154,11 +159,14 @@ PLTFile &PLTHandle::getPLT() const {
 }
 
 
-TextureManager::TextureManager() {
+TextureManager::TextureManager() : _decoder(0), _placeholder(0) {
 }
 
 TextureManager::~TextureManager() {
 	clear();
+
+	delete _placeholder;
+	delete _decoder;
 }
 
 void TextureManager::clear() {
@@ -202,7 +210,7 @@ TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 	return TextureHandle(text);
 }
 
-TextureHandle TextureManager::get(const Common::UString &name) {
+TextureHandle TextureManager::get(const Common::UString &name, bool streamed) {
 	Common::StackLock lock(_mutex);
 
 	if (ResMan.hasResource(name, ::Aurora::kFileTypePLT)) {
@@ -217,14 +225,17 @@ TextureHandle TextureManager::get(const Common::UString &name) {
 	if (texture == _textures.end()) {
 		std::pair<TextureMap::iterator, bool> result;
 
-		ManagedTexture *t = new ManagedTexture(name);
+		ManagedTexture *t = new ManagedTexture(name, streamed);
 
 		result = _textures.insert(std::make_pair(name, t));
 
 		texture = result.first;
 
 		texture->second->reloadable = true;
-	}
+
+	} else if (!streamed)
+		// The caller wants to look at the image, so it has to be decoded by now
+		texture->second->texture->waitDecoded();
 
 	return TextureHandle(texture);
 }
@@ -308,6 +319,10 @@ void TextureManager::clearNewPLTs() {
 	_newPLTs.clear();
 }
 
+uint32 TextureManager::getNewPLTCount() const {
+	return _newPLTs.size();
+}
+
 void TextureManager::reset() {
 	activeTexture(0);
 	glEnable(GL_TEXTURE_2D);
@@ -319,16 +334,39 @@ void TextureManager::set() {
 }
 
 void TextureManager::set(const TextureHandle &handle) {
-	if (handle.empty()) {
-		set();
-		return;
+	glBindTexture(GL_TEXTURE_2D, getID(handle));
+}
+
+TextureID TextureManager::getID(const TextureHandle &handle) {
+	if (handle.empty())
+		return 0;
+
+	const Texture &texture = *handle._it->second->texture;
+
+	TextureID id = texture.getID();
+	if (id == 0) {
+		if (!texture.isLoading())
+			warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
+
+		// Bind a placeholder until the texture has been streamed in
+		id = getPlaceholderID();
 	}
 
-	TextureID id = handle._it->second->texture->getID();
-	if (id == 0)
-		warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
+	return id;
+}
+
+TextureID TextureManager::getPlaceholderID() {
+	Common::StackLock lock(_mutex);
+
+	// Created once, and kept until the manager goes away
+	if (!_placeholder) {
+		Surface *surface = new Surface(1, 1);
+		surface->fill(0xFF, 0xFF, 0xFF, 0xFF);
+
+		_placeholder = new Texture(surface);
+	}
 
-	glBindTexture(GL_TEXTURE_2D, id);
+	return _placeholder->getID();
 }
 
 static GLenum texture[32] = {
@@ -366,6 +404,15 @@ static GLenum texture[32] = {
 	GL_TEXTURE31_ARB
 };
 
+void TextureManager::decode(Common::ThreadPool::Job *job) {
+	Common::StackLock lock(_mutex);
+
+	if (!_decoder)
+		_decoder = new Common::ThreadPool(kDecodeThreadCount);
+
+	_decoder->add(job);
+}
+
 void TextureManager::activeTexture(uint32 n) {
 	if (n >= ARRAYSIZE(texture))
 		return;
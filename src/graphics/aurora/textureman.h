@@ -39,6 +39,7 @@
 #include "common/singleton.h"
 #include "common/mutex.h"
 #include "common/ustring.h"
+#include "common/threadpool.h"
 
 namespace Graphics {
 
@@ -54,7 +55,7 @@ struct ManagedTexture {
 
 	bool reloadable;
 
-	ManagedTexture(const Common::UString &name);
+	ManagedTexture(const Common::UString &name, bool streamed = false);
 	ManagedTexture(const Common::UString &name, Texture *t);
 	~ManagedTexture();
 };
@@ -128,7 +129,14 @@ public:
 
 
 	TextureHandle add(Texture *texture, Common::UString name = "");
-	TextureHandle get(const Common::UString &name);
+
+	/** Return a handle to this texture, loading it if necessary.
+	 *
+	 *  A streamed texture is returned right away and decoded in the
+	 *  background. Until it's ready, a plain placeholder is bound in
+	 *  its stead.
+	 */
+	TextureHandle get(const Common::UString &name, bool streamed = false);
 
 
 	void reloadAll();
@@ -136,23 +144,37 @@ public:
 
 	void getNewPLTs(std::list<PLTHandle> &plts);
 	void clearNewPLTs();
+	/** Return the number of PLTs created since the last clearNewPLTs(). */
+	uint32 getNewPLTCount() const;
 
 
 	void reset();
 	void set();
 	void set(const TextureHandle &handle);
 
+	/** Return the ID to bind for this texture, a placeholder while it's still streamed in. */
+	TextureID getID(const TextureHandle &handle);
+
 
 	void activeTexture(uint32 n);
 	void textureCoord2f(uint32 n, float u, float v);
 
 
+	/** Decode a streamed texture's image in the background, taking over the job. */
+	void decode(Common::ThreadPool::Job *job);
+
+
 private:
 	TextureMap _textures;
 	PLTList    _plts;
 
 	std::list<PLTHandle> _newPLTs;
 
+	Common::ThreadPool *_decoder; ///< The threads decoding streamed textures.
+
+	/** Bound in place of textures that are still loading. */
+	Texture *_placeholder;
+
 	Common::Mutex _mutex;
 
 	void release(TextureMap::iterator &i);
@@ -163,6 +185,9 @@ private:
 	void release(TextureHandle &texture);
 	void release(PLTHandle &plt);
 
+	/** Return the ID of the placeholder texture, creating it if necessary. */
+	TextureID getPlaceholderID();
+
 	friend class PLTHandle;
 	friend class TextureHandle;
 };
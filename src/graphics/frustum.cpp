@@ -0,0 +1,110 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file graphics/frustum.cpp
+ *  A view frustum.
+ */
+
+#include <cmath>
+
+#include "common/matrix.h"
+#include "common/boundingbox.h"
+
+#include "graphics/frustum.h"
+
+namespace Graphics {
+
+Frustum::Frustum() {
+	// Without a matrix, everything is within the frustum
+	for (int i = 0; i < 6; i++) {
+		_planes[i][0] = 0.0;
+		_planes[i][1] = 0.0;
+		_planes[i][2] = 0.0;
+		_planes[i][3] = 1.0;
+	}
+}
+
+Frustum::~Frustum() {
+}
+
+void Frustum::set(const Common::Matrix &clip) {
+	// Extract the planes out of the clip matrix, see Gribb and Hartmann,
+	// "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+
+	setPlane(0, clip, 0,  1.0); // Left
+	setPlane(1, clip, 0, -1.0); // Right
+	setPlane(2, clip, 1,  1.0); // Bottom
+	setPlane(3, clip, 1, -1.0); // Top
+	setPlane(4, clip, 2,  1.0); // Near
+	setPlane(5, clip, 2, -1.0); // Far
+}
+
+void Frustum::setPlane(int n, const Common::Matrix &clip, int row, float sign) {
+	float *plane = _planes[n];
+
+	for (int i = 0; i < 4; i++)
+		plane[i] = clip(3, i) + sign * clip(row, i);
+
+	const float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+	if (length == 0.0)
+		return;
+
+	for (int i = 0; i < 4; i++)
+		plane[i] /= length;
+}
+
+bool Frustum::isIn(float x, float y, float z) const {
+	for (int i = 0; i < 6; i++)
+		if ((_planes[i][0] * x + _planes[i][1] * y + _planes[i][2] * z + _planes[i][3]) < 0.0)
+			return false;
+
+	return true;
+}
+
+bool Frustum::isIn(const Common::BoundingBox &box) const {
+	if (box.isEmpty())
+		return true;
+
+	float min[3], max[3];
+	box.getMin(min[0], min[1], min[2]);
+	box.getMax(max[0], max[1], max[2]);
+
+	for (int i = 0; i < 6; i++) {
+		const float *plane = _planes[i];
+
+		// The corner furthest along the plane normal
+		const float x = (plane[0] >= 0.0) ? max[0] : min[0];
+		const float y = (plane[1] >= 0.0) ? max[1] : min[1];
+		const float z = (plane[2] >= 0.0) ? max[2] : min[2];
+
+		// If even that one is outside, the whole box is
+		if ((plane[0] * x + plane[1] * y + plane[2] * z + plane[3]) < 0.0)
+			return false;
+	}
+
+	return true;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,64 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file graphics/frustum.h
+ *  A view frustum.
+ */
+
+#ifndef GRAPHICS_FRUSTUM_H
+#define GRAPHICS_FRUSTUM_H
+
+namespace Common {
+	class Matrix;
+	class BoundingBox;
+}
+
+namespace Graphics {
+
+/** A view frustum, the part of the world visible through the camera. */
+class Frustum {
+public:
+	Frustum();
+	~Frustum();
+
+	/** Derive the frustum from a combined projection and modelview matrix. */
+	void set(const Common::Matrix &clip);
+
+	/** Is that point within the frustum? */
+	bool isIn(float x, float y, float z) const;
+
+	/** Is that absolute, axis-aligned bounding box at least partially within the frustum? */
+	bool isIn(const Common::BoundingBox &box) const;
+
+private:
+	/** The six clipping planes, as a * x + b * y + c * z + d >= 0. */
+	float _planes[6][4];
+
+	void setPlane(int n, const Common::Matrix &clip, int row, float sign);
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_FRUSTUM_H
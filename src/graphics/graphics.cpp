@@ -54,6 +54,9 @@
 
 DECLARE_SINGLETON(Graphics::GraphicsManager)
 
+/** How many background-decoded textures may be uploaded each frame. */
+static const uint32 kStreamedTexturesPerFrame = 4;
+
 namespace Graphics {
 
 GraphicsManager::GraphicsManager() : _projection(4, 4), _projectionInv(4, 4) {
@@ -61,6 +64,8 @@ GraphicsManager::GraphicsManager() : _projection(4, 4), _projectionInv(4, 4) {
 
 	_needManualDeS3TC        = false;
 	_supportMultipleTextures = false;
+	_supportVertexBuffers    = false;
+	_supportPixelBuffers     = false;
 
 	_fullScreen = false;
 
@@ -73,6 +78,9 @@ GraphicsManager::GraphicsManager() : _projection(4, 4), _projectionInv(4, 4) {
 
 	_fpsCounter = new FPSCounter(3);
 
+	_objectsDrawn  = 0;
+	_objectsCulled = 0;
+
 	_frameLock = 0;
 
 	_cursor = 0;
@@ -145,6 +153,8 @@ void GraphicsManager::deinit() {
 
 	_needManualDeS3TC        = false;
 	_supportMultipleTextures = false;
+	_supportVertexBuffers    = false;
+	_supportPixelBuffers     = false;
 }
 
 bool GraphicsManager::ready() const {
@@ -159,6 +169,14 @@ bool GraphicsManager::supportMultipleTextures() const {
 	return _supportMultipleTextures;
 }
 
+bool GraphicsManager::supportVertexBuffers() const {
+	return _supportVertexBuffers;
+}
+
+bool GraphicsManager::supportPixelBuffers() const {
+	return _supportPixelBuffers;
+}
+
 int GraphicsManager::getMaxFSAA() const {
 	return _fsaaMax;
 }
@@ -171,6 +189,14 @@ uint32 GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+uint32 GraphicsManager::getObjectsDrawn() const {
+	return _objectsDrawn;
+}
+
+uint32 GraphicsManager::getObjectsCulled() const {
+	return _objectsCulled;
+}
+
 void GraphicsManager::initSize(int width, int height, bool fullscreen) {
 	int bpp = SDL_GetVideoInfo()->vfmt->BitsPerPixel;
 	if ((bpp != 24) && (bpp != 32))
@@ -318,6 +344,22 @@ void GraphicsManager::checkGLExtensions() {
 		_supportMultipleTextures = false;
 	} else
 		_supportMultipleTextures = true;
+
+	if (!GLEW_ARB_vertex_buffer_object) {
+		warning("Your graphics card does not support vertex buffer objects");
+		warning("Model geometry will be drawn out of system memory");
+
+		_supportVertexBuffers = false;
+	} else
+		_supportVertexBuffers = true;
+
+	if (!GLEW_ARB_vertex_buffer_object || !GLEW_ARB_pixel_buffer_object) {
+		warning("Your graphics card does not support pixel buffer objects");
+		warning("Video frames will be uploaded synchronously");
+
+		_supportPixelBuffers = false;
+	} else
+		_supportPixelBuffers = true;
 }
 
 void GraphicsManager::setWindowTitle(const Common::UString &title) {
@@ -624,6 +666,19 @@ void GraphicsManager::abandon(ListID ids, uint32 count) {
 	_hasAbandoned = true;
 }
 
+void GraphicsManager::abandonBuffers(BufferID *ids, uint32 count) {
+	if (count == 0)
+		return;
+
+	Common::StackLock lock(_abandonMutex);
+
+	_abandonBuffers.reserve(_abandonBuffers.size() + count);
+	while (count-- > 0)
+		_abandonBuffers.push_back(*ids++);
+
+	_hasAbandoned = true;
+}
+
 void GraphicsManager::setCursor(Cursor *cursor) {
 	lockFrame();
 
@@ -733,6 +788,19 @@ void GraphicsManager::buildNewTextures() {
 	QueueMan.unlockQueue(kQueueNewTexture);
 }
 
+void GraphicsManager::buildStreamedTextures() {
+	QueueMan.lockQueue(kQueueStreamedTexture);
+	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueStreamedTexture);
+
+	// Only upload a few of them, so that streaming in a whole area doesn't stall a frame.
+	// Once uploaded, a texture removes itself from the queue.
+	std::list<Queueable *>::const_iterator t = text.begin();
+	for (uint32 n = 0; (n < kStreamedTexturesPerFrame) && (t != text.end()); n++)
+		static_cast<GLContainer *>(*t++)->rebuild();
+
+	QueueMan.unlockQueue(kQueueStreamedTexture);
+}
+
 void GraphicsManager::beginScene() {
 	// Switch cursor on/off
 	if (_cursorState != kCursorStateStay)
@@ -772,8 +840,11 @@ bool GraphicsManager::playVideo() {
 }
 
 bool GraphicsManager::renderWorld() {
-	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
+	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject)) {
+		_objectsDrawn  = 0;
+		_objectsCulled = 0;
 		return false;
+	}
 
 	float cPos[3];
 	float cOrient[3];
@@ -783,42 +854,58 @@ bool GraphicsManager::renderWorld() {
 	memcpy(cOrient, CameraMan.getOrientation(), 3 * sizeof(float));
 	CameraMan.unlock();
 
+	// Apply camera orientation and position
+	Common::TransformationMatrix view;
+
+	view.rotate(-cOrient[0], 1.0, 0.0, 0.0);
+	view.rotate( cOrient[1], 0.0, 1.0, 0.0);
+	view.rotate(-cOrient[2], 0.0, 0.0, 1.0);
+
+	view.translate(-cPos[0], -cPos[1], cPos[2]);
+
+	_frustum.set(_projection * view);
+
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 
 	glMultMatrixf(_projection.get());
 
 	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-
-	// Apply camera orientation
-	glRotatef(-cOrient[0], 1.0, 0.0, 0.0);
-	glRotatef( cOrient[1], 0.0, 1.0, 0.0);
-	glRotatef(-cOrient[2], 0.0, 0.0, 1.0);
-
-	// Apply camera position
-	glTranslatef(-cPos[0], -cPos[1], cPos[2]);
+	glLoadMatrixf(view.get());
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
 	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
-	// Draw opaque objects
+	// Only draw the objects within the view frustum
+	_visibleObjects.clear();
 	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
+		Renderable *object = static_cast<Renderable *>(*o);
+		if (object->isInFrustum(_frustum))
+			_visibleObjects.push_back(object);
+	}
+
+	_objectsDrawn  = _visibleObjects.size();
+	_objectsCulled = objects.size() - _objectsDrawn;
+
+	// Draw opaque objects
+	for (std::vector<Renderable *>::const_iterator o = _visibleObjects.begin();
+	     o != _visibleObjects.end(); ++o) {
+
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		(*o)->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_iterator o = _visibleObjects.begin();
+	     o != _visibleObjects.end(); ++o) {
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		(*o)->render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
@@ -900,6 +987,8 @@ void GraphicsManager::renderScene() {
 	if (_frameLock > 0)
 		return;
 
+	buildStreamedTextures();
+
 	beginScene();
 
 	if (playVideo()) {
@@ -1005,8 +1094,12 @@ void GraphicsManager::cleanupAbandoned() {
 	for (std::list<ListID>::iterator l = _abandonLists.begin(); l != _abandonLists.end(); ++l)
 		glDeleteLists(*l, 1);
 
+	if (!_abandonBuffers.empty())
+		glDeleteBuffersARB(_abandonBuffers.size(), &_abandonBuffers[0]);
+
 	_abandonTextures.clear();
 	_abandonLists.clear();
+	_abandonBuffers.clear();
 
 	_hasAbandoned = false;
 }
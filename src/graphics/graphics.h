@@ -40,6 +40,8 @@
 #include "common/mutex.h"
 #include "common/matrix.h"
 
+#include "graphics/frustum.h"
+
 namespace Common {
 	class UString;
 }
@@ -68,6 +70,10 @@ public:
 	bool needManualDeS3TC() const;
 	/** Do we have support for multiple textures? */
 	bool supportMultipleTextures() const;
+	/** Do we have support for vertex and index buffer objects? */
+	bool supportVertexBuffers() const;
+	/** Do we have support for pixel buffer objects? */
+	bool supportPixelBuffers() const;
 
 	/** Set the screen size. */
 	void setScreenSize(int width, int height);
@@ -104,6 +110,11 @@ public:
 	/** How many frames per second to we render at the moments? */
 	uint32 getFPS() const;
 
+	/** How many world objects were drawn in the last frame? */
+	uint32 getObjectsDrawn() const;
+	/** How many world objects were outside the view frustum in the last frame? */
+	uint32 getObjectsCulled() const;
+
 	/** That the window's title. */
 	void setWindowTitle(const Common::UString &title);
 
@@ -130,6 +141,8 @@ public:
 
 	/** Get the object at this screen position. */
 	Renderable *getObjectAt(float x, float y);
+	/** Get the GUI object at this screen position. */
+	Renderable *getGUIObjectAt(float x, float y) const;
 
 	/** Recalculate all object distances to the camera and resort the objebts. */
 	void recalculateObjectDistances();
@@ -146,6 +159,8 @@ public:
 	void abandon(TextureID *ids, uint32 count);
 	/** Abandon these lists. */
 	void abandon(ListID ids, uint32 count);
+	/** Abandon these buffer objects. */
+	void abandonBuffers(BufferID *ids, uint32 count);
 
 
 	/** Render one complete frame of the scene. */
@@ -164,6 +179,8 @@ private:
 	// Extensions
 	bool _needManualDeS3TC;        ///< Do we need to do manual S3TC DXTn decompression?
 	bool _supportMultipleTextures; ///< Do we have support for multiple textures?
+	bool _supportVertexBuffers;    ///< Do we have support for vertex buffer objects?
+	bool _supportPixelBuffers;     ///< Do we have support for pixel buffer objects?
 
 	bool _fullScreen; ///< Are we currently in fullscreen mode?
 
@@ -182,6 +199,14 @@ private:
 	Common::Matrix _projection;    ///< Our projection matrix.
 	Common::Matrix _projectionInv; ///< The inverse of our projection matrix.
 
+	Frustum _frustum; ///< The view frustum of the current frame.
+
+	/** The world objects within the view frustum of the current frame. */
+	std::vector<Renderable *> _visibleObjects;
+
+	uint32 _objectsDrawn;  ///< The number of world objects drawn in the last frame.
+	uint32 _objectsCulled; ///< The number of world objects culled in the last frame.
+
 	uint32 _frameLock;
 
 	Common::Mutex _frameLockMutex; ///< A soft mutex locked for each frame.
@@ -199,6 +224,7 @@ private:
 
 	std::vector<TextureID> _abandonTextures; ///< Abandoned textures.
 	std::list<ListID>      _abandonLists;    ///< Abandoned lists.
+	std::vector<BufferID>  _abandonBuffers;  ///< Abandoned buffer objects.
 
 	Common::Mutex _abandonMutex; ///< A mutex protecting abandoned structures.
 
@@ -223,10 +249,10 @@ private:
 
 	void cleanupAbandoned();
 
-	Renderable *getGUIObjectAt(float x, float y) const;
 	Renderable *getWorldObjectAt(float x, float y) const;
 
 	void buildNewTextures();
+	void buildStreamedTextures();
 
 	void beginScene();
 	bool playVideo();
@@ -49,9 +49,13 @@ Surface::Surface(int width, int height) {
 	_mipMaps[0]->size   = _mipMaps[0]->width * _mipMaps[0]->height * 4;
 
 	_mipMaps[0]->data = new byte[_mipMaps[0]->size];
+
+	_ownData = _mipMaps[0]->data;
 }
 
 Surface::~Surface() {
+	// Only ever free our own memory
+	_mipMaps[0]->data = _ownData;
 }
 
 int Surface::getWidth() const {
@@ -86,4 +90,8 @@ void Surface::fill(byte r, byte g, byte b, byte a) {
 	}
 }
 
+void Surface::setExternalData(byte *data) {
+	_mipMaps[0]->data = data ? data : _ownData;
+}
+
 } // End of namespace Graphics
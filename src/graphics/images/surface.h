@@ -46,6 +46,17 @@ public:
 	const byte *getData() const;
 
 	void fill(byte r, byte g, byte b, byte a);
+
+	/** Let the surface use external pixel memory, like a mapped pixel buffer.
+	 *
+	 *  The memory has to be large enough for the surface's dimensions and
+	 *  stays owned by the caller. Passing 0 switches back to the surface's
+	 *  own memory, whose content is left as it was.
+	 */
+	void setExternalData(byte *data);
+
+private:
+	byte *_ownData; ///< The surface's own pixel memory.
 };
 
 } // End of namespace Graphics
@@ -0,0 +1,184 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file graphics/meshbuffer.cpp
+ *  Mesh geometry stored in OpenGL buffer objects.
+ */
+
+#include "common/util.h"
+
+#include "graphics/graphics.h"
+#include "graphics/meshbuffer.h"
+
+namespace Graphics {
+
+MeshBuffer::MeshBuffer() : _vertexSize(0), _indexCount(0), _textureCount(0),
+	_vertexBuffer(0), _indexBuffer(0), _uploaded(false) {
+}
+
+MeshBuffer::~MeshBuffer() {
+	BufferID buffers[2] = { _vertexBuffer, _indexBuffer };
+
+	if (_vertexBuffer != 0)
+		GfxMan.abandonBuffers(buffers, 2);
+}
+
+void MeshBuffer::set(std::vector<float> &vertices, std::vector<uint32> &indices, uint32 textureCount) {
+	_vertices.swap(vertices);
+	_indices.swap(indices);
+
+	vertices.clear();
+	indices.clear();
+
+	_vertexSize   = _vertices.size();
+	_indexCount   = _indices.size();
+	_textureCount = textureCount;
+
+	_uploaded = false;
+}
+
+void MeshBuffer::doRebuild() {
+	// Nothing to upload, or the data already lives in the buffers only
+	if (!GfxMan.supportVertexBuffers() || (_indexCount == 0) || _vertices.empty())
+		return;
+
+	if (_vertexBuffer == 0)
+		glGenBuffersARB(1, &_vertexBuffer);
+	if (_indexBuffer == 0)
+		glGenBuffersARB(1, &_indexBuffer);
+
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, _vertexBuffer);
+	glBufferDataARB(GL_ARRAY_BUFFER_ARB, _vertexSize * sizeof(float),
+	                &_vertices[0], GL_STATIC_DRAW_ARB);
+
+	glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, _indexBuffer);
+	glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, _indexCount * sizeof(uint32),
+	                &_indices[0], GL_STATIC_DRAW_ARB);
+
+	glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+	glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+
+	// The buffers hold the only copy of the data now
+	std::vector<float>().swap(_vertices);
+	std::vector<uint32>().swap(_indices);
+
+	_uploaded = true;
+}
+
+void MeshBuffer::doDestroy() {
+	// Read the data back out of the buffers, so that it can be uploaded into the next context
+	if (_uploaded) {
+		_vertices.resize(_vertexSize);
+		_indices.resize(_indexCount);
+
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, _vertexBuffer);
+		glGetBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, _vertexSize * sizeof(float), &_vertices[0]);
+
+		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, _indexBuffer);
+		glGetBufferSubDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0, _indexCount * sizeof(uint32), &_indices[0]);
+
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+	}
+
+	if (_vertexBuffer != 0)
+		glDeleteBuffersARB(1, &_vertexBuffer);
+	if (_indexBuffer != 0)
+		glDeleteBuffersARB(1, &_indexBuffer);
+
+	_vertexBuffer = 0;
+	_indexBuffer  = 0;
+
+	_uploaded = false;
+}
+
+/** Select the texture unit to set up, if there's more than one. */
+static void setTextureUnit(uint32 unit) {
+	if (!GfxMan.supportMultipleTextures())
+		return;
+
+	glActiveTextureARB(GL_TEXTURE0_ARB + unit);
+	glClientActiveTextureARB(GL_TEXTURE0_ARB + unit);
+}
+
+void MeshBuffer::draw(const std::vector<TextureID> &textures) {
+	if (_indexCount == 0)
+		return;
+
+	const bool useBuffers = GfxMan.supportVertexBuffers();
+	if (useBuffers && !_uploaded)
+		rebuild();
+
+	const uint8 *vertices = 0;
+	const uint8 *indices  = 0;
+
+	if (useBuffers) {
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB        , _vertexBuffer);
+		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, _indexBuffer);
+	} else {
+		vertices = (const uint8 *) &_vertices[0];
+		indices  = (const uint8 *) &_indices[0];
+	}
+
+	const GLsizei stride = (3 + 2 * _textureCount) * sizeof(float);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, stride, vertices);
+
+	// Without multitexturing, only the first texture is used
+	uint32 textureCount = MIN<uint32>(_textureCount, textures.size());
+	if (!GfxMan.supportMultipleTextures())
+		textureCount = MIN<uint32>(textureCount, 1);
+
+	for (uint32 t = 0; t < textureCount; t++) {
+		setTextureUnit(t);
+
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, textures[t]);
+
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, stride, vertices + (3 + 2 * t) * sizeof(float));
+	}
+
+	glDrawElements(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, indices);
+
+	for (uint32 t = 0; t < textureCount; t++) {
+		setTextureUnit(t);
+
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisable(GL_TEXTURE_2D);
+	}
+
+	setTextureUnit(0);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	if (useBuffers) {
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB        , 0);
+		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,94 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file graphics/meshbuffer.h
+ *  Mesh geometry stored in OpenGL buffer objects.
+ */
+
+#ifndef GRAPHICS_MESHBUFFER_H
+#define GRAPHICS_MESHBUFFER_H
+
+#include <vector>
+
+#include "common/types.h"
+
+#include "graphics/types.h"
+#include "graphics/glcontainer.h"
+
+namespace Graphics {
+
+/** The geometry of a triangle mesh, stored in OpenGL buffer objects.
+ *
+ *  Each vertex consists of 3 position coordinates, followed by 2 texture
+ *  coordinates for every texture. All vertices are interleaved into a vertex
+ *  buffer, with every face indexing its 3 vertices in an index buffer.
+ *
+ *  Once uploaded, the mesh data only lives in the buffer objects. When the
+ *  OpenGL context is destroyed, the data is read back, to be uploaded again
+ *  into the new context.
+ *
+ *  If the OpenGL implementation doesn't support buffer objects, the mesh is
+ *  drawn out of plain vertex arrays instead.
+ */
+class MeshBuffer : public GLContainer {
+public:
+	MeshBuffer();
+	~MeshBuffer();
+
+	/** Take over the mesh data, leaving the given vectors empty.
+	 *
+	 *  @param vertices The interleaved vertex data.
+	 *  @param indices  The vertex indices of all faces.
+	 *  @param textureCount The number of texture coordinate pairs in each vertex.
+	 */
+	void set(std::vector<float> &vertices, std::vector<uint32> &indices, uint32 textureCount);
+
+	/** Draw the mesh. Needs to be called from within the main thread.
+	 *
+	 *  @param textures The textures to draw with, one for each set of texture coordinates.
+	 */
+	void draw(const std::vector<TextureID> &textures);
+
+protected:
+	void doRebuild();
+	void doDestroy();
+
+private:
+	std::vector<float>  _vertices; ///< The interleaved vertex data, until uploaded.
+	std::vector<uint32> _indices;  ///< The vertex indices of all faces, until uploaded.
+
+	uint32 _vertexSize;   ///< Size of the vertex data, in floats.
+	uint32 _indexCount;   ///< Number of vertex indices.
+	uint32 _textureCount; ///< Number of texture coordinate pairs per vertex.
+
+	BufferID _vertexBuffer; ///< OpenGL buffer holding the vertex data.
+	BufferID _indexBuffer;  ///< OpenGL buffer holding the indices.
+
+	bool _uploaded; ///< Was the mesh uploaded into buffers since the last change?
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_MESHBUFFER_H
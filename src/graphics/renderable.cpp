@@ -120,4 +120,8 @@ bool Renderable::isIn(float x1, float y1, float z1, float x2, float y2, float z2
 	return false;
 }
 
+bool Renderable::isInFrustum(const Frustum &frustum) const {
+	return true;
+}
+
 } // End of namespace Graphics
@@ -37,6 +37,8 @@
 
 namespace Graphics {
 
+class Frustum;
+
 /** An object that can be displayed by the graphics manager. */
 class Renderable : public Queueable {
 public:
@@ -79,6 +81,9 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Is the object at least partially within the view frustum? */
+	virtual bool isInFrustum(const Frustum &frustum) const;
+
 protected:
 	QueueType _queueExists;
 	QueueType _queueVisible;
@@ -42,6 +42,7 @@ namespace Graphics {
 
 typedef GLuint TextureID;
 typedef GLuint ListID;
+typedef GLuint BufferID;
 
 enum PixelFormat {
 	kPixelFormatRGB  = GL_RGB ,
@@ -69,6 +70,7 @@ enum PixelDataType {
 enum QueueType {
 	kQueueTexture               = 0, ///< A texture.
 	kQueueNewTexture               , ///< A newly created texture.
+	kQueueStreamedTexture          , ///< A texture decoded in the background, waiting for its upload.
 	kQueueWorldObject              , ///< An object in 3D space.
 	kQueueVisibleWorldObject       , ///< A visible object in 3D space.
 	kQueueGUIFrontObject           , ///< A GUI object.
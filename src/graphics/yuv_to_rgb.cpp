@@ -97,8 +97,26 @@
 
 #include "graphics/yuv_to_rgb.h"
 
+// SIMD paths are compiled with per-function target attributes and picked
+// at runtime, so the rest of the build doesn't need any special flags.
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && \
+    (defined(__i386__) || defined(__x86_64__))
+	#define YUV_TO_RGB_X86 1
+
+	#include <immintrin.h>
+#endif
+
 namespace Graphics {
 
+/** Convert one row of pixels.
+ *
+ *  The chroma offsets are given once for every two pixels, already with
+ *  the lookup table bias removed, i.e. a color value is Y plus offset,
+ *  clipped to [0, 255].
+ */
+typedef void (*ConvertRowFunc)(byte *dst, const byte *ySrc, const byte *aSrc,
+                               const int16 *crR, const int16 *crbG, const int16 *cbB, int width);
+
 class YUVToRGBLookup {
 public:
 	YUVToRGBLookup();
@@ -106,9 +124,17 @@ public:
 
 	int16 *_colorTab;
 	byte *_rgbToPix;
+
+	/** The fastest row converter the CPU supports, or 0 for the plain scalar path. */
+	ConvertRowFunc _convertRow;
 };
 
+static ConvertRowFunc findRowConverter();
+static bool getRowConverter(YUVToRGBPath path, ConvertRowFunc &convertRow);
+
 YUVToRGBLookup::YUVToRGBLookup() {
+	_convertRow = findRowConverter();
+
 	_colorTab = new int16[4 * 256]; // 2048 bytes
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
@@ -166,6 +192,9 @@ class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
 	const YUVToRGBLookup *getLookup();
 
+	/** Make the lookup use this row converter. */
+	void setRowConverter(ConvertRowFunc convertRow);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -189,6 +218,160 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup() {
 	return _lookup;
 }
 
+void YUVToRGBManager::setRowConverter(ConvertRowFunc convertRow) {
+	getLookup();
+
+	_lookup->_convertRow = convertRow;
+}
+
+#ifdef YUV_TO_RGB_X86
+
+/** Convert the few pixels at the end of a row the SIMD paths leave over. */
+static void convertRowGeneric(byte *dst, const byte *ySrc, const byte *aSrc,
+                              const int16 *crR, const int16 *crbG, const int16 *cbB, int width) {
+
+	for (int x = 0; x < width; x++, dst += 4) {
+		const int c = x >> 1;
+
+		dst[0] = CLIP<int>(ySrc[x] + cbB [c], 0, 255);
+		dst[1] = CLIP<int>(ySrc[x] + crbG[c], 0, 255);
+		dst[2] = CLIP<int>(ySrc[x] + crR [c], 0, 255);
+		dst[3] = aSrc ? aSrc[x] : 0xFF;
+	}
+}
+
+__attribute__((target("sse2")))
+static void convertRowSSE2(byte *dst, const byte *ySrc, const byte *aSrc,
+                           const int16 *crR, const int16 *crbG, const int16 *cbB, int width) {
+
+	const __m128i zero   = _mm_setzero_si128();
+	const __m128i opaque = _mm_set1_epi8((char) 0xFF);
+
+	// 8 pixels, sharing 4 chroma offsets, at a time
+	int x = 0;
+	for (; (x + 8) <= width; x += 8) {
+		const int c = x >> 1;
+
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (ySrc + x)), zero);
+
+		__m128i r = _mm_loadl_epi64((const __m128i *) (crR  + c));
+		__m128i g = _mm_loadl_epi64((const __m128i *) (crbG + c));
+		__m128i b = _mm_loadl_epi64((const __m128i *) (cbB  + c));
+
+		// Each chroma offset applies to two neighbouring pixels
+		r = _mm_unpacklo_epi16(r, r);
+		g = _mm_unpacklo_epi16(g, g);
+		b = _mm_unpacklo_epi16(b, b);
+
+		// The saturating pack does the clipping to [0, 255]
+		r = _mm_packus_epi16(_mm_add_epi16(y, r), zero);
+		g = _mm_packus_epi16(_mm_add_epi16(y, g), zero);
+		b = _mm_packus_epi16(_mm_add_epi16(y, b), zero);
+
+		const __m128i a = aSrc ? _mm_loadl_epi64((const __m128i *) (aSrc + x)) : opaque;
+
+		const __m128i bg = _mm_unpacklo_epi8(b, g);
+		const __m128i ra = _mm_unpacklo_epi8(r, a);
+
+		_mm_storeu_si128((__m128i *) (dst + x * 4     ), _mm_unpacklo_epi16(bg, ra));
+		_mm_storeu_si128((__m128i *) (dst + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+	}
+
+	convertRowGeneric(dst + x * 4, ySrc + x, aSrc ? (aSrc + x) : 0,
+	                  crR + (x >> 1), crbG + (x >> 1), cbB + (x >> 1), width - x);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i loadChromaAVX2(const int16 *src) {
+	const __m128i c = _mm_loadu_si128((const __m128i *) src);
+
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(c, c)),
+	                               _mm_unpackhi_epi16(c, c), 1);
+}
+
+__attribute__((target("avx2")))
+static void convertRowAVX2(byte *dst, const byte *ySrc, const byte *aSrc,
+                           const int16 *crR, const int16 *crbG, const int16 *cbB, int width) {
+
+	const __m256i zero   = _mm256_setzero_si256();
+	const __m256i opaque = _mm256_set1_epi8((char) 0xFF);
+
+	// 16 pixels, sharing 8 chroma offsets, at a time
+	int x = 0;
+	for (; (x + 16) <= width; x += 16) {
+		const int c = x >> 1;
+
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (ySrc + x)));
+
+		// The pack works within each 128-bit lane, so lane 0 holds
+		// pixels 0-7 and lane 1 holds pixels 8-15 in their low halves
+		const __m256i r = _mm256_packus_epi16(_mm256_add_epi16(y, loadChromaAVX2(crR  + c)), zero);
+		const __m256i g = _mm256_packus_epi16(_mm256_add_epi16(y, loadChromaAVX2(crbG + c)), zero);
+		const __m256i b = _mm256_packus_epi16(_mm256_add_epi16(y, loadChromaAVX2(cbB  + c)), zero);
+
+		__m256i a = opaque;
+		if (aSrc) {
+			const __m128i a8 = _mm_loadl_epi64((const __m128i *) (aSrc + x));
+			const __m128i a16 = _mm_loadl_epi64((const __m128i *) (aSrc + x + 8));
+
+			a = _mm256_inserti128_si256(_mm256_castsi128_si256(a8), a16, 1);
+		}
+
+		const __m256i bg = _mm256_unpacklo_epi8(b, g);
+		const __m256i ra = _mm256_unpacklo_epi8(r, a);
+
+		const __m256i lo = _mm256_unpacklo_epi16(bg, ra); // Pixels 0-3 and 8-11
+		const __m256i hi = _mm256_unpackhi_epi16(bg, ra); // Pixels 4-7 and 12-15
+
+		_mm256_storeu_si256((__m256i *) (dst + x * 4     ), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *) (dst + x * 4 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	convertRowSSE2(dst + x * 4, ySrc + x, aSrc ? (aSrc + x) : 0,
+	               crR + (x >> 1), crbG + (x >> 1), cbB + (x >> 1), width - x);
+}
+
+static bool getRowConverter(YUVToRGBPath path, ConvertRowFunc &convertRow) {
+	__builtin_cpu_init();
+
+	switch (path) {
+		case kYUVToRGBPathSSE2:
+			convertRow = &convertRowSSE2;
+			return __builtin_cpu_supports("sse2");
+
+		case kYUVToRGBPathAVX2:
+			convertRow = &convertRowAVX2;
+			return __builtin_cpu_supports("avx2");
+
+		default:
+			break;
+	}
+
+	convertRow = 0;
+	return path == kYUVToRGBPathScalar;
+}
+
+#else
+
+static bool getRowConverter(YUVToRGBPath path, ConvertRowFunc &convertRow) {
+	convertRow = 0;
+
+	return path == kYUVToRGBPathScalar;
+}
+
+#endif
+
+static ConvertRowFunc findRowConverter() {
+	ConvertRowFunc convertRow;
+
+	if (getRowConverter(kYUVToRGBPathAVX2, convertRow))
+		return convertRow;
+	if (getRowConverter(kYUVToRGBPathSSE2, convertRow))
+		return convertRow;
+
+	return 0;
+}
+
 } // End of namespace Graphics
 
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -204,8 +387,7 @@ namespace Graphics {
 	*((d) + 2) = L[cr_r]; \
 	*((d) + 3) = (a)
 
-void convertYUVA420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup();
+static void convertYUVA420ToRGBAScalar(const YUVToRGBLookup *lookup, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
@@ -242,8 +424,7 @@ void convertYUVA420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte
 	}
 }
 
-void convertYUV420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup();
+static void convertYUV420ToRGBAScalar(const YUVToRGBLookup *lookup, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
@@ -277,4 +458,80 @@ void convertYUV420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *
 	}
 }
 
+/** Convert row pairs with a row converter.
+ *
+ *  Like the scalar path, this writes the image bottom-up and ignores an odd
+ *  last row and column.
+ */
+static void convertYUV420Rows(const YUVToRGBLookup *lookup, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBBuffer &buffer) {
+	int halfHeight = yHeight >> 1;
+	int halfWidth = yWidth >> 1;
+
+	if ((halfHeight <= 0) || (halfWidth <= 0))
+		return;
+
+	// Only ever grows, so that it's allocated once for all frames of a video
+	if (buffer.size() < (size_t) (3 * halfWidth))
+		buffer.resize(3 * halfWidth);
+
+	int16 *crR  = &buffer[0 * halfWidth];
+	int16 *crbG = &buffer[1 * halfWidth];
+	int16 *cbB  = &buffer[2 * halfWidth];
+
+	dst += dstPitch * (yHeight - 1);
+
+	for (int h = 0; h < halfHeight; h++) {
+		// Strip the table bias, leaving the plain offset to add to Y
+		for (int w = 0; w < halfWidth; w++) {
+			crR [w] = lookup->_colorTab[vSrc[w] + 0 * 256] - (0 * 768 + 256);
+			crbG[w] = lookup->_colorTab[vSrc[w] + 1 * 256] + lookup->_colorTab[uSrc[w] + 2 * 256] - (1 * 768 + 256);
+			cbB [w] = lookup->_colorTab[uSrc[w] + 3 * 256] - (2 * 768 + 256);
+		}
+
+		lookup->_convertRow(dst, ySrc, aSrc, crR, crbG, cbB, halfWidth * 2);
+		lookup->_convertRow(dst - dstPitch, ySrc + yPitch, aSrc ? (aSrc + yPitch) : 0, crR, crbG, cbB, halfWidth * 2);
+
+		dst  -= dstPitch * 2;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+
+		if (aSrc)
+			aSrc += yPitch << 1;
+	}
+}
+
+bool hasYUVToRGBPath(YUVToRGBPath path) {
+	ConvertRowFunc convertRow;
+
+	return getRowConverter(path, convertRow);
+}
+
+bool setYUVToRGBPath(YUVToRGBPath path) {
+	ConvertRowFunc convertRow;
+	if (!getRowConverter(path, convertRow))
+		return false;
+
+	YUVToRGBMan.setRowConverter(convertRow);
+	return true;
+}
+
+void convertYUVA420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBBuffer &buffer) {
+	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup();
+
+	if (lookup->_convertRow)
+		convertYUV420Rows(lookup, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, buffer);
+	else
+		convertYUVA420ToRGBAScalar(lookup, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void convertYUV420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBBuffer &buffer) {
+	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup();
+
+	if (lookup->_convertRow)
+		convertYUV420Rows(lookup, dst, dstPitch, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, buffer);
+	else
+		convertYUV420ToRGBAScalar(lookup, dst, dstPitch, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
 } // End of namespace Graphics
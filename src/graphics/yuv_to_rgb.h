@@ -30,13 +30,40 @@
 #ifndef GRAPHICS_YUV_TO_RGB_H
 #define GRAPHICS_YUV_TO_RGB_H
 
+#include <vector>
+
 #include "graphics/types.h"
 
 namespace Graphics {
 
-void convertYUVA420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+/** Scratch memory for the YUV to RGB conversion.
+ *
+ *  A video decoder keeps one around, so that it isn't reallocated for every frame.
+ */
+typedef std::vector<int16> YUVToRGBBuffer;
+
+/** The code paths the YUV to RGB conversion can take. */
+enum YUVToRGBPath {
+	kYUVToRGBPathScalar, ///< Plain C++, one pixel at a time.
+	kYUVToRGBPathSSE2,   ///< Eight pixels at a time, using SSE2.
+	kYUVToRGBPathAVX2    ///< Sixteen pixels at a time, using AVX2.
+};
+
+/** Does the CPU support that YUV to RGB conversion path? */
+bool hasYUVToRGBPath(YUVToRGBPath path);
+
+/** Force the YUV to RGB conversion to take that path.
+ *
+ *  By default, the fastest path the CPU supports is taken. This is meant
+ *  for benchmarking and debugging, and must not be called while frames are
+ *  converted. Returns false, changing nothing, if the CPU doesn't support
+ *  the path.
+ */
+bool setYUVToRGBPath(YUVToRGBPath path);
+
+void convertYUVA420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBBuffer &buffer);
 
-void convertYUV420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+void convertYUV420ToRGBA(byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBBuffer &buffer);
 
 } // End of namespace Graphics
 
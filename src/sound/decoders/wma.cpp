@@ -563,7 +563,7 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 	if (_blockAlign)
 		size = _blockAlign;
 
-	Common::BitStream8MSB bits(data);
+	Common::BitStreamMemory8MSB bits(data);
 
 	int    outputDataSize = 0;
 	int16 *outputData     = 0;
@@ -613,8 +613,7 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 				_lastSuperframeLen += 1;
 			}
 
-			Common::MemoryReadStream lastSuperframe(_lastSuperframe, _lastSuperframeLen);
-			Common::BitStream8MSB lastBits(lastSuperframe);
+			Common::BitStreamMemory8MSB lastBits(_lastSuperframe, _lastSuperframeLen);
 
 			lastBits.skip(_lastBitoffset);
 
@@ -0,0 +1,247 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file sound/samplecache.cpp
+ *  A cache of fully decoded short sounds.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "common/util.h"
+#include "common/error.h"
+
+#include "sound/samplecache.h"
+#include "sound/audiostream.h"
+
+/** Number of samples to decode at once. */
+static const int kDecodeChunkSize = 8192;
+
+namespace Sound {
+
+class SampleCache::SampleStream : public RewindableAudioStream {
+public:
+	SampleStream(const SamplesPtr &samples) : _samples(samples), _pos(0) {
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int n = MIN<int>(numSamples, _samples->data.size() - _pos);
+		if (n <= 0)
+			return 0;
+
+		memcpy(buffer, &_samples->data[_pos], n * sizeof(int16));
+		_pos += n;
+
+		return n;
+	}
+
+	int getChannels() const {
+		return _samples->channels;
+	}
+
+	int getRate() const {
+		return _samples->rate;
+	}
+
+	bool endOfData() const {
+		return _pos >= _samples->data.size();
+	}
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+private:
+	SamplesPtr _samples; ///< The samples, shared with the cache and other streams.
+	size_t     _pos;     ///< The current position within the samples.
+};
+
+
+SampleCache::SampleCache() : _maxSize(0), _maxSoundSize(0), _size(0), _hits(0), _misses(0) {
+}
+
+SampleCache::~SampleCache() {
+}
+
+void SampleCache::setLimits(uint32 maxSize, uint32 maxSoundSize) {
+	Common::StackLock lock(_mutex);
+
+	_maxSize      = maxSize;
+	_maxSoundSize = MIN(maxSoundSize, maxSize);
+
+	// What was too large before might fit now
+	_tooLarge.clear();
+
+	shrink();
+}
+
+void SampleCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	_entries.clear();
+	_entryMap.clear();
+	_tooLarge.clear();
+
+	_size   = 0;
+	_hits   = 0;
+	_misses = 0;
+}
+
+RewindableAudioStream *SampleCache::get(const Common::UString &name) {
+	Common::UString key = name;
+	key.tolower();
+
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator e = _entryMap.find(key);
+	if (e == _entryMap.end()) {
+		_misses++;
+		return 0;
+	}
+
+	_hits++;
+
+	// Mark as most recently played
+	_entries.splice(_entries.begin(), _entries, e->second);
+
+	return new SampleStream(e->second->samples);
+}
+
+RewindableAudioStream *SampleCache::add(const Common::UString &name, RewindableAudioStream *stream) {
+	assert(stream);
+
+	Common::UString key = name;
+	key.tolower();
+
+	uint32 maxSoundSize;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_tooLarge.find(key) != _tooLarge.end())
+			return stream;
+
+		maxSoundSize = _maxSoundSize;
+	}
+
+	const size_t maxSamples = maxSoundSize / sizeof(int16);
+
+	boost::shared_ptr<Samples> samples(new Samples);
+
+	samples->rate     = stream->getRate();
+	samples->channels = stream->getChannels();
+
+	std::vector<int16> &data = samples->data;
+
+	// Decode the whole sound, unless it turns out to be too large.
+	// The decoding happens outside the mutex, since it can take a while.
+	bool tooLarge = false;
+	while (!stream->endOfData()) {
+		const size_t pos = data.size();
+
+		data.resize(pos + kDecodeChunkSize);
+
+		const int n = stream->readBuffer(&data[pos], kDecodeChunkSize);
+
+		data.resize(pos + MAX(n, 0));
+		if (data.size() > maxSamples) {
+			tooLarge = true;
+			break;
+		}
+
+		if (n <= 0)
+			break;
+	}
+
+	if (tooLarge) {
+		{
+			Common::StackLock lock(_mutex);
+
+			_tooLarge.insert(key);
+		}
+
+		if (!stream->rewind()) {
+			delete stream;
+			throw Common::Exception("Failed to rewind sound \"%s\"", name.c_str());
+		}
+
+		return stream;
+	}
+
+	delete stream;
+
+	// Don't keep the slack from decoding in chunks around
+	std::vector<int16>(data).swap(data);
+
+	Common::StackLock lock(_mutex);
+
+	// Somebody else might have added the same sound in the meantime
+	EntryMap::iterator e = _entryMap.find(key);
+	if (e != _entryMap.end()) {
+		_size -= e->second->samples->data.size() * sizeof(int16);
+
+		_entries.erase(e->second);
+		_entryMap.erase(e);
+	}
+
+	Entry entry;
+
+	entry.name    = key;
+	entry.samples = samples;
+
+	_entries.push_front(entry);
+	_entryMap.insert(std::make_pair(key, _entries.begin()));
+
+	_size += data.size() * sizeof(int16);
+
+	shrink();
+
+	return new SampleStream(samples);
+}
+
+void SampleCache::getStats(Stats &stats) const {
+	Common::StackLock lock(_mutex);
+
+	stats.sounds  = _entries.size();
+	stats.size    = _size;
+	stats.maxSize = _maxSize;
+	stats.hits    = _hits;
+	stats.misses  = _misses;
+}
+
+void SampleCache::shrink() {
+	// Streams still playing an evicted sound keep their samples alive
+	while ((_size > _maxSize) && !_entries.empty()) {
+		const Entry &entry = _entries.back();
+
+		_size -= entry.samples->data.size() * sizeof(int16);
+
+		_entryMap.erase(entry.name);
+		_entries.pop_back();
+	}
+}
+
+} // End of namespace Sound
@@ -0,0 +1,136 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file sound/samplecache.h
+ *  A cache of fully decoded short sounds.
+ */
+
+#ifndef SOUND_SAMPLECACHE_H
+#define SOUND_SAMPLECACHE_H
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+#include "common/types.h"
+#include "common/ustring.h"
+#include "common/mutex.h"
+
+namespace Sound {
+
+class RewindableAudioStream;
+
+/** A cache of fully decoded short sounds, keyed by name.
+ *
+ *  Sounds that are replayed often, like footsteps or clicks, are decoded
+ *  only once. Every replay gets its own stream over the shared samples.
+ *  When the cache is full, the least recently played sounds are dropped.
+ */
+class SampleCache {
+public:
+	/** Statistics about the cache. */
+	struct Stats {
+		uint32 sounds;  ///< Number of cached sounds.
+		uint32 size;    ///< Size of all cached samples, in bytes.
+		uint32 maxSize; ///< Maximum size of all cached samples, in bytes.
+
+		uint32 hits;   ///< Number of times a sound was found in the cache.
+		uint32 misses; ///< Number of times a sound was not found in the cache.
+	};
+
+	SampleCache();
+	~SampleCache();
+
+	/** Set the maximum size of all cached samples and of a single sound, in bytes. */
+	void setLimits(uint32 maxSize, uint32 maxSoundSize);
+
+	/** Drop all cached sounds and reset the statistics. */
+	void clear();
+
+	/** Return a new stream over the cached sound, or 0 if it isn't cached.
+	 *
+	 *  Sound names are case-insensitive.
+	 */
+	RewindableAudioStream *get(const Common::UString &name);
+
+	/** Decode the whole sound and add it to the cache.
+	 *
+	 *  @param  name The name to cache the sound under.
+	 *  @param  stream The sound to decode. Will be taken over.
+	 *  @return A stream over the cached samples, or the rewound original
+	 *          stream if the sound is too large to be cached.
+	 */
+	RewindableAudioStream *add(const Common::UString &name, RewindableAudioStream *stream);
+
+	void getStats(Stats &stats) const;
+
+private:
+	/** The decoded samples of a sound. */
+	struct Samples {
+		int rate;
+		int channels;
+
+		std::vector<int16> data;
+	};
+
+	typedef boost::shared_ptr<const Samples> SamplesPtr;
+
+	struct Entry {
+		Common::UString name;
+		SamplesPtr samples;
+	};
+
+	typedef std::list<Entry> EntryList;
+	typedef std::map<Common::UString, EntryList::iterator> EntryMap;
+
+	uint32 _maxSize;      ///< Maximum size of all cached samples, in bytes.
+	uint32 _maxSoundSize; ///< Maximum size of a single cached sound, in bytes.
+
+	uint32 _size; ///< Size of all cached samples, in bytes.
+
+	EntryList _entries; ///< All cached sounds, most recently played first.
+	EntryMap  _entryMap;
+
+	/** Sounds we've already found to be too large for the cache. */
+	std::set<Common::UString> _tooLarge;
+
+	uint32 _hits;
+	uint32 _misses;
+
+	mutable Common::Mutex _mutex;
+
+	/** A stream over cached samples. */
+	class SampleStream;
+
+	/** Drop least recently played sounds until the cache fits into its maximum size. */
+	void shrink();
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_SAMPLECACHE_H
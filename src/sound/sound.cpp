@@ -43,18 +43,47 @@
 
 DECLARE_SINGLETON(Sound::SoundManager)
 
-/** Control how many buffers per sound OpenAL will create.
+/** Default maximum size of all cached decoded sounds, in KB. */
+static const int kSampleCacheSize = 16384;
+/** Default maximum size of a single cached decoded sound, in KB. */
+static const int kSampleCacheSoundSize = 512;
+
+/** Duration of the sound in each OpenAL buffer, in milliseconds.
  *
- *  @note clone2727 says: 5 is just a safe number. Mine only reached a max of 2.
+ *  @note Needs to be high enough to prevent stuttering, but low enough to
+ *        prevent a noticable lag. This is about the 32768 bytes that were
+ *        found to work fine for 44.1kHz stereo sound.
  */
-static const int kOpenALBufferCount = 5;
+static const uint32 kOpenALBufferDuration = 200;
 
-/** Number of bytes per OpenAL buffer.
+/** Duration of the sound to keep queued per channel, in milliseconds.
  *
- *  @note Needs to be high enough to prevent stuttering, but low enough to
- *        prevent a noticable lag. 32768 seems to work just fine.
+ *  @note The update runs at least every 100ms, so this leaves plenty of room.
  */
-static const int kOpenALBufferSize = 32768;
+static const uint32 kOpenALQueueDuration = 800;
+
+static const uint32 kOpenALBufferSizeMin  =  4096; ///< Minimum number of bytes per OpenAL buffer.
+static const uint32 kOpenALBufferSizeMax  = 65536; ///< Maximum number of bytes per OpenAL buffer.
+static const uint32 kOpenALBufferCountMin =     2; ///< Minimum number of OpenAL buffers per channel.
+static const uint32 kOpenALBufferCountMax =     8; ///< Maximum number of OpenAL buffers per channel.
+
+/** Maximum number of unused OpenAL sources kept around for reuse. */
+static const size_t kOpenALPoolSources =  32;
+/** Maximum number of unused OpenAL buffers kept around for reuse. */
+static const size_t kOpenALPoolBuffers = 128;
+
+/** Find the size and number of OpenAL buffers to use for a sound. */
+static void getBufferDimensions(int rate, int channels, uint32 &size, uint32 &count) {
+	const uint32 frameSize      = MAX(channels, 1) * 2;
+	const uint32 bytesPerSecond = MAX(rate    , 1) * frameSize;
+
+	size  = CLIP<uint32>((bytesPerSecond * kOpenALBufferDuration) / 1000, kOpenALBufferSizeMin, kOpenALBufferSizeMax);
+	size -= size % frameSize;
+
+	const uint32 queueSize = (bytesPerSecond * kOpenALQueueDuration) / 1000;
+
+	count = CLIP<uint32>((queueSize + size - 1) / size, kOpenALBufferCountMin, kOpenALBufferCountMax);
+}
 
 namespace Sound {
 
@@ -63,13 +92,22 @@ SoundManager::SoundManager() : _ready(false), _hasMultiChannel(false), _format51
 
 void SoundManager::init() {
 	for (int i = 0; i < kChannelCount; i++)
-		_channels[i] = 0;
+		_channels[i].reset();
 
 	for (int i = 0; i < kSoundTypeMAX; i++)
 		_types[i].gain = 1.0;
 
-	_curChannel = 1;
-	_curID      = 1;
+	// Channel 0 is reserved for "invalid channel". The lowest slots are handed out first.
+	_freeChannels.clear();
+	_freeChannels.reserve(kChannelCount - 1);
+	for (int i = kChannelCount - 1; i > 0; i--)
+		_freeChannels.push_back(i);
+
+	_curID = 1;
+
+	_sampleCache.clear();
+	_sampleCache.setLimits(MAX(ConfigMan.getInt("soundcachesize"    , kSampleCacheSize     ), 0) * 1024,
+	                       MAX(ConfigMan.getInt("soundcachesoundsize", kSampleCacheSoundSize), 0) * 1024);
 
 	_dev = alcOpenDevice(0);
 	if (!_dev)
@@ -103,8 +141,17 @@ void SoundManager::deinit() {
 	if (!destroyThread())
 		warning("SoundManager::deinit(): Sound thread had to be killed");
 
-	for (uint16 i = 1; i < kChannelCount; i++)
-		freeChannel(i);
+	stopAll();
+
+	_sampleCache.clear();
+
+	if (!_freeSources.empty())
+		alDeleteSources(_freeSources.size(), &_freeSources[0]);
+	if (!_freeBuffers.empty())
+		alDeleteBuffers(_freeBuffers.size(), &_freeBuffers[0]);
+
+	_freeSources.clear();
+	_freeBuffers.clear();
 
 	alcMakeContextCurrent(0);
 	alcDestroyContext(_ctx);
@@ -124,48 +171,43 @@ void SoundManager::triggerUpdate() {
 }
 
 bool SoundManager::isValidChannel(const ChannelHandle &handle) const {
-	if ((handle.channel == 0) || (handle.id == 0) || !_channels[handle.channel])
-		return false;
-
-	if (_channels[handle.channel]->id != handle.id)
-		return false;
-
-	return true;
+	return getChannel(handle).get() != 0;
 }
 
 bool SoundManager::isPlaying(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
-	if ((handle.channel == 0) || (handle.id == 0) || !_channels[handle.channel])
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
 		return false;
 
-	if (_channels[handle.channel]->id != handle.id)
+	Common::StackLock lock(channel->mutex);
+
+	if (channel->id != handle.id)
 		return false;
 
-	return isPlaying(handle.channel);
+	return isPlaying(*channel);
 }
 
-bool SoundManager::isPlaying(uint16 channel) const {
-	if ((channel == 0) || !_channels[channel])
+bool SoundManager::isPlaying(Channel &channel) const {
+	if (channel.id == 0)
 		return false;
 
 	ALint val;
-	alGetSourcei(_channels[channel]->source, AL_SOURCE_STATE, &val);
+	alGetSourcei(channel.source, AL_SOURCE_STATE, &val);
 
 	if (val != AL_PLAYING) {
-		if (!_channels[channel]->stream || _channels[channel]->stream->endOfStream()) {
+		if (!channel.stream || channel.stream->endOfStream()) {
 			ALint buffersQueued, buffersProcessed;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_QUEUED,    &buffersQueued);
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_PROCESSED, &buffersProcessed);
+			alGetSourcei(channel.source, AL_BUFFERS_QUEUED,    &buffersQueued);
+			alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
 
 			if (buffersQueued == buffersProcessed)
 				return false;
 		}
 
-		if (_channels[channel]->state != AL_PLAYING)
+		if (channel.state != AL_PLAYING)
 			return true;
 
-		alSourcePlay(_channels[channel]->source);
+		alSourcePlay(channel.source);
 	}
 
 	return true;
@@ -239,72 +281,65 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 	if (!audStream)
 		throw Common::Exception("No audio stream");
 
-	Common::StackLock lock(_mutex);
-
-	ChannelHandle handle = newChannel();
-
-	_channels[handle.channel] = new Channel;
-	Channel &channel = *_channels[handle.channel];
+	// Set up the channel without holding the manager's mutex, since
+	// filling the first buffers means decoding quite a bit of sound
+	ChannelPtr channelPtr(new Channel);
+	Channel &channel = *channelPtr;
 
-	channel.id              = handle.id;
+	channel.id              = 0;
+	channel.index           = 0;
 	channel.state           = AL_PAUSED;
 	channel.stream          = audStream;
 	channel.source          = 0;
+	channel.bufferSize      = 0;
+	channel.bufferCount     = 0;
 	channel.disposeAfterUse = disposeAfterUse;
 	channel.type            = type;
-	channel.typeIt          = _types[channel.type].list.end();
 	channel.gain            = 1.0;
 
+	ChannelHandle handle;
+
 	try {
 
 		if (!channel.stream)
 			throw Common::Exception("Could not detect stream type");
 
-		ALenum error = AL_NO_ERROR;
+		getBufferDimensions(channel.stream->getRate(), channel.stream->getChannels(),
+		                    channel.bufferSize, channel.bufferCount);
 
-		// Create the source
-		alGenSources(1, &channel.source);
-		if ((error = alGetError()) != AL_NO_ERROR)
-			throw Common::Exception("OpenAL error while generating sources: %X", error);
+		channel.scratch.resize(channel.bufferSize / 2);
 
-		// Create all needed buffers
-		for (int i = 0; i < kOpenALBufferCount; i++) {
-			ALuint buffer;
+		channel.source = allocSource();
 
-			alGenBuffers(1, &buffer);
-			if ((error = alGetError()) != AL_NO_ERROR)
-				throw Common::Exception("OpenAL error while generating buffers: %X", error);
+		// Queue the first buffers. Short sounds might not need all of them.
+		queueBuffers(channel);
 
-			if (fillBuffer(channel.source, buffer, channel.stream)) {
-				// If we could fill the buffer with data, queue it
+		Common::StackLock lock(_mutex);
 
-				alSourceQueueBuffers(channel.source, 1, &buffer);
-				if ((error = alGetError()) != AL_NO_ERROR)
-					throw Common::Exception("OpenAL error while queueing buffers: %X", error);
+		handle = newChannel();
 
-			} else
-				// If not, put it into our free list
-				channel.freeBuffers.push_back(buffer);
-
-			channel.buffers.push_back(buffer);
-		}
+		channel.id    = handle.id;
+		channel.index = handle.channel;
 
 		// Set the gain to the current sound type gain
 		alSourcef(channel.source, AL_GAIN, _types[channel.type].gain);
 
-		// Add the channel to the correct type list
-		_types[channel.type].list.push_back(&channel);
-		channel.typeIt = --_types[channel.type].list.end();
+		// Add the channel to the channel table and the correct type list
+		_channels[channel.index] = channelPtr;
+
+		channel.activeIt = _activeChannels.insert(_activeChannels.end(), channelPtr);
+		channel.typeIt   = _types[channel.type].list.insert(_types[channel.type].list.end(), channelPtr);
 
 	} catch (...) {
-		freeChannel(handle);
+		destroyChannel(channel);
 		throw;
 	}
 
 	return handle;
 }
 
-ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type, bool loop) {
+ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type,
+                                          bool loop, const Common::UString &cacheName) {
 	checkReady();
 
 	if (!wavStream)
@@ -312,70 +347,123 @@ ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream,
 
 	AudioStream *audioStream = makeAudioStream(wavStream);
 
-	if (loop) {
+	if (!cacheName.empty()) {
 		RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audioStream);
+		if (reAudStream)
+			audioStream = _sampleCache.add(cacheName, reAudStream);
+	}
+
+	return playSoundStream(audioStream, type, loop, "SoundManager::playSoundFile()");
+}
+
+ChannelHandle SoundManager::playCachedSound(const Common::UString &name, SoundType type, bool loop) {
+	checkReady();
+
+	AudioStream *audioStream = _sampleCache.get(name);
+	if (!audioStream)
+		return ChannelHandle();
+
+	return playSoundStream(audioStream, type, loop, "SoundManager::playCachedSound()");
+}
+
+ChannelHandle SoundManager::playSoundStream(AudioStream *audStream, SoundType type, bool loop,
+                                            const char *caller) {
+
+	if (loop) {
+		RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audStream);
 		if (!reAudStream)
-			warning("SoundManager::playSoundFile(): The input stream cannot be rewound, this will not loop.");
+			warning("%s: The input stream cannot be rewound, this will not loop.", caller);
 		else
-			audioStream = makeLoopingAudioStream(reAudStream, 0);
+			audStream = makeLoopingAudioStream(reAudStream, 0);
 	}
 
-	return playAudioStream(audioStream, type);
+	return playAudioStream(audStream, type);
 }
 
-SoundManager::Channel *SoundManager::getChannel(const ChannelHandle &handle) {
+SoundManager::ChannelPtr SoundManager::getChannel(const ChannelHandle &handle) const {
 	if ((handle.channel == 0) || (handle.id == 0))
-		return 0;
+		return ChannelPtr();
 
-	if (!_channels[handle.channel])
-		return 0;
+	Common::StackLock lock(_mutex);
 
-	if (_channels[handle.channel]->id != handle.id)
-		return 0;
+	const ChannelPtr &channel = _channels[handle.channel];
+	if (!channel || (channel->id != handle.id))
+		return ChannelPtr();
 
-	return _channels[handle.channel];
+	return channel;
 }
 
-void SoundManager::startChannel(ChannelHandle &handle) {
+void SoundManager::getActiveChannels(std::vector<ChannelPtr> &channels) const {
 	Common::StackLock lock(_mutex);
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	channels.reserve(_activeChannels.size());
+	channels.assign(_activeChannels.begin(), _activeChannels.end());
+}
+
+void SoundManager::startChannel(ChannelHandle &handle) {
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
 		throw Common::Exception("Invalid channel");
 
-	channel->state = AL_PLAYING;
+	{
+		Common::StackLock lock(channel->mutex);
+
+		if ((channel->id != handle.id) || !channel->stream)
+			throw Common::Exception("Invalid channel");
+
+		channel->state = AL_PLAYING;
+	}
 
 	triggerUpdate();
 }
 
 void SoundManager::pauseChannel(ChannelHandle &handle, bool pause) {
-	Common::StackLock lock(_mutex);
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
+		throw Common::Exception("Invalid channel");
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	Common::StackLock lock(channel->mutex);
+
+	if ((channel->id != handle.id) || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	pauseChannel(channel, pause);
+	pauseChannel(*channel, pause);
 }
 
 void SoundManager::stopChannel(ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
 	freeChannel(handle);
 }
 
 void SoundManager::pauseAll(bool pause) {
-	Common::StackLock lock(_mutex);
+	std::vector<ChannelPtr> channels;
+	getActiveChannels(channels);
+
+	for (std::vector<ChannelPtr>::iterator c = channels.begin(); c != channels.end(); ++c) {
+		Common::StackLock lock((*c)->mutex);
 
-	for (uint16 i = 1; i < kChannelCount; i++)
-		pauseChannel(_channels[i], pause);
+		pauseChannel(**c, pause);
+	}
 }
 
 void SoundManager::stopAll() {
-	Common::StackLock lock(_mutex);
+	std::vector<ChannelHandle> handles;
+
+	{
+		Common::StackLock lock(_mutex);
 
-	for (uint16 i = 1; i < kChannelCount; i++)
-		freeChannel(i);
+		handles.reserve(_activeChannels.size());
+		for (ChannelList::const_iterator c = _activeChannels.begin(); c != _activeChannels.end(); ++c) {
+			ChannelHandle handle;
+
+			handle.channel = (*c)->index;
+			handle.id      = (*c)->id;
+
+			handles.push_back(handle);
+		}
+	}
+
+	for (std::vector<ChannelHandle>::iterator h = handles.begin(); h != handles.end(); ++h)
+		freeChannel(*h);
 }
 
 void SoundManager::setListenerGain(float gain) {
@@ -387,10 +475,13 @@ void SoundManager::setListenerGain(float gain) {
 }
 
 void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, float y, float z) {
-	Common::StackLock lock(_mutex);
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
+		throw Common::Exception("Invalid channel");
+
+	Common::StackLock lock(channel->mutex);
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if ((channel->id != handle.id) || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	if (channel->stream->getChannels() > 1)
@@ -400,10 +491,13 @@ void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, floa
 }
 
 void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, float &y, float &z) {
-	Common::StackLock lock(_mutex);
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
+		throw Common::Exception("Invalid channel");
+
+	Common::StackLock lock(channel->mutex);
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if ((channel->id != handle.id) || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	if (channel->stream->getChannels() > 1)
@@ -413,22 +507,35 @@ void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, flo
 }
 
 void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
-	Common::StackLock lock(_mutex);
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
+		throw Common::Exception("Invalid channel");
+
+	float typeGain;
+	{
+		Common::StackLock lock(_mutex);
+
+		typeGain = _types[channel->type].gain;
+	}
+
+	Common::StackLock lock(channel->mutex);
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if ((channel->id != handle.id) || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	channel->gain = gain;
 
-	alSourcef(channel->source, AL_GAIN, _types[channel->type].gain * gain);
+	alSourcef(channel->source, AL_GAIN, typeGain * gain);
 }
 
 void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
-	Common::StackLock lock(_mutex);
+	ChannelPtr channel = getChannel(handle);
+	if (!channel)
+		throw Common::Exception("Invalid channel");
+
+	Common::StackLock lock(channel->mutex);
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if ((channel->id != handle.id) || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	alSourcef(channel->source, AL_PITCH, pitch);
@@ -437,20 +544,116 @@ void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
 void SoundManager::setTypeGain(SoundType type, float gain) {
 	assert((type >= 0) && (type < kSoundTypeMAX));
 
-	Common::StackLock lock(_mutex);
+	std::vector<ChannelPtr> channels;
+
+	{
+		Common::StackLock lock(_mutex);
 
-	// Set the new type gain
-	_types[type].gain = gain;
+		// Set the new type gain
+		_types[type].gain = gain;
+
+		channels.assign(_types[type].list.begin(), _types[type].list.end());
+	}
 
 	// Update all currently playing channels of that type
-	for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
-		assert(*t);
+	for (std::vector<ChannelPtr>::iterator c = channels.begin(); c != channels.end(); ++c) {
+		assert(*c);
+
+		Common::StackLock lock((*c)->mutex);
 
-		alSourcef((*t)->source, AL_GAIN, (*t)->gain * gain);
+		if ((*c)->id != 0)
+			alSourcef((*c)->source, AL_GAIN, (*c)->gain * gain);
 	}
 }
 
-bool SoundManager::fillBuffer(ALuint source, ALuint alBuffer, AudioStream *stream) const {
+SampleCache &SoundManager::getSampleCache() {
+	return _sampleCache;
+}
+
+ALuint SoundManager::allocSource() {
+	{
+		Common::StackLock lock(_poolMutex);
+
+		if (!_freeSources.empty()) {
+			const ALuint source = _freeSources.back();
+			_freeSources.pop_back();
+
+			return source;
+		}
+	}
+
+	ALuint source = 0;
+
+	alGenSources(1, &source);
+
+	ALenum error = alGetError();
+	if (error != AL_NO_ERROR)
+		throw Common::Exception("OpenAL error while generating sources: %X", error);
+
+	return source;
+}
+
+ALuint SoundManager::allocBuffer() {
+	{
+		Common::StackLock lock(_poolMutex);
+
+		if (!_freeBuffers.empty()) {
+			const ALuint buffer = _freeBuffers.back();
+			_freeBuffers.pop_back();
+
+			return buffer;
+		}
+	}
+
+	ALuint buffer = 0;
+
+	alGenBuffers(1, &buffer);
+
+	ALenum error = alGetError();
+	if (error != AL_NO_ERROR) {
+		warning("OpenAL error while generating buffers: %X", error);
+		return 0;
+	}
+
+	return buffer;
+}
+
+void SoundManager::releaseSource(ALuint source) {
+	// Stop the source, detach all its buffers and reset what channels might have changed
+	alSourceRewind(source);
+	alSourcei(source, AL_BUFFER, 0);
+
+	alSourcef (source, AL_GAIN    , 1.0);
+	alSourcef (source, AL_PITCH   , 1.0);
+	alSource3f(source, AL_POSITION, 0.0, 0.0, 0.0);
+
+	if (alGetError() == AL_NO_ERROR) {
+		Common::StackLock lock(_poolMutex);
+
+		if (_freeSources.size() < kOpenALPoolSources) {
+			_freeSources.push_back(source);
+			return;
+		}
+	}
+
+	alDeleteSources(1, &source);
+}
+
+void SoundManager::releaseBuffer(ALuint buffer) {
+	{
+		Common::StackLock lock(_poolMutex);
+
+		if (_freeBuffers.size() < kOpenALPoolBuffers) {
+			_freeBuffers.push_back(buffer);
+			return;
+		}
+	}
+
+	alDeleteBuffers(1, &buffer);
+}
+
+bool SoundManager::fillBuffer(Channel &channel, ALuint alBuffer) const {
+	AudioStream *stream = channel.stream;
 	if (!stream)
 		throw Common::Exception("No stream");
 
@@ -478,17 +681,11 @@ bool SoundManager::fillBuffer(ALuint source, ALuint alBuffer, AudioStream *strea
 	}
 
 	// Read in the required amount of samples
-	uint32 numSamples = kOpenALBufferSize / 2;
-
-	byte *buffer = new byte[kOpenALBufferSize];
-	memset(buffer, 0, kOpenALBufferSize);
-	numSamples = stream->readBuffer((int16 *)buffer, numSamples);
-
-	uint32 bufferSize = numSamples * 2;
-
-	alBufferData(alBuffer, format, buffer, bufferSize, stream->getRate());
+	const int readSamples = stream->readBuffer(&channel.scratch[0], channel.scratch.size());
+	if (readSamples <= 0)
+		return false;
 
-	delete[] buffer;
+	alBufferData(alBuffer, format, &channel.scratch[0], readSamples * 2, stream->getRate());
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -499,11 +696,37 @@ bool SoundManager::fillBuffer(ALuint source, ALuint alBuffer, AudioStream *strea
 	return true;
 }
 
-void SoundManager::bufferData(uint16 channel) {
-	if ((channel == 0) || !_channels[channel])
-		return;
+void SoundManager::queueBuffers(Channel &channel) {
+	// Buffer as long as we still have data and free buffers
+	while (!channel.stream->endOfData()) {
+		if (channel.freeBuffers.empty()) {
+			// Get another buffer, if the channel may have more
+			if (channel.buffers.size() >= channel.bufferCount)
+				break;
+
+			const ALuint buffer = allocBuffer();
+			if (buffer == 0)
+				break;
+
+			channel.buffers.push_back(buffer);
+			channel.freeBuffers.push_back(buffer);
+		}
+
+		ALuint buffer = channel.freeBuffers.front();
+
+		if (!fillBuffer(channel, buffer))
+			break;
 
-	bufferData(*_channels[channel]);
+		alSourceQueueBuffers(channel.source, 1, &buffer);
+
+		ALenum error = alGetError();
+		if (error != AL_NO_ERROR) {
+			warning("OpenAL error while queueing buffers: 0x%X", error);
+			break;
+		}
+
+		channel.freeBuffers.pop_front();
+	}
 }
 
 void SoundManager::bufferData(Channel &channel) {
@@ -523,16 +746,7 @@ void SoundManager::bufferData(Channel &channel) {
 		channel.freeBuffers.push_back(alBuffer);
 	}
 
-	// Buffer as long as we still have data and free buffers
-	std::list<ALuint>::iterator buffer = channel.freeBuffers.begin();
-	while (buffer != channel.freeBuffers.end()) {
-		if (!fillBuffer(channel.source, *buffer, channel.stream))
-			break;
-
-		alSourceQueueBuffers(channel.source, 1, &*buffer);
-
-		buffer = channel.freeBuffers.erase(buffer);
-	}
+	queueBuffers(channel);
 }
 
 void SoundManager::checkReady() {
@@ -541,42 +755,47 @@ void SoundManager::checkReady() {
 }
 
 void SoundManager::update() {
-	Common::StackLock lock(_mutex);
+	// Only hold the manager's mutex while looking at the channel list, so
+	// that buffering doesn't block anybody wanting to play a new sound
+	std::vector<ChannelPtr> channels;
+	getActiveChannels(channels);
 
-	for (int i = 1; i < kChannelCount; i++) {
-		if (!_channels[i])
-			continue;
+	for (std::vector<ChannelPtr>::iterator c = channels.begin(); c != channels.end(); ++c) {
+		ChannelHandle handle;
 
-		// Free the channel if it is no longer playing
-		if (!isPlaying(i)) {
-			freeChannel(i);
-			continue;
-		}
+		{
+			Common::StackLock lock((*c)->mutex);
 
-		// Try to buffer some more data
-		bufferData(i);
-	}
-}
+			if ((*c)->id == 0)
+				// Freed in the meantime
+				continue;
 
-ChannelHandle SoundManager::newChannel() {
-	uint16 foundChannel = 0;
+			if (isPlaying(**c)) {
+				// Try to buffer some more data
+				bufferData(**c);
+				continue;
+			}
 
-	for (int i = 0; (i < kChannelCount) && !foundChannel; i++) {
-		if (!_channels[i])
-			foundChannel = i;
+			handle.channel = (*c)->index;
+			handle.id      = (*c)->id;
+		}
 
-		// Channel 0 is reserved for "invalid channel"
-		_curChannel = (_curChannel >= kChannelCount) ? 1 : (_curChannel + 1);
+		// Free the channel if it is no longer playing
+		freeChannel(handle);
 	}
+}
 
-	if (!foundChannel)
+ChannelHandle SoundManager::newChannel() {
+	if (_freeChannels.empty())
 		throw Common::Exception("All sound channels occupied");
 
 	ChannelHandle handle;
 
-	handle.channel = foundChannel;
+	handle.channel = _freeChannels.back();
 	handle.id      = _curID++;
 
+	_freeChannels.pop_back();
+
 	// ID 0 is reserved for "invalid ID"
 	if (_curID == 0)
 		_curID++;
@@ -584,62 +803,74 @@ ChannelHandle SoundManager::newChannel() {
 	return handle;
 }
 
-void SoundManager::pauseChannel(Channel *channel, bool pause) {
-	if (!channel || channel->id == 0)
+void SoundManager::pauseChannel(Channel &channel, bool pause) {
+	if (channel.id == 0)
 		return;
 
 	ALenum error = AL_NO_ERROR;
 	if (pause) {
-		alSourcePause(channel->source);
+		alSourcePause(channel.source);
 		if ((error = alGetError()) != AL_NO_ERROR)
 			warning("OpenAL error while attempting to pause: %X", error);
 
-		channel->state = AL_PAUSED;
+		channel.state = AL_PAUSED;
 	} else
-		channel->state = AL_PLAYING;
+		channel.state = AL_PLAYING;
 
 	triggerUpdate();
 }
 
 void SoundManager::freeChannel(ChannelHandle &handle) {
-	if ((handle.channel != 0) && (handle.id != 0) && _channels[handle.channel])
-		// Only free if there is a channel to free
-		if (handle.id == _channels[handle.channel]->id)
-			// Only free if the IDs match
-			freeChannel(handle.channel);
+	ChannelPtr channel;
+
+	if ((handle.channel != 0) && (handle.id != 0)) {
+		Common::StackLock lock(_mutex);
+
+		// Only free if there is a channel to free and the IDs match
+		if (_channels[handle.channel] && (_channels[handle.channel]->id == handle.id)) {
+			channel = _channels[handle.channel];
+
+			// Remove the channel from the channel table and the lists
+			_types[channel->type].list.erase(channel->typeIt);
+			_activeChannels.erase(channel->activeIt);
+
+			_channels[handle.channel].reset();
+			_freeChannels.push_back(handle.channel);
+		}
+	}
 
 	handle.channel = 0;
 	handle.id      = 0;
-}
 
-void SoundManager::freeChannel(uint16 channel) {
-	if (channel == 0)
+	if (!channel)
 		return;
 
-	Channel *c = _channels[channel];
-	if (!c)
-		// Nothing to do
-		return;
+	// Wait until nobody else is using the channel, then release it.
+	// The channel itself goes away with its last reference.
+	Common::StackLock lock(channel->mutex);
+
+	destroyChannel(*channel);
+}
 
+void SoundManager::destroyChannel(Channel &channel) {
 	// Discard the stream, if requested
-	if (c->disposeAfterUse)
-		delete c->stream;
+	if (channel.disposeAfterUse)
+		delete channel.stream;
 
-	// Delete the channel's OpenAL source
-	if (c->source)
-		alDeleteSources(1, &c->source);
+	// Give the channel's OpenAL source back, which also unqueues all buffers
+	if (channel.source)
+		releaseSource(channel.source);
 
-	// Delete the OpenAL buffers
-	for (std::list<ALuint>::iterator buffer = c->buffers.begin(); buffer != c->buffers.end(); ++buffer)
-		alDeleteBuffers(1, &*buffer);
+	// Give the OpenAL buffers back
+	for (std::list<ALuint>::iterator buffer = channel.buffers.begin(); buffer != channel.buffers.end(); ++buffer)
+		releaseBuffer(*buffer);
 
-	// Remove the channel from the type list
-	if (c->typeIt != _types[c->type].list.end())
-		_types[c->type].list.erase(c->typeIt);
+	channel.id     = 0;
+	channel.stream = 0;
+	channel.source = 0;
 
-	// And finally delete the channel itself
-	delete c;
-	_channels[channel] = 0;
+	channel.buffers.clear();
+	channel.freeBuffers.clear();
 }
 
 void SoundManager::threadMethod() {
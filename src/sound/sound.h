@@ -43,12 +43,16 @@
 #include <vector>
 #include <list>
 
+#include "boost/shared_ptr.hpp"
+
 #include "common/types.h"
+#include "common/ustring.h"
 #include "common/singleton.h"
 #include "common/thread.h"
 #include "common/mutex.h"
 
 #include "sound/types.h"
+#include "sound/samplecache.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -90,13 +94,32 @@ public:
 	 *  This only allocate a channel for the sound, to actually start playing it,
 	 *  call startChannel().
 	 *
+	 *  If a cache name is given, a short enough sound is decoded completely
+	 *  and added to the sample cache under that name.
+	 *
 	 *  @param  wavStream The stream to play. Will be taken over.
 	 *  @param  type The type of the sound.
 	 *  @param  loop Should the sound loop?
+	 *  @param  cacheName The name to cache the sound's samples under.
 	 *  @return The channel the sound has been assigned to, or -1 on error.
 	 */
 	ChannelHandle playSoundFile(Common::SeekableReadStream *wavStream,
-	                            SoundType type, bool loop = false);
+	                            SoundType type, bool loop = false,
+	                            const Common::UString &cacheName = "");
+
+	/** Play a sound from the sample cache.
+	 *
+	 *  This only allocate a channel for the sound, to actually start playing it,
+	 *  call startChannel().
+	 *
+	 *  @param  name The name the sound was cached under.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or an invalid
+	 *          channel if the sound isn't cached.
+	 */
+	ChannelHandle playCachedSound(const Common::UString &name,
+	                              SoundType type, bool loop = false);
 
 	/** Play an audio stream.
 	 *
@@ -159,21 +182,32 @@ public:
 	/** Set the gain/volume of all channels of a specific type. */
 	void setTypeGain(SoundType type, float gain);
 
+
+	/** Return the cache of decoded short sounds. */
+	SampleCache &getSampleCache();
+
 private:
 	static const int kChannelCount = 65535; ///< Maximal number of channels.
 
 	struct Channel;
-	typedef std::list<Channel *> TypeList;
+	typedef boost::shared_ptr<Channel> ChannelPtr;
+	typedef std::list<ChannelPtr> ChannelList;
 
 	/** A sound type. */
 	struct Type {
-		float    gain; ///< The sound type's current gain.
-		TypeList list; ///< The list of channels for that type.
+		float       gain; ///< The sound type's current gain.
+		ChannelList list; ///< The list of channels for that type.
 	};
 
-	/** A sound channel. */
+	/** A sound channel.
+	 *
+	 *  The channel's sound state is protected by the channel's own mutex,
+	 *  so that buffering one channel doesn't block the others. A channel
+	 *  that has been freed while still referenced somewhere has an ID of 0.
+	 */
 	struct Channel {
-		uint32 id; ///< The channel's ID.
+		uint32 id;    ///< The channel's ID.
+		uint16 index; ///< The channel's slot in the channel table.
 
 		ALint state; ///< The sound's state.
 
@@ -185,10 +219,20 @@ private:
 		std::list<ALuint> buffers;     ///< List of buffers for that channel.
 		std::list<ALuint> freeBuffers; ///< List of free buffers not filled with data.
 
-		SoundType type;            ///< The channel's sound type.
-		TypeList::iterator typeIt; ///< Iterator into the type list.
+		uint32 bufferSize;  ///< Size of each buffer, in bytes.
+		uint32 bufferCount; ///< Maximum number of buffers for that channel.
+
+		/** Space to decode one buffer's worth of sound into. */
+		std::vector<int16> scratch;
+
+		SoundType type; ///< The channel's sound type.
 
 		float gain; ///< The channel's gain.
+
+		ChannelList::iterator typeIt;   ///< Iterator into the type list.
+		ChannelList::iterator activeIt; ///< Iterator into the active channel list.
+
+		Common::Mutex mutex; ///< Mutex protecting the channel's sound state.
 	};
 
 	bool _ready; ///< Was the sound subsystem successfully initialized?
@@ -196,13 +240,24 @@ private:
 	bool _hasMultiChannel; ///< Do we have the multi-channel extension?
 	ALenum _format51; ///< The value for the 5.1 multi-channel format.
 
-	Channel *_channels[kChannelCount]; ///< The sound channels.
-	Type     _types   [kSoundTypeMAX]; ///< The sound types.
+	ChannelPtr _channels[kChannelCount]; ///< The sound channels.
+	Type       _types   [kSoundTypeMAX]; ///< The sound types.
+
+	ChannelList         _activeChannels; ///< All channels currently in use.
+	std::vector<uint16> _freeChannels;   ///< All unused slots in the channel table.
+
+	SampleCache _sampleCache; ///< Decoded samples of short, often played sounds.
 
-	uint16 _curChannel; ///< Position to start looking for a free channel.
-	uint32 _curID;      ///< The ID the next sound will get.
+	std::vector<ALuint> _freeSources; ///< Unused OpenAL sources, ready for reuse.
+	std::vector<ALuint> _freeBuffers; ///< Unused OpenAL buffers, ready for reuse.
 
-	Common::Mutex _mutex;
+	/** Mutex protecting the unused OpenAL sources and buffers. */
+	Common::Mutex _poolMutex;
+
+	uint32 _curID; ///< The ID the next sound will get.
+
+	/** Mutex protecting the channel table, the channel lists and the types. */
+	mutable Common::Mutex _mutex;
 
 	/** Condition to signal that an update is needed. */
 	Common::Condition _needUpdate;
@@ -216,34 +271,52 @@ private:
 	/** Update the sound information. Called regularily from within the thread method. */
 	void update();
 
-	/** Look for a free place in the channel vector. */
+	/** Take a free place in the channel table. */
 	ChannelHandle newChannel();
 
+	/** Return the channel the handle refers to. */
+	ChannelPtr getChannel(const ChannelHandle &handle) const;
+	/** Return all channels currently in use. */
+	void getActiveChannels(std::vector<ChannelPtr> &channels) const;
+
 	/** Buffer more sound from the channel to the OpenAL buffers. */
 	void bufferData(Channel &channel);
-	/** Buffer more sound from the channel to the OpenAL buffers. */
-	void bufferData(uint16 channel);
 
 	/** Is that channel currently playing a sound? */
-	bool isPlaying(uint16 channel) const;
+	bool isPlaying(Channel &channel) const;
 
 	/** Pause/Unpause a channel. */
-	void pauseChannel(Channel *channel, bool pause);
+	void pauseChannel(Channel &channel, bool pause);
 
 	/** Stop and free a channel. */
 	void freeChannel(ChannelHandle &handle);
-	/** Stop and free a channel. */
-	void freeChannel(uint16 channel);
 
-	/** Return the channel the handle refers to. */
-	Channel *getChannel(const ChannelHandle &handle);
+	/** Release the channel's stream and OpenAL objects. */
+	void destroyChannel(Channel &channel);
 
 	void threadMethod();
 
 	static AudioStream *makeAudioStream(Common::SeekableReadStream *stream);
 
-	/** Fill the buffer with data from the audio stream. */
-	bool fillBuffer(ALuint source, ALuint alBuffer, AudioStream *stream) const;
+	/** Allocate a channel for an audio stream, looping it if requested. */
+	ChannelHandle playSoundStream(AudioStream *audStream, SoundType type, bool loop,
+	                              const char *caller);
+
+	/** Get an OpenAL source, reusing an unused one if possible. */
+	ALuint allocSource();
+	/** Get an OpenAL buffer, reusing an unused one if possible. Returns 0 on error. */
+	ALuint allocBuffer();
+
+	/** Give back an OpenAL source no longer needed. */
+	void releaseSource(ALuint source);
+	/** Give back an OpenAL buffer no longer needed. */
+	void releaseBuffer(ALuint buffer);
+
+	/** Fill the buffer with data from the channel's audio stream. */
+	bool fillBuffer(Channel &channel, ALuint alBuffer) const;
+
+	/** Fill and queue buffers for the channel, creating new ones if necessary. */
+	void queueBuffers(Channel &channel);
 };
 
 } // End of namespace Sound
@@ -192,8 +192,7 @@ void Bink::processData() {
 			throw Common::Exception("Audio packet too big for the frame");
 
 		if (audioPacketLength >= 4) {
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
+			uint32 audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			if (i == _audioTrack) {
 				// Only play one audio track
@@ -201,9 +200,7 @@ void Bink::processData() {
 				//                  Number of samples in bytes
 				audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-				audio.bits =
-					new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					    audioPacketStart + 4, audioPacketEnd), true);
+				audio.bits = new Common::BitStreamMemory32LELSB(*_bink, audioPacketEnd - _bink->pos());
 
 				audioPacket(audio);
 
@@ -217,12 +214,7 @@ void Bink::processData() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-		    videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::BitStreamMemory32LELSB(*_bink, frameSize);
 
 	videoPacket(frame);
 
@@ -283,7 +275,7 @@ void Bink::videoPacket(VideoFrame &video) {
 	assert(_surface && _curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
 	Graphics::convertYUVA420ToRGBA(_surface->getData(), _surface->getWidth() * 4,
 			_curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-			_width, _height, _width, _width >> 1);
+			_width, _height, _width, _width >> 1, _yuvBuffer);
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
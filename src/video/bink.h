@@ -37,6 +37,8 @@
 
 #include "common/types.h"
 
+#include "graphics/yuv_to_rgb.h"
+
 #include "video/decoder.h"
 
 namespace Common {
@@ -234,6 +236,8 @@ private:
 	byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 	byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+	Graphics::YUVToRGBBuffer _yuvBuffer; ///< Scratch memory for converting the planes.
+
 	/** Load a Bink file. */
 	void load();
 
@@ -100,7 +100,7 @@ void H263Codec::decodeFrame(Graphics::Surface &surface, Common::SeekableReadStre
 				(const byte *) xvid_dec_frame.output.plane[0],
 				(const byte *) xvid_dec_frame.output.plane[1],
 				(const byte *) xvid_dec_frame.output.plane[2], _width, _height,
-				xvid_dec_frame.output.stride[0], xvid_dec_frame.output.stride[1]);
+				xvid_dec_frame.output.stride[0], xvid_dec_frame.output.stride[1], _yuvBuffer);
 }
 
 } // End of namespace Video
@@ -32,6 +32,8 @@
 
 #include "common/types.h"
 
+#include "graphics/yuv_to_rgb.h"
+
 #include "video/codecs/codec.h"
 
 namespace Video {
@@ -48,6 +50,8 @@ private:
 	uint32 _height;
 
 	void *_decHandle;
+
+	Graphics::YUVToRGBBuffer _yuvBuffer; ///< Scratch memory for converting the decoded planes.
 };
 
 } // End of namespace Video
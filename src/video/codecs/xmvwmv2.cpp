@@ -319,7 +319,7 @@ void XMVWMV2Codec::init() {
 void XMVWMV2Codec::decodeFrame(Graphics::Surface &surface,
                                Common::SeekableReadStream &dataStream) {
 
-	Common::BitStream32LEMSB bits(dataStream);
+	Common::BitStreamMemory32LEMSB bits(dataStream);
 	DecodeContext            ctx(bits);
 
 	initDecodeContext(ctx);
@@ -352,7 +352,7 @@ void XMVWMV2Codec::decodeFrame(Graphics::Surface &surface,
 	// Convert the YUV data we have to BGRA
 	Graphics::convertYUV420ToRGBA(surface.getData(), surface.getWidth() * 4,
 			_curPlanes[0], _curPlanes[1], _curPlanes[2],
-			_lumaWidth, _lumaHeight, _lumaWidth, _chromaWidth);
+			_lumaWidth, _lumaHeight, _lumaWidth, _chromaWidth, _yuvBuffer);
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 3; i++)
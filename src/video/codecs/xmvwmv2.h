@@ -32,6 +32,8 @@
 
 #include "common/types.h"
 
+#include "graphics/yuv_to_rgb.h"
+
 #include "video/codecs/codec.h"
 
 namespace Common {
@@ -170,6 +172,8 @@ private:
 	byte *_curPlanes[3]; ///< The 3 color planes, YUV, current frame.
 	byte *_oldPlanes[3]; ///< The 3 color planes, YUV, last frame.
 
+	Graphics::YUVToRGBBuffer _yuvBuffer; ///< Scratch memory for converting the planes.
+
 	// Decoder flags
 
 	bool _hasMixedPelMC;      ///< Does the video have mixed pel motion compensation?
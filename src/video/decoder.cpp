@@ -32,6 +32,9 @@
 #include "common/error.h"
 #include "common/stream.h"
 #include "common/threads.h"
+#include "common/util.h"
+
+#include "events/events.h"
 
 #include "graphics/graphics.h"
 
@@ -51,6 +54,11 @@ VideoDecoder::VideoDecoder() : Renderable(Graphics::kRenderableTypeVideo),
 	_textureWidth(0.0), _textureHeight(0.0), _scale(kScaleNone),
 	_sound(0), _soundRate(0), _soundFlags(0) {
 
+	for (int i = 0; i < kSurfaceCount; i++) {
+		_frames[i].surface = 0;
+		_frames[i].buffer  = 0;
+		_frames[i].mapped  = false;
+	}
 }
 
 VideoDecoder::~VideoDecoder() {
@@ -59,12 +67,26 @@ VideoDecoder::~VideoDecoder() {
 	if (_texture != 0)
 		GfxMan.abandon(&_texture, 1);
 
-	delete _surface;
+	Graphics::BufferID buffers[kSurfaceCount];
+	uint32 bufferCount = 0;
+
+	for (int i = 0; i < kSurfaceCount; i++)
+		if (_frames[i].buffer != 0)
+			buffers[bufferCount++] = _frames[i].buffer;
+
+	// Deleting the buffers implicitly unmaps them
+	if (bufferCount > 0)
+		GfxMan.abandonBuffers(buffers, bufferCount);
+
+	deleteSurfaces();
 
 	deinitSound();
 }
 
 void VideoDecoder::deinit() {
+	// Make sure the decoding thread doesn't touch the subclass anymore
+	destroyThread();
+
 	hide();
 
 	GLContainer::removeFromQueue(Graphics::kQueueGLContainer);
@@ -82,14 +104,85 @@ void VideoDecoder::initVideo(uint32 width, uint32 height) {
 	_textureWidth  = ((float) _width ) / ((float) realWidth );
 	_textureHeight = ((float) _height) / ((float) realHeight);
 
-	delete _surface;
-	_surface = new Graphics::Surface(realWidth, realHeight);
+	deleteSurfaces();
 
-	_surface->fill(0, 0, 0, 0);
+	for (int i = 0; i < kSurfaceCount; i++) {
+		_frames[i].surface = new Graphics::Surface(realWidth, realHeight);
+
+		_frames[i].surface->fill(0, 0, 0, 0);
+	}
+
+	Graphics::Surface *surfaces[kSurfaceCount];
+	for (int i = 0; i < kSurfaceCount; i++)
+		surfaces[i] = _frames[i].surface;
+
+	_frameQueue.init(surfaces, kSurfaceCount);
+
+	_surface = _frameQueue.getDecoding();
 
 	rebuild();
 }
 
+void VideoDecoder::deleteSurfaces() {
+	// A still mapped buffer is unmapped once it's rebuilt or deleted
+	for (int i = 0; i < kSurfaceCount; i++) {
+		delete _frames[i].surface;
+
+		_frames[i].surface = 0;
+	}
+
+	_surface = 0;
+
+	_frameQueue.clear();
+}
+
+VideoDecoder::Frame &VideoDecoder::getFrame(const Graphics::Surface *surface) {
+	for (int i = 0; i < kSurfaceCount; i++)
+		if (_frames[i].surface == surface)
+			return _frames[i];
+
+	throw Common::Exception("Video surface without a frame");
+}
+
+void VideoDecoder::mapFrame(Frame &frame) {
+	if (frame.buffer == 0)
+		return;
+
+	if (frame.mapped)
+		unmapFrame(frame);
+
+	const uint32 size = frame.surface->getWidth() * frame.surface->getHeight() * 4;
+
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, frame.buffer);
+
+	// Orphan the old storage, so that we don't wait for a pending upload from it
+	glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, 0, GL_STREAM_DRAW_ARB);
+
+	byte *data = (byte *) glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+	// If mapping failed, the surface just keeps using its own memory
+	frame.surface->setExternalData(data);
+	frame.mapped = data != 0;
+}
+
+bool VideoDecoder::unmapFrame(Frame &frame) {
+	if (!frame.mapped)
+		return true;
+
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, frame.buffer);
+	bool intact = glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB) == GL_TRUE;
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+	if (frame.surface)
+		frame.surface->setExternalData(0);
+
+	frame.mapped = false;
+
+	return intact;
+}
+
 void VideoDecoder::initSound(uint16 rate, int channels, bool is16) {
 	deinitSound();
 
@@ -156,11 +249,18 @@ uint32 VideoDecoder::getNumQueuedStreams() const {
 }
 
 void VideoDecoder::doRebuild() {
-	if (!_surface)
+	Graphics::Surface *shown = _frameQueue.getShown();
+	if (!shown)
 		return;
 
+	// Keep the decoding thread away from the surfaces while we remap them
+	Common::StackLock decodeLock(_decodeMutex);
+
+	Graphics::Surface *ready = _frameQueue.getReady();
+
 	// Generate the texture ID
-	glGenTextures(1, &_texture);
+	if (_texture == 0)
+		glGenTextures(1, &_texture);
 
 	glBindTexture(GL_TEXTURE_2D, _texture);
 
@@ -172,11 +272,47 @@ void VideoDecoder::doRebuild() {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _surface->getWidth(), _surface->getHeight(),
-	             0, GL_BGRA, GL_UNSIGNED_BYTE, _surface->getData());
+	// The shown frame is never mapped. With pixel buffers, its latest
+	// pixels only lived in the texture, though, so this can be an older
+	// frame until the next one is decoded.
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, shown->getWidth(), shown->getHeight(),
+	             0, GL_BGRA, GL_UNSIGNED_BYTE, shown->getData());
+
+	if (!GfxMan.supportPixelBuffers())
+		return;
+
+	for (int i = 0; i < kSurfaceCount; i++) {
+		if (_frames[i].buffer == 0)
+			glGenBuffersARB(1, &_frames[i].buffer);
+
+		// Leave the ready frame alone, its pixels still wait to be shown
+		if (_frames[i].surface == ready)
+			continue;
+
+		if (_frames[i].surface == shown)
+			unmapFrame(_frames[i]);
+		else
+			mapFrame(_frames[i]);
+	}
 }
 
 void VideoDecoder::doDestroy() {
+	Common::StackLock decodeLock(_decodeMutex);
+
+	for (int i = 0; i < kSurfaceCount; i++) {
+		if (_frames[i].buffer == 0)
+			continue;
+
+		// The ready frame's pixels go away with its buffer, so drop it
+		if (_frames[i].mapped && (_frames[i].surface == _frameQueue.getReady()))
+			_frameQueue.dropReady();
+
+		unmapFrame(_frames[i]);
+
+		glDeleteBuffersARB(1, &_frames[i].buffer);
+		_frames[i].buffer = 0;
+	}
+
 	if (_texture == 0)
 		return;
 
@@ -185,20 +321,36 @@ void VideoDecoder::doDestroy() {
 	_texture = 0;
 }
 
-void VideoDecoder::copyData() {
-	if (!_needCopy)
-		return;
-
-	if (!_surface)
-		throw Common::Exception("No video data while trying to copy");
+bool VideoDecoder::copyData(Graphics::Surface &surface) {
 	if (_texture == 0)
 		throw Common::Exception("No texture while trying to copy");
 
+	Frame &frame = getFrame(&surface);
+
+	bool fromBuffer = frame.mapped;
+
+	// The frame has been decoded straight into the pixel buffer. Unmap it,
+	// and let the driver copy it into the texture asynchronously. If the
+	// buffer's content got lost in the meantime, the frame is unusable.
+	if (!unmapFrame(frame))
+		return false;
+
 	glBindTexture(GL_TEXTURE_2D, _texture);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _surface->getWidth(), _surface->getHeight(),
-	                GL_BGRA, GL_UNSIGNED_BYTE, _surface->getData());
 
-	_needCopy = false;
+	// Only upload the part of the surface the video actually covers
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, surface.getWidth());
+
+	if (fromBuffer) {
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, frame.buffer);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _width, _height, GL_BGRA, GL_UNSIGNED_BYTE, 0);
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	} else
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _width, _height,
+		                GL_BGRA, GL_UNSIGNED_BYTE, surface.getData());
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	return true;
 }
 
 void VideoDecoder::setScale(Scale scale) {
@@ -210,11 +362,59 @@ bool VideoDecoder::isPlaying() const {
 }
 
 void VideoDecoder::update() {
-	if (getTimeToNextFrame() > 0)
+	// The decoding thread goes on with a free surface while we upload this one
+	Graphics::Surface *frame = _frameQueue.takeReady();
+	if (!frame)
 		return;
 
+	if (!copyData(*frame)) {
+		// Drop the corrupted frame and keep showing the old one, while
+		// the decoding thread decodes the next frame into a fresh buffer
+		mapFrame(getFrame(frame));
+
+		_frameQueue.release(frame);
+		return;
+	}
+
+	Graphics::Surface *shown = _frameQueue.show(frame);
+
+	// Get the previous frame's pixel buffer ready for decoding into again
+	mapFrame(getFrame(shown));
+
+	_frameQueue.release(shown);
+}
+
+void VideoDecoder::decodeFrame() {
+	Common::StackLock decodeLock(_decodeMutex);
+
 	processData();
-	copyData();
+
+	if (!_needCopy)
+		return;
+
+	_needCopy = false;
+
+	_surface = _frameQueue.finishDecoding();
+}
+
+void VideoDecoder::threadMethod() {
+	while (!_killThread && !_finished) {
+		uint32 timeToNextFrame = getTimeToNextFrame();
+		if (timeToNextFrame > 0) {
+			// Wait for the next frame, but stay responsive
+			EventMan.delay(MIN<uint32>(timeToNextFrame, 10));
+			continue;
+		}
+
+		try {
+			decodeFrame();
+		} catch (Common::Exception &e) {
+			Common::printException(e, "WARNING: ");
+			finish();
+		} catch (...) {
+			finish();
+		}
+	}
 }
 
 void VideoDecoder::getQuadDimensions(float &width, float &height) const {
@@ -257,7 +457,7 @@ void VideoDecoder::render(Graphics::RenderPass pass) {
 	if (!isPlaying() || !_started || (_texture == 0))
 		return;
 
-	// Process and copy the next frame data, if necessary
+	// Copy the newest decoded frame, if there is one
 	update();
 
 	// Get the dimensions of the video surface we want, depending on the scaling requested
@@ -291,6 +491,9 @@ void VideoDecoder::finish() {
 void VideoDecoder::start() {
 	startVideo();
 
+	if (!createThread())
+		throw Common::Exception("Failed to create the video decoding thread");
+
 	show();
 }
 
@@ -30,7 +30,11 @@
 #ifndef VIDEO_DECODER_H
 #define VIDEO_DECODER_H
 
+#include <vector>
+
 #include "common/types.h"
+#include "common/thread.h"
+#include "common/mutex.h"
 
 #include "graphics/types.h"
 #include "graphics/glcontainer.h"
@@ -38,6 +42,8 @@
 
 #include "sound/types.h"
 
+#include "video/framequeue.h"
+
 namespace Graphics {
 	class Surface;
 }
@@ -49,8 +55,17 @@ namespace Sound {
 
 namespace Video {
 
-/** A generic interface for video decoders. */
-class VideoDecoder : public Graphics::GLContainer, public Graphics::Renderable {
+/** A generic interface for video decoders.
+ *
+ *  The video's frames are decoded in a separate thread, ahead of the
+ *  render thread. The render thread only uploads the newest frame.
+ *
+ *  If pixel buffer objects are available, the frames are decoded straight
+ *  into mapped pixel buffers, and the texture is updated from them without
+ *  stalling the render thread.
+ */
+class VideoDecoder : public Graphics::GLContainer, public Graphics::Renderable,
+                     public Common::Thread {
 public:
 	enum Scale {
 		kScaleNone,  ///< Don't scale the video.
@@ -83,12 +98,12 @@ public:
 protected:
 	bool _started;  ///< Has playback started?
 	bool _finished; ///< Has playback finished?
-	bool _needCopy; ///< Is new frame content available that needs to by copied?
+	bool _needCopy; ///< Has a new frame been decoded into the surface?
 
 	uint32 _width;  ///< The video's width.
 	uint32 _height; ///< The video's height.
 
-	Graphics::Surface *_surface; ///< The video's surface.
+	Graphics::Surface *_surface; ///< The video's surface, the next frame is decoded into.
 
 	/** Create a surface for video of these dimensions.
 	 *
@@ -99,6 +114,11 @@ protected:
 	 *  width and height will be stored in _width and _height.
 	 *
 	 *  The surface's pixel format is always BGRA8888.
+	 *
+	 *  After each decoded frame, the surface is handed over to the render
+	 *  thread and _surface is replaced by another one of the same dimensions.
+	 *  The content of the new surface is undefined. Its memory might be
+	 *  write-combined, so it should be written but not read.
 	 */
 	void initVideo(uint32 width, uint32 height);
 
@@ -114,7 +134,7 @@ protected:
 
 	/** Start the video processing. */
 	virtual void startVideo() = 0;
-	/** Process the video's image and sound data further. */
+	/** Process the video's image and sound data further. Called from within the decoding thread. */
 	virtual void processData() = 0;
 
 	void finish();
@@ -133,6 +153,24 @@ private:
 
 	Scale _scale;
 
+	/** How many surfaces to cycle through: decoding, ready, uploading and shown. */
+	static const int kSurfaceCount = FrameQueue::kMinSurfaceCount;
+
+	/** A surface to decode into, and the pixel buffer backing it. */
+	struct Frame {
+		Graphics::Surface *surface;
+		Graphics::BufferID buffer; ///< The pixel buffer object, or 0 if there is none.
+		bool mapped;               ///< Does the surface currently use the mapped buffer?
+	};
+
+	Frame _frames[kSurfaceCount];
+
+	/** The surfaces' way from the decoding thread to the texture. */
+	FrameQueue _frameQueue;
+
+	/** Mutex held while a frame is decoded into _surface. */
+	Common::Mutex _decodeMutex;
+
 	Sound::QueuingAudioStream *_sound;
 	Sound::ChannelHandle       _soundHandle;
 	uint16                     _soundRate;
@@ -142,8 +180,28 @@ private:
 	/** Update the video, if necessary. */
 	void update();
 
-	/** Copy the video image data to the texture. */
-	void copyData();
+	/** Decode the next frame and hand it over to the render thread. */
+	void decodeFrame();
+
+	/** Copy the video image data to the texture.
+	 *
+	 *  Returns false if the frame's pixel buffer got corrupted and nothing was copied.
+	 */
+	bool copyData(Graphics::Surface &surface);
+
+	void deleteSurfaces();
+
+	Frame &getFrame(const Graphics::Surface *surface);
+
+	/** Map the frame's pixel buffer and let its surface use it. */
+	void mapFrame(Frame &frame);
+	/** Unmap the frame's pixel buffer, switching its surface back to its own memory.
+	 *
+	 *  Returns false if the buffer's content got corrupted while it was mapped.
+	 */
+	bool unmapFrame(Frame &frame);
+
+	void threadMethod();
 
 	/** Get the dimensions of the quad to draw the texture on. */
 	void getQuadDimensions(float &width, float &height) const;
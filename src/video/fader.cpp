@@ -42,6 +42,7 @@ Fader::Fader(uint32 width, uint32 height, int n) : _c(0), _n(n), _lastUpdate(0)
 }
 
 Fader::~Fader() {
+	VideoDecoder::deinit();
 }
 
 bool Fader::hasTime() const {
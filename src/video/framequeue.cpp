@@ -0,0 +1,130 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file video/framequeue.cpp
+ *  Handing decoded video frames over to the render thread.
+ */
+
+#include <cassert>
+
+#include "video/framequeue.h"
+
+namespace Video {
+
+FrameQueue::FrameQueue() : _decoding(0), _ready(0), _shown(0) {
+}
+
+FrameQueue::~FrameQueue() {
+}
+
+void FrameQueue::init(Graphics::Surface * const *surfaces, uint32 count) {
+	assert(count >= kMinSurfaceCount);
+
+	Common::StackLock lock(_mutex);
+
+	_decoding = surfaces[0];
+	_shown    = surfaces[1];
+	_ready    = 0;
+
+	_free.assign(surfaces + 2, surfaces + count);
+}
+
+void FrameQueue::clear() {
+	Common::StackLock lock(_mutex);
+
+	_decoding = 0;
+	_ready    = 0;
+	_shown    = 0;
+
+	_free.clear();
+}
+
+Graphics::Surface *FrameQueue::getDecoding() const {
+	return _decoding;
+}
+
+Graphics::Surface *FrameQueue::finishDecoding() {
+	Common::StackLock lock(_mutex);
+
+	// A frame that hasn't been shown yet is outdated now, so reuse its surface
+	Graphics::Surface *next = _ready;
+	if (!next) {
+		// Only the decoding, taken and shown surfaces are in use now
+		assert(!_free.empty());
+
+		next = _free.back();
+		_free.pop_back();
+	}
+
+	_ready    = _decoding;
+	_decoding = next;
+
+	return _decoding;
+}
+
+Graphics::Surface *FrameQueue::getShown() const {
+	return _shown;
+}
+
+Graphics::Surface *FrameQueue::getReady() {
+	Common::StackLock lock(_mutex);
+
+	return _ready;
+}
+
+Graphics::Surface *FrameQueue::takeReady() {
+	Common::StackLock lock(_mutex);
+
+	Graphics::Surface *frame = _ready;
+	_ready = 0;
+
+	return frame;
+}
+
+Graphics::Surface *FrameQueue::show(Graphics::Surface *frame) {
+	Graphics::Surface *previous = _shown;
+
+	_shown = frame;
+
+	return previous;
+}
+
+void FrameQueue::release(Graphics::Surface *surface) {
+	Common::StackLock lock(_mutex);
+
+	_free.push_back(surface);
+}
+
+void FrameQueue::dropReady() {
+	Common::StackLock lock(_mutex);
+
+	if (!_ready)
+		return;
+
+	_free.push_back(_ready);
+	_ready = 0;
+}
+
+} // End of namespace Video
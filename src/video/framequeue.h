@@ -0,0 +1,104 @@
+/* eos - A reimplementation of BioWare's Aurora engine
+ *
+ * eos is the legal property of its developers, whose names can be
+ * found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ * The Infinity, Aurora, Odyssey and Eclipse engines, Copyright (c) BioWare corp.
+ * The Electron engine, Copyright (c) Obsidian Entertainment and BioWare corp.
+ */
+
+/** @file video/framequeue.h
+ *  Handing decoded video frames over to the render thread.
+ */
+
+#ifndef VIDEO_FRAMEQUEUE_H
+#define VIDEO_FRAMEQUEUE_H
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/mutex.h"
+
+namespace Graphics {
+	class Surface;
+}
+
+namespace Video {
+
+/** Hands decoded video frames over from the decoding thread to the render thread.
+ *
+ *  At any time, each surface is either being decoded into, ready to be shown,
+ *  taken by the render thread for uploading, shown, or free. With at least
+ *  four surfaces, there's always a free one when the decoding thread needs it.
+ *
+ *  getDecoding() and finishDecoding() may only be called by the decoding
+ *  thread, all other methods only by the render thread.
+ */
+class FrameQueue {
+public:
+	/** The number of surfaces needed to never run out of free ones. */
+	static const uint32 kMinSurfaceCount = 4;
+
+	FrameQueue();
+	~FrameQueue();
+
+	/** Start cycling through these surfaces, decoding into the first and showing the second. */
+	void init(Graphics::Surface * const *surfaces, uint32 count);
+	/** Forget about all surfaces. */
+	void clear();
+
+	/** Return the surface the next frame is to be decoded into. */
+	Graphics::Surface *getDecoding() const;
+	/** Hand the newly decoded frame over and return the surface to decode the next frame into. */
+	Graphics::Surface *finishDecoding();
+
+	/** Return the surface of the frame currently shown. */
+	Graphics::Surface *getShown() const;
+	/** Return the surface of the newest decoded frame waiting to be shown, if any. */
+	Graphics::Surface *getReady();
+
+	/** Take the newest decoded frame, or return 0 if there is none. */
+	Graphics::Surface *takeReady();
+	/** Show the taken frame, and return the surface of the previously shown frame.
+	 *
+	 *  The previous surface has to be given back with release() once it's
+	 *  ready to be decoded into again.
+	 */
+	Graphics::Surface *show(Graphics::Surface *frame);
+	/** Give a surface back for decoding into. */
+	void release(Graphics::Surface *surface);
+
+	/** Drop the frame waiting to be shown, if any. */
+	void dropReady();
+
+private:
+	Graphics::Surface *_decoding; ///< The surface the decoding thread decodes into.
+	Graphics::Surface *_ready;    ///< The newest decoded frame, waiting to be shown.
+	Graphics::Surface *_shown;    ///< The frame currently shown.
+
+	/** Surfaces currently not in use. */
+	std::vector<Graphics::Surface *> _free;
+
+	/** Mutex protecting the hand-over of surfaces between the threads. */
+	Common::Mutex _mutex;
+};
+
+} // End of namespace Video
+
+#endif // VIDEO_FRAMEQUEUE_H